@@ -1,9 +1,15 @@
 #pragma once
 
+#include <webgpu/webgpu.h>
+
 struct CONFIG { 
     static constexpr char TITLE[] = "MUD 0.2.39";
     static constexpr int NATIVE_SCREEN_WIDTH = 640;
     static constexpr int NATIVE_SCREEN_HEIGHT = 360;
     static constexpr int WINDOW_SCREEN_WIDTH = 640;
 	static constexpr int WINDOW_SCREEN_HEIGHT = 360;
+
+    // Mailbox with a cap for low latency without tearing; Immediate and 0 (uncapped) to benchmark
+    static constexpr WGPUPresentMode PRESENT_MODE = WGPUPresentMode_Mailbox;
+    static constexpr double FRAME_RATE_LIMIT = 60.0;
 };
\ No newline at end of file
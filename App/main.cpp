@@ -1,3 +1,4 @@
+#include <cstdio>
 #include <iostream>
 #include <cassert>
 #include <vector>
@@ -7,9 +8,13 @@
 #include <core/Core.h>
 #include <wgpu/buffer/UniformBuffers.h>
 #include <utilities/Quad.h>
-#include <wgpu/buffer/VertexBuffer.h>
-#include <wgpu/buffer/IndexBuffer.h>
+#include <wgpu/buffer/MeshPool.h>
+#include <wgpu/buffer/StagingBelt.h>
+#include <wgpu/pipelines/PipelineCache.h>
 #include <wgpu/pipelines/Quad2DPipeline.h>
+#include <wgpu/shader/ShaderLibrary.h>
+#include <wgpu/shader/ShaderReflection.h>
+#include <wgpu/system/FrameContext.h>
 #include <wgpu/system/Surface.h>
 #include <wgpu/renderers/Quad2DRenderPass.h>
 #include <GLFW/glfw3.h>
@@ -40,19 +45,36 @@ int main(int, char**) {
 		return -1;
 	}
 
+	// edits to the .wgsl files under assets/shaders apply while running
+	WGPU::Shader::ShaderLibrary::EnableHotReload();
+
+	// presentation and pacing
+	Surface::SetPresentMode(CONFIG::PRESENT_MODE);
+	WGPU::System::FramePacer& pacer = Surface::Pacer();
+	pacer.SetTargetFrameRate(CONFIG::FRAME_RATE_LIMIT);
+	double lastReport = glfwGetTime();
+
+	// two frames in flight: the CPU records one while the GPU draws the other
+	WGPU::System::FrameContext frames(2);
+
+	// every load-time upload below goes out with one submit
+	WGPU::Buffer::StagingBelt stagingBelt;
+
 	// texture
-	auto texture = std::make_unique<Utilities::TextureImage>("../assets/test.png");
+	auto texture = std::make_unique<Utilities::TextureImage>("../assets/test.png", &stagingBelt);
 	if (!texture) {
 		std::cerr << "Failed to load texture." << std::endl;
 		return -1;
 	}
 
-	// uniform buffer
-	auto ub = std::make_unique<WGPU::Buffer::UniformBuffer>();
-	ub->Add("time", 1.0f);
-	ub->Add("position", glm::vec2(150.0, 150.0));
-	ub->Add("size", glm::vec2(200.0, 200.0));
-	ub->Add("Projection", glm::ortho(
+	// uniform buffer, laid out from the Uniforms struct of the shader the pipeline will use
+	const auto reflection = WGPU::Shader::ShaderReflection::Reflect(WGPU::Pipeline::Quad2DPipeline::LoadShader()->source);
+	auto ub = std::make_unique<WGPU::Buffer::UniformBuffer>(reflection->GetUniformStruct(0, 0));
+	auto timeUniform = ub->Find<float>("uTime");
+	ub->Update("uTime", 1.0f);
+	ub->Update("position", glm::vec2(150.0, 150.0));
+	ub->Update("size", glm::vec2(200.0, 200.0));
+	ub->Update("Projection", glm::ortho(
 		0.0f,                                              // left
 		static_cast<float>(CONFIG::NATIVE_SCREEN_WIDTH),   // right
 		static_cast<float>(CONFIG::NATIVE_SCREEN_HEIGHT),  // bottom (now height)
@@ -63,10 +85,12 @@ int main(int, char**) {
 
 	ub->Write();
 
-	// vertex buffer
+	// meshes, all sharing one vertex and one index buffer
+	auto meshPool = std::make_unique<WGPU::Buffer::MeshPool>(static_cast<uint32_t>(WGPU::Pipeline::Quad2DPipeline::VertexLayout::Stride));
 	Utilities::QuadStruct quad = Utilities::Quad().CreateCentered();
-	auto vb = std::make_unique<WGPU::Buffer::VertexBuffer>(quad.Vertices, quad.VertexCount, Core::Device(), Core::Queue());
-	auto ib = std::make_unique<WGPU::Buffer::IndexBuffer>(quad.Indices, quad.IndexCount, Core::Device(), Core::Queue());
+	auto quadMesh = meshPool->Add(quad.Vertices, quad.Indices, &stagingBelt);
+
+	stagingBelt.Submit();
 
 	// pipeline
 	auto pipeline = std::make_unique<WGPU::Pipeline::Quad2DPipeline>(
@@ -77,11 +101,19 @@ int main(int, char**) {
 	);
 
 	while (!glfwWindowShouldClose(Window::Get())) {
+		// wait for the frame's slot before sampling input, so the wait adds no latency
+		pacer.BeginFrame();
+		frames.BeginFrame();
 		glfwPollEvents();
+		pacer.MarkInput();
+
+		// frame boundary: swap in shaders that finished recompiling
+		WGPU::Pipeline::PipelineCache::Update();
 
 		float t = static_cast<float>(glfwGetTime());
-		ub->Update("time", t);
-		ub->Write();
+		ub->Update(timeUniform, t);
+		ub->Write(&frames.Uploads());
+		frames.Flush();
 
 		// surface
 		WGPUTextureView view = Surface::View();
@@ -96,11 +128,26 @@ int main(int, char**) {
 			Core::Device(),
 			Core::Queue(),
 			pipeline->GetPipeline(),
-			vb->GetBuffer(),
-			ib->GetBuffer(),
-			ib->GetIndexCount(),
-			pipeline->GetBindGroup()
+			meshPool->GetVertexBuffer(),
+			meshPool->GetIndexBuffer(),
+			meshPool->Get(quadMesh).indexCount,
+			pipeline->GetBindGroup(),
+			meshPool->Get(quadMesh).firstIndex,
+			meshPool->Get(quadMesh).baseVertex
 		);
+		frames.EndFrame();
+
+		// timings in the title once a second
+		if (glfwGetTime() - lastReport >= 1.0) {
+			const WGPU::System::FrameTimingStats& timing = pacer.GetStats();
+			const WGPU::Buffer::UploadStats& uploads = frames.GetLastUniformUploads();
+			char title[224];
+			std::snprintf(title, sizeof(title), "%s - %.0f fps, frame %.2f ms, present %.2f ms (jitter %.2f), input %.2f ms, uniforms %llu B in %u writes",
+				CONFIG::TITLE, timing.framesPerSecond, timing.frameTime, timing.presentInterval, timing.presentJitter, timing.inputToPresent,
+				static_cast<unsigned long long>(uploads.bytes), uploads.calls);
+			glfwSetWindowTitle(Window::Get(), title);
+			lastReport = glfwGetTime();
+		}
 	}
 
 	return 0;
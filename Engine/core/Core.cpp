@@ -27,6 +27,9 @@ bool Core::Activate()
 			throw std::runtime_error("Failed to create WGPU device");
 		}
 
+		limits_.nextInChain = nullptr;
+		wgpuDeviceGetLimits(device_, &limits_);
+
 		queue_ = WGPU::System::Queue::Register(device_);
 		if (!queue_) {
 			throw std::runtime_error("Failed to create WGPU queue");
@@ -28,6 +28,7 @@ public:
     static WGPUAdapter Adapter() noexcept { return retrieveInstance().adapter_; }
     static WGPUDevice Device() noexcept { return retrieveInstance().device_; }
     static WGPUQueue Queue() noexcept { return retrieveInstance().queue_; }
+    static const WGPULimits& Limits() noexcept { return retrieveInstance().limits_.limits; }
 
     /*============================================================
     * CLEANUP
@@ -50,6 +51,7 @@ private:
     WGPUAdapter adapter_ = nullptr;
 	WGPUDevice device_ = nullptr;
 	WGPUQueue queue_ = nullptr;
+	WGPUSupportedLimits limits_ = {};
 
 	bool hasInitialized() const noexcept { return initialized_; }
 };
\ No newline at end of file
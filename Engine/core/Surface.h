@@ -49,9 +49,17 @@ public:
         return instance.surfaceHandler_->GetSurface();
     }
     static WGPUTextureFormat Format() noexcept { return retrieveInstance().surfaceHandler_->GetSurfaceTextureFormat(); }
-    static WGPUTextureView View() { return retrieveInstance().surfaceHandler_->CreateTextureAndGetSurfaceTextureView(); }
+    // Native-resolution scene target; EncodePresent() scales it onto the window
+    static WGPUTextureView View() { return retrieveInstance().surfaceHandler_->GetSceneView(); }
+    static bool EncodePresent(WGPUCommandEncoder encoder) { return retrieveInstance().surfaceHandler_->EncodePresent(encoder); }
+    static void SetPresentMode(WGPUPresentMode mode) { retrieveInstance().surfaceHandler_->SetPresentMode(mode); }
+    static WGPUPresentMode PresentMode() { return retrieveInstance().surfaceHandler_->GetPresentMode(); }
+    static WGPU::System::FramePacer& Pacer() { return retrieveInstance().surfaceHandler_->GetPacer(); }
+    static const WGPU::System::PresentViewport& Viewport() { return retrieveInstance().surfaceHandler_->GetViewport(); }
 	static int Width() { return retrieveInstance().surfaceHandler_->GetWidth(); }
 	static int Height() { return retrieveInstance().surfaceHandler_->GetHeight(); }
+	static int SurfaceWidth() { return retrieveInstance().surfaceHandler_->GetSurfaceWidth(); }
+	static int SurfaceHeight() { return retrieveInstance().surfaceHandler_->GetSurfaceHeight(); }
 
 	// Rule of 5
     Surface(const Surface&) = delete;
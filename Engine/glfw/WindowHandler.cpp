@@ -9,7 +9,7 @@ GLFW::WindowHandler::WindowHandler(std::string title, int screenWidth, int scree
 	}
 
 	glfwWindowHint(GLFW_CLIENT_API, GLFW_NO_API); // <-- extra info for glfwCreateWindow
-	glfwWindowHint(GLFW_RESIZABLE, GLFW_FALSE);
+	glfwWindowHint(GLFW_RESIZABLE, GLFW_TRUE);
 	window_ = glfwCreateWindow(screenWidth, screenHeight, title.c_str(), nullptr, nullptr);
 	if (!window_) {
 		std::cerr << "Could not open window!" << std::endl;
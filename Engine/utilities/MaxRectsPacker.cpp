@@ -0,0 +1,163 @@
+#include "MaxRectsPacker.h"
+
+#include <algorithm>
+#include <limits>
+
+namespace {
+	bool contains(const Utilities::PackedRect& outer, const Utilities::PackedRect& inner)
+	{
+		return inner.x >= outer.x && inner.y >= outer.y
+			&& inner.x + inner.width <= outer.x + outer.width
+			&& inner.y + inner.height <= outer.y + outer.height;
+	}
+
+	bool intersects(const Utilities::PackedRect& a, const Utilities::PackedRect& b)
+	{
+		return a.x < b.x + b.width && b.x < a.x + a.width
+			&& a.y < b.y + b.height && b.y < a.y + a.height;
+	}
+}
+
+Utilities::MaxRectsPacker::MaxRectsPacker(uint32_t width, uint32_t height) :
+	width_(width),
+	height_(height)
+{
+	Reset();
+}
+
+std::optional<Utilities::PackedRect> Utilities::MaxRectsPacker::Insert(uint32_t width, uint32_t height)
+{
+	if (width == 0 || height == 0) {
+		return std::nullopt;
+	}
+	if (rebuildPending_) {
+		rebuildFreeRects();
+	}
+
+	// Best short side fit, ties broken by the long side
+	const PackedRect* best = nullptr;
+	uint32_t bestShortSide = std::numeric_limits<uint32_t>::max();
+	uint32_t bestLongSide = std::numeric_limits<uint32_t>::max();
+	for (const PackedRect& free : freeRects_) {
+		if (free.width < width || free.height < height) {
+			continue;
+		}
+		const uint32_t leftoverX = free.width - width;
+		const uint32_t leftoverY = free.height - height;
+		const uint32_t shortSide = std::min(leftoverX, leftoverY);
+		const uint32_t longSide = std::max(leftoverX, leftoverY);
+		if (shortSide < bestShortSide || (shortSide == bestShortSide && longSide < bestLongSide)) {
+			best = &free;
+			bestShortSide = shortSide;
+			bestLongSide = longSide;
+		}
+	}
+	if (!best) {
+		return std::nullopt;
+	}
+
+	const PackedRect placed{ best->x, best->y, width, height };
+	splitFreeRects(placed);
+	usedRects_.push_back(placed);
+	usedArea_ += static_cast<uint64_t>(width) * height;
+	return placed;
+}
+
+bool Utilities::MaxRectsPacker::Free(const PackedRect& rect)
+{
+	auto placement = std::find_if(usedRects_.begin(), usedRects_.end(), [&](const PackedRect& used) {
+		return used.x == rect.x && used.y == rect.y && used.width == rect.width && used.height == rect.height;
+	});
+	if (placement == usedRects_.end()) {
+		return false;
+	}
+
+	*placement = usedRects_.back();
+	usedRects_.pop_back();
+	usedArea_ -= static_cast<uint64_t>(rect.width) * rect.height;
+	rebuildPending_ = true;
+	return true;
+}
+
+void Utilities::MaxRectsPacker::Reset()
+{
+	freeRects_.clear();
+	freeRects_.push_back(PackedRect{ 0, 0, width_, height_ });
+	usedRects_.clear();
+	usedArea_ = 0;
+	rebuildPending_ = false;
+}
+
+/**
+ * Replaces every free rectangle overlapping used by the up to four maximal pieces of it
+ * that lie outside used.
+ */
+void Utilities::MaxRectsPacker::splitFreeRects(const PackedRect& used)
+{
+	pieces_.clear();
+	for (size_t i = 0; i < freeRects_.size();) {
+		const PackedRect free = freeRects_[i];
+		if (!intersects(free, used)) {
+			++i;
+			continue;
+		}
+
+		// Left and right of used, full height of the free rectangle
+		if (used.x > free.x) {
+			pieces_.push_back(PackedRect{ free.x, free.y, used.x - free.x, free.height });
+		}
+		if (used.x + used.width < free.x + free.width) {
+			pieces_.push_back(PackedRect{ used.x + used.width, free.y, free.x + free.width - (used.x + used.width), free.height });
+		}
+
+		// Above and below used, full width of the free rectangle
+		if (used.y > free.y) {
+			pieces_.push_back(PackedRect{ free.x, free.y, free.width, used.y - free.y });
+		}
+		if (used.y + used.height < free.y + free.height) {
+			pieces_.push_back(PackedRect{ free.x, used.y + used.height, free.width, free.y + free.height - (used.y + used.height) });
+		}
+
+		freeRects_[i] = freeRects_.back();
+		freeRects_.pop_back();
+	}
+	addPieces();
+}
+
+/**
+ * Adds the pieces of the last split that are not contained in another free rectangle.
+ * The untouched free rectangles were already maximal, and none of them can lie inside a
+ * piece (it would have lain inside the rectangle the piece came from), so only the
+ * pieces need checking.
+ */
+void Utilities::MaxRectsPacker::addPieces()
+{
+	const size_t untouched = freeRects_.size();
+	for (size_t i = 0; i < pieces_.size(); ++i) {
+		const PackedRect& piece = pieces_[i];
+		bool redundant = false;
+		for (size_t j = 0; j < untouched && !redundant; ++j) {
+			redundant = contains(freeRects_[j], piece);
+		}
+		for (size_t j = 0; j < pieces_.size() && !redundant; ++j) {
+			// Of two equal pieces only the first is kept
+			redundant = j != i && contains(pieces_[j], piece) && (j < i || !contains(piece, pieces_[j]));
+		}
+		if (!redundant) {
+			freeRects_.push_back(piece);
+		}
+	}
+}
+
+/**
+ * Recomputes the maximal free rectangles from the current placements.
+ */
+void Utilities::MaxRectsPacker::rebuildFreeRects()
+{
+	freeRects_.clear();
+	freeRects_.push_back(PackedRect{ 0, 0, width_, height_ });
+	for (const PackedRect& used : usedRects_) {
+		splitFreeRects(used);
+	}
+	rebuildPending_ = false;
+}
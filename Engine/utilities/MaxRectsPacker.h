@@ -0,0 +1,79 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+namespace Utilities {
+
+	struct PackedRect {
+		uint32_t x = 0;
+		uint32_t y = 0;
+		uint32_t width = 0;
+		uint32_t height = 0;
+	};
+
+	/**
+	 * @class MaxRectsPacker
+	 * @brief MaxRects bin packer over an abstract width x height area.
+	 *
+	 * Holds no texture itself; it only hands out positions. The free space is kept as the
+	 * list of maximal free rectangles (they may overlap). Insert() picks the free rectangle
+	 * with the best short side fit, then splits every free rectangle the placement cuts
+	 * and prunes the ones contained in others.
+	 *
+	 * Free() drops the placement and rebuilds the maximal free rectangles from the
+	 * remaining placements on the next Insert(), so several evictions in a row cost one
+	 * rebuild. Placements never move, though: after heavy eviction the free space can be
+	 * too scattered for a large rectangle until everything is packed again from scratch
+	 * (see TextureAtlas::Repack).
+	 */
+	class MaxRectsPacker {
+	public:
+		MaxRectsPacker(uint32_t width, uint32_t height);
+
+		/*============================================================
+		* PUBLIC
+		=============================================================*/
+
+		/**
+		 * @brief Reserves a width x height rectangle.
+		 *
+		 * @return Its position, or nothing when no free rectangle fits.
+		 */
+		std::optional<PackedRect> Insert(uint32_t width, uint32_t height);
+
+		/**
+		 * @brief Returns a rectangle handed out by Insert() to the free space.
+		 *
+		 * @return false if the rectangle is not a current placement.
+		 */
+		bool Free(const PackedRect& rect);
+
+		/**
+		 * @brief Forgets every placement and makes the whole bin one free rectangle.
+		 */
+		void Reset();
+
+		uint32_t GetWidth() const { return width_; }
+		uint32_t GetHeight() const { return height_; }
+		uint64_t GetUsedArea() const { return usedArea_; }
+		uint64_t GetFreeArea() const { return static_cast<uint64_t>(width_) * height_ - usedArea_; }
+		float GetOccupancy() const { return static_cast<float>(usedArea_) / (static_cast<float>(width_) * static_cast<float>(height_)); }
+		size_t GetFreeRectCount() const { return freeRects_.size(); }
+		size_t GetPlacementCount() const { return usedRects_.size(); }
+	private:
+		uint32_t width_;
+		uint32_t height_;
+		uint64_t usedArea_ = 0;
+		std::vector<PackedRect> freeRects_;
+		std::vector<PackedRect> usedRects_;
+		std::vector<PackedRect> pieces_;
+		bool rebuildPending_ = false;
+
+		void splitFreeRects(const PackedRect& used);
+		void addPieces();
+		void rebuildFreeRects();
+	};
+}
@@ -0,0 +1,229 @@
+#include "stbi_image.h"
+
+#include "TextureArray.h"
+
+#include <wgpu/pipelines/BindGroupCache.h>
+
+#include <cfloat>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+namespace {
+	// WebGPU's default maxTextureArrayLayers
+	constexpr uint32_t MaxLayers = 256;
+
+	struct LoadedImage {
+		unsigned char* pixels = nullptr;
+		uint32_t width = 0;
+		uint32_t height = 0;
+
+		explicit LoadedImage(const char* path)
+		{
+			int w, h, channels;
+			pixels = stbi_load(path, &w, &h, &channels, STBI_rgb_alpha);
+			if (nullptr == pixels) {
+				throw std::runtime_error(std::string("TextureArray: failed to load texture from path: ") + path);
+			}
+			width = static_cast<uint32_t>(w);
+			height = static_cast<uint32_t>(h);
+		}
+		~LoadedImage() { stbi_image_free(pixels); }
+
+		LoadedImage(const LoadedImage&) = delete;
+		LoadedImage& operator=(const LoadedImage&) = delete;
+	};
+}
+
+Utilities::TextureArray::TextureArray(std::span<const char* const> paths, WGPU::Buffer::StagingBelt* stagingBelt)
+{
+	if (paths.empty()) {
+		throw std::invalid_argument("TextureArray: no layers given.");
+	}
+
+	// Every layer is checked before anything is created, so a bad one leaks nothing
+	int width = 0, height = 0;
+	for (size_t i = 0; i < paths.size(); ++i) {
+		int w, h, channels;
+		if (!stbi_info(paths[i], &w, &h, &channels)) {
+			throw std::runtime_error(std::string("TextureArray: failed to load texture from path: ") + paths[i]);
+		}
+		if (i == 0) {
+			width = w;
+			height = h;
+		}
+		else if (w != width || h != height) {
+			throw std::runtime_error(std::string("TextureArray: layer size differs from the first layer: ") + paths[i]);
+		}
+	}
+
+	try {
+		create(static_cast<uint32_t>(width), static_cast<uint32_t>(height), static_cast<uint32_t>(paths.size()));
+		for (size_t i = 0; i < paths.size(); ++i) {
+			LoadedImage image(paths[i]);
+			if (image.width != width_ || image.height != height_) {
+				throw std::runtime_error(std::string("TextureArray: layer changed size while loading: ") + paths[i]);
+			}
+			upload(static_cast<uint32_t>(i), 1, image.pixels, stagingBelt);
+		}
+	}
+	catch (...) {
+		// The destructor does not run for a constructor that throws
+		release();
+		throw;
+	}
+}
+
+Utilities::TextureArray::TextureArray(const char* sheetPath, uint32_t frameWidth, uint32_t frameHeight, WGPU::Buffer::StagingBelt* stagingBelt)
+{
+	LoadedImage sheet(sheetPath);
+	const uint32_t columns = frameWidth > 0 ? sheet.width / frameWidth : 0;
+	const uint32_t rows = frameHeight > 0 ? sheet.height / frameHeight : 0;
+	if (columns == 0 || rows == 0) {
+		throw std::runtime_error(std::string("TextureArray: sheet holds no whole frame: ") + sheetPath);
+	}
+	try {
+		create(frameWidth, frameHeight, columns * rows);
+
+		// Gather the frames layer after layer so all of them go up in one copy
+		const size_t frameRowBytes = static_cast<size_t>(frameWidth) * 4;
+		const size_t sheetRowBytes = static_cast<size_t>(sheet.width) * 4;
+		std::vector<uint8_t> layers(frameRowBytes * frameHeight * layerCount_);
+		uint8_t* destination = layers.data();
+		for (uint32_t frameRow = 0; frameRow < rows; ++frameRow) {
+			for (uint32_t column = 0; column < columns; ++column) {
+				const uint8_t* source = sheet.pixels + static_cast<size_t>(frameRow) * frameHeight * sheetRowBytes + column * frameRowBytes;
+				for (uint32_t y = 0; y < frameHeight; ++y) {
+					std::memcpy(destination, source + y * sheetRowBytes, frameRowBytes);
+					destination += frameRowBytes;
+				}
+			}
+		}
+		upload(0, layerCount_, layers.data(), stagingBelt);
+	}
+	catch (...) {
+		release();
+		throw;
+	}
+}
+
+Utilities::TextureArray::~TextureArray()
+{
+	std::cout << "Utilities::TextureArray::~TextureArray() - Releasing " << layerCount_ << " layers." << std::endl;
+	release();
+}
+
+void Utilities::TextureArray::SetLayer(uint32_t layer, const uint8_t* pixels, WGPU::Buffer::StagingBelt* stagingBelt)
+{
+	if (layer >= layerCount_) {
+		throw std::out_of_range("TextureArray: layer out of range.");
+	}
+	upload(layer, 1, pixels, stagingBelt);
+}
+
+/**
+ * Creates the array texture, its 2D array view and a nearest sampler.
+ */
+void Utilities::TextureArray::create(uint32_t width, uint32_t height, uint32_t layerCount)
+{
+	if (layerCount > MaxLayers) {
+		throw std::runtime_error("TextureArray: more layers than maxTextureArrayLayers allows.");
+	}
+	width_ = width;
+	height_ = height;
+	layerCount_ = layerCount;
+
+	WGPUTextureDescriptor textureDesc = {};
+	textureDesc.nextInChain = nullptr;
+	textureDesc.label = "Texture array";
+	textureDesc.dimension = WGPUTextureDimension_2D;
+	textureDesc.format = WGPUTextureFormat_RGBA8Unorm;
+	textureDesc.mipLevelCount = 1;
+	textureDesc.sampleCount = 1;
+	textureDesc.size = { width_, height_, layerCount_ };
+	textureDesc.usage = WGPUTextureUsage_TextureBinding | WGPUTextureUsage_CopyDst;
+	textureDesc.viewFormatCount = 0;
+	textureDesc.viewFormats = nullptr;
+
+	texture_ = wgpuDeviceCreateTexture(Core::Device(), &textureDesc);
+	if (!texture_) {
+		throw std::runtime_error("Failed to create array texture.");
+	}
+
+	// Explicitly an array view: with a single layer the default would be a plain 2D view
+	WGPUTextureViewDescriptor viewDesc = {};
+	viewDesc.nextInChain = nullptr;
+	viewDesc.aspect = WGPUTextureAspect_All;
+	viewDesc.baseArrayLayer = 0;
+	viewDesc.arrayLayerCount = layerCount_;
+	viewDesc.baseMipLevel = 0;
+	viewDesc.mipLevelCount = 1;
+	viewDesc.dimension = WGPUTextureViewDimension_2DArray;
+	viewDesc.format = textureDesc.format;
+
+	view_ = wgpuTextureCreateView(texture_, &viewDesc);
+	if (!view_) {
+		throw std::runtime_error("Failed to create array texture view.");
+	}
+
+	WGPUSamplerDescriptor samplerDesc = {};
+	samplerDesc.nextInChain = nullptr;
+	samplerDesc.addressModeU = WGPUAddressMode_ClampToEdge;
+	samplerDesc.addressModeV = WGPUAddressMode_ClampToEdge;
+	samplerDesc.addressModeW = WGPUAddressMode_ClampToEdge;
+	samplerDesc.magFilter = WGPUFilterMode_Nearest;
+	samplerDesc.minFilter = WGPUFilterMode_Nearest;
+	samplerDesc.mipmapFilter = WGPUMipmapFilterMode_Nearest;
+	samplerDesc.lodMinClamp = 0.0f;
+	samplerDesc.lodMaxClamp = FLT_MAX;
+	samplerDesc.maxAnisotropy = 1;
+
+	sampler_ = wgpuDeviceCreateSampler(Core::Device(), &samplerDesc);
+	if (!sampler_) {
+		throw std::runtime_error("Failed to create sampler.");
+	}
+}
+
+void Utilities::TextureArray::release()
+{
+	if (view_) {
+		WGPU::Pipeline::BindGroupCache::Invalidate(view_);
+		wgpuTextureViewRelease(view_);
+		view_ = nullptr;
+	}
+	if (texture_) {
+		wgpuTextureRelease(texture_);
+		texture_ = nullptr;
+	}
+	if (sampler_) {
+		WGPU::Pipeline::BindGroupCache::Invalidate(sampler_);
+		wgpuSamplerRelease(sampler_);
+		sampler_ = nullptr;
+	}
+}
+
+/**
+ * Writes layerCount consecutive, tightly packed frames starting at firstLayer.
+ */
+void Utilities::TextureArray::upload(uint32_t firstLayer, uint32_t layerCount, const uint8_t* pixels, WGPU::Buffer::StagingBelt* stagingBelt)
+{
+	WGPUImageCopyTexture destination = {};
+	destination.texture = texture_;
+	destination.mipLevel = 0;
+	destination.origin = { 0, 0, firstLayer };
+	destination.aspect = WGPUTextureAspect_All;
+
+	const WGPUExtent3D copySize = { width_, height_, layerCount };
+	const uint32_t bytesPerRow = 4 * width_;
+	if (stagingBelt) {
+		stagingBelt->WriteTexture(destination, pixels, bytesPerRow, copySize);
+	}
+	else {
+		WGPUTextureDataLayout source = {};
+		source.offset = 0;
+		source.bytesPerRow = bytesPerRow;
+		source.rowsPerImage = height_;
+
+		wgpuQueueWriteTexture(Core::Queue(), &destination, pixels, static_cast<size_t>(bytesPerRow) * height_ * layerCount, &source, &copySize);
+	}
+}
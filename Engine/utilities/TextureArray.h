@@ -0,0 +1,77 @@
+#pragma once
+
+#include <webgpu/webgpu.h>
+#include <core/Core.h>
+#include <wgpu/buffer/StagingBelt.h>
+#include <cstdint>
+#include <iostream>
+#include <span>
+#include <vector>
+
+namespace Utilities {
+	/**
+	 * @class TextureArray
+	 * @brief RGBA8 2D array texture of same-sized frames, one frame per layer.
+	 *
+	 * Meant for SpriteBatchPipeline::SheetLayout::Texture2DArray: every character and
+	 * monster frame of one size lives in a single texture, so one bind group covers them
+	 * all and a frame change is just a different SpriteInstance::layer. The frames come
+	 * either from one image file each or from a grid-shaped sprite sheet.
+	 *
+	 * @code
+	 * Utilities::TextureArray roster("../assets/battlers.png", 32, 32, &stagingBelt);
+	 * WGPU::Renderer::SpriteBatch battlers(roster.GetView(), roster.GetSampler(), projection, 256,
+	 *     WGPU::Buffer::VertexEncoding::Float32, WGPU::Pipeline::SpriteBatchPipeline::InstanceFetch::VertexAttributes,
+	 *     WGPU::Pipeline::SpriteBatchPipeline::SheetLayout::Texture2DArray);
+	 * battlers.Draw(position, glm::vec2(32.0f), 0.0f, glm::vec4(0.0f, 0.0f, 1.0f, 1.0f), glm::vec4(1.0f), frame);
+	 * @endcode
+	 */
+	class TextureArray {
+	public:
+		/**
+		 * @brief One layer per image file, in order.
+		 *
+		 * @throws std::runtime_error If a file cannot be loaded or the sizes differ.
+		 */
+		explicit TextureArray(std::span<const char* const> paths, WGPU::Buffer::StagingBelt* stagingBelt = nullptr);
+
+		/**
+		 * @brief Cuts a sprite sheet into frameWidth x frameHeight layers, row by row.
+		 * Partial frames at the right and bottom edges are dropped.
+		 *
+		 * @throws std::runtime_error If the file cannot be loaded or holds no whole frame.
+		 */
+		TextureArray(const char* sheetPath, uint32_t frameWidth, uint32_t frameHeight, WGPU::Buffer::StagingBelt* stagingBelt = nullptr);
+		~TextureArray();
+
+		TextureArray(const TextureArray&) = delete;
+		TextureArray& operator=(const TextureArray&) = delete;
+
+		/*============================================================
+		* PUBLIC
+		=============================================================*/
+
+		/**
+		 * @brief Replaces one layer with tightly packed RGBA8 pixels of the frame size.
+		 */
+		void SetLayer(uint32_t layer, const uint8_t* pixels, WGPU::Buffer::StagingBelt* stagingBelt = nullptr);
+
+		WGPUTexture GetTexture() const { return texture_; }
+		WGPUTextureView GetView() const { return view_; }
+		WGPUSampler GetSampler() const { return sampler_; }
+		uint32_t GetWidth() const { return width_; }
+		uint32_t GetHeight() const { return height_; }
+		uint32_t GetLayerCount() const { return layerCount_; }
+	private:
+		WGPUTexture texture_ = nullptr;
+		WGPUTextureView view_ = nullptr;
+		WGPUSampler sampler_ = nullptr;
+		uint32_t width_ = 0;
+		uint32_t height_ = 0;
+		uint32_t layerCount_ = 0;
+
+		void create(uint32_t width, uint32_t height, uint32_t layerCount);
+		void release();
+		void upload(uint32_t firstLayer, uint32_t layerCount, const uint8_t* pixels, WGPU::Buffer::StagingBelt* stagingBelt);
+	};
+}
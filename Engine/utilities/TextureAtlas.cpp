@@ -0,0 +1,346 @@
+#include "stbi_image.h"
+
+#include "TextureAtlas.h"
+
+#include <wgpu/pipelines/BindGroupCache.h>
+
+#include <algorithm>
+#include <cfloat>
+#include <cstring>
+#include <stdexcept>
+
+Utilities::TextureAtlas::TextureAtlas(uint32_t pageSize, uint32_t padding, uint32_t extrude) :
+	pageSize_(pageSize),
+	padding_(padding),
+	extrude_(extrude)
+{
+	if (pageSize_ == 0 || 2 * extrude_ + padding_ >= pageSize_) {
+		throw std::invalid_argument("TextureAtlas: page too small for its padding and extrusion.");
+	}
+	createSampler();
+}
+
+Utilities::TextureAtlas::~TextureAtlas()
+{
+	std::cout << "Utilities::TextureAtlas::~TextureAtlas() - Releasing " << pages_.size() << " atlas pages." << std::endl;
+	for (const std::unique_ptr<Page>& page : pages_) {
+		if (page->view) {
+			WGPU::Pipeline::BindGroupCache::Invalidate(page->view);
+			wgpuTextureViewRelease(page->view);
+		}
+		if (page->texture) {
+			wgpuTextureDestroy(page->texture);
+			wgpuTextureRelease(page->texture);
+		}
+	}
+	if (sampler_) {
+		WGPU::Pipeline::BindGroupCache::Invalidate(sampler_);
+		wgpuSamplerRelease(sampler_);
+		sampler_ = nullptr;
+	}
+}
+
+Utilities::AtlasHandle Utilities::TextureAtlas::Add(const char* path, WGPU::Buffer::StagingBelt* stagingBelt)
+{
+	int width, height, channels;
+	unsigned char* pixelData = stbi_load(path, &width, &height, &channels, STBI_rgb_alpha);
+	if (nullptr == pixelData) {
+		std::cerr << "Failed to load texture from path: " << path << std::endl;
+		return InvalidHandle;
+	}
+
+	AtlasHandle handle = InvalidHandle;
+	try {
+		handle = Add(pixelData, static_cast<uint32_t>(width), static_cast<uint32_t>(height), stagingBelt);
+	}
+	catch (...) {
+		stbi_image_free(pixelData);
+		throw;
+	}
+	stbi_image_free(pixelData);
+	return handle;
+}
+
+Utilities::AtlasHandle Utilities::TextureAtlas::Add(const uint8_t* pixels, uint32_t width, uint32_t height, WGPU::Buffer::StagingBelt* stagingBelt)
+{
+	const uint32_t border = 2 * extrude_ + padding_;
+	if (width == 0 || height == 0 || width > pageSize_ - border || height > pageSize_ - border) {
+		throw std::invalid_argument("TextureAtlas: image does not fit on an atlas page.");
+	}
+	const uint32_t reservedWidth = width + border;
+	const uint32_t reservedHeight = height + border;
+
+	// First page with room; a fragmented page that has the area is repacked and tried again
+	std::optional<PackedRect> reserved;
+	uint32_t page = 0;
+	for (; page < pages_.size(); ++page) {
+		MaxRectsPacker& packer = pages_[page]->packer;
+		reserved = packer.Insert(reservedWidth, reservedHeight);
+		if (!reserved && pages_[page]->fragmented && packer.GetFreeArea() >= static_cast<uint64_t>(reservedWidth) * reservedHeight) {
+			if (Repack(page, stagingBelt)) {
+				reserved = pages_[page]->packer.Insert(reservedWidth, reservedHeight);
+			}
+		}
+		if (reserved) {
+			break;
+		}
+	}
+	if (!reserved) {
+		page = createPage();
+		reserved = pages_[page]->packer.Insert(reservedWidth, reservedHeight);
+	}
+
+	upload(*pages_[page], *reserved, pixels, width, height, stagingBelt);
+
+	const AtlasHandle handle = nextHandle_++;
+	entries_.emplace(handle, Entry{ page, *reserved, regionOf(page, *reserved, width, height) });
+	return handle;
+}
+
+bool Utilities::TextureAtlas::Remove(AtlasHandle handle)
+{
+	auto entry = entries_.find(handle);
+	if (entry == entries_.end()) {
+		return false;
+	}
+
+	Page& page = *pages_[entry->second.page];
+	page.packer.Free(entry->second.reserved);
+	page.fragmented = true;
+	entries_.erase(entry);
+	return true;
+}
+
+/**
+ * Places the page's images again, largest first, into a scratch texture and copies the
+ * scratch back over the page, so the page's texture and view stay the same.
+ *
+ * @param page Index of the page.
+ * @param stagingBelt Optional belt the copies are recorded on.
+ * @return false if the new layout does not fit; the page is left as it was.
+ */
+bool Utilities::TextureAtlas::Repack(uint32_t page, WGPU::Buffer::StagingBelt* stagingBelt)
+{
+	Page& target = *pages_.at(page);
+
+	std::vector<Entry*> images;
+	for (auto& [handle, entry] : entries_) {
+		if (entry.page == page) {
+			images.push_back(&entry);
+		}
+	}
+	std::sort(images.begin(), images.end(), [](const Entry* a, const Entry* b) {
+		const uint32_t sideA = std::max(a->reserved.width, a->reserved.height);
+		const uint32_t sideB = std::max(b->reserved.width, b->reserved.height);
+		return sideA != sideB ? sideA > sideB : a->reserved.width * a->reserved.height > b->reserved.width * b->reserved.height;
+	});
+
+	MaxRectsPacker packer(pageSize_, pageSize_);
+	std::vector<PackedRect> placements;
+	placements.reserve(images.size());
+	for (const Entry* image : images) {
+		std::optional<PackedRect> placed = packer.Insert(image->reserved.width, image->reserved.height);
+		if (!placed) {
+			return false;
+		}
+		placements.push_back(*placed);
+	}
+
+	WGPUTexture scratch = createPageTexture("Atlas repack scratch");
+
+	WGPUCommandEncoder encoder = nullptr;
+	if (!stagingBelt) {
+		WGPUCommandEncoderDescriptor encoderDesc = {};
+		encoderDesc.nextInChain = nullptr;
+		encoderDesc.label = "Atlas repack encoder";
+		encoder = wgpuDeviceCreateCommandEncoder(Core::Device(), &encoderDesc);
+	}
+	auto copy = [&](WGPUTexture from, const PackedRect& source, WGPUTexture to, uint32_t x, uint32_t y) {
+		WGPUImageCopyTexture sourceCopy = {};
+		sourceCopy.nextInChain = nullptr;
+		sourceCopy.texture = from;
+		sourceCopy.mipLevel = 0;
+		sourceCopy.origin = { source.x, source.y, 0 };
+		sourceCopy.aspect = WGPUTextureAspect_All;
+
+		WGPUImageCopyTexture destinationCopy = sourceCopy;
+		destinationCopy.texture = to;
+		destinationCopy.origin = { x, y, 0 };
+
+		const WGPUExtent3D copySize = { source.width, source.height, 1 };
+		if (stagingBelt) {
+			stagingBelt->CopyTexture(sourceCopy, destinationCopy, copySize);
+		}
+		else {
+			wgpuCommandEncoderCopyTextureToTexture(encoder, &sourceCopy, &destinationCopy, &copySize);
+		}
+	};
+
+	// Only the extruded image moves; the padding stays empty in the fresh scratch texture
+	const uint32_t border = 2 * extrude_;
+	for (size_t i = 0; i < images.size(); ++i) {
+		const PackedRect& old = images[i]->reserved;
+		copy(target.texture, PackedRect{ old.x, old.y, old.width - padding_, old.height - padding_ }, scratch, placements[i].x, placements[i].y);
+	}
+	copy(scratch, PackedRect{ 0, 0, pageSize_, pageSize_ }, target.texture, 0, 0);
+
+	if (encoder) {
+		WGPUCommandBufferDescriptor cmdBufferDescriptor = {};
+		cmdBufferDescriptor.nextInChain = nullptr;
+		cmdBufferDescriptor.label = "Atlas repack command buffer";
+		WGPUCommandBuffer command = wgpuCommandEncoderFinish(encoder, &cmdBufferDescriptor);
+		wgpuCommandEncoderRelease(encoder);
+		wgpuQueueSubmit(Core::Queue(), 1, &command);
+		wgpuCommandBufferRelease(command);
+	}
+	// The recorded copies keep the scratch texture alive until they have run
+	wgpuTextureRelease(scratch);
+
+	for (size_t i = 0; i < images.size(); ++i) {
+		Entry& image = *images[i];
+		image.reserved = placements[i];
+		image.region = regionOf(page, placements[i], image.reserved.width - border - padding_, image.reserved.height - border - padding_);
+	}
+	target.packer = std::move(packer);
+	target.fragmented = false;
+	++revision_;
+	return true;
+}
+
+const Utilities::AtlasRegion& Utilities::TextureAtlas::Get(AtlasHandle handle) const
+{
+	auto entry = entries_.find(handle);
+	if (entry == entries_.end()) {
+		throw std::out_of_range("TextureAtlas: unknown handle.");
+	}
+	return entry->second.region;
+}
+
+uint32_t Utilities::TextureAtlas::createPage()
+{
+	auto page = std::make_unique<Page>(pageSize_);
+	page->texture = createPageTexture("Atlas page");
+
+	WGPUTextureViewDescriptor viewDesc = {};
+	viewDesc.nextInChain = nullptr;
+	viewDesc.label = "Atlas page view";
+	viewDesc.aspect = WGPUTextureAspect_All;
+	viewDesc.baseArrayLayer = 0;
+	viewDesc.arrayLayerCount = 1;
+	viewDesc.baseMipLevel = 0;
+	viewDesc.mipLevelCount = 1;
+	viewDesc.dimension = WGPUTextureViewDimension_2D;
+	viewDesc.format = WGPUTextureFormat_RGBA8Unorm;
+	page->view = wgpuTextureCreateView(page->texture, &viewDesc);
+	if (!page->view) {
+		throw std::runtime_error("Failed to create atlas page view.");
+	}
+
+	pages_.push_back(std::move(page));
+	return static_cast<uint32_t>(pages_.size() - 1);
+}
+
+WGPUTexture Utilities::TextureAtlas::createPageTexture(const char* label) const
+{
+	WGPUTextureDescriptor textureDesc = {};
+	textureDesc.nextInChain = nullptr;
+	textureDesc.label = label;
+	textureDesc.dimension = WGPUTextureDimension_2D;
+	textureDesc.format = WGPUTextureFormat_RGBA8Unorm;
+	textureDesc.mipLevelCount = 1;
+	textureDesc.sampleCount = 1;
+	textureDesc.size = { pageSize_, pageSize_, 1 };
+	textureDesc.usage = WGPUTextureUsage_TextureBinding | WGPUTextureUsage_CopyDst | WGPUTextureUsage_CopySrc;
+	textureDesc.viewFormatCount = 0;
+	textureDesc.viewFormats = nullptr;
+
+	WGPUTexture texture = wgpuDeviceCreateTexture(Core::Device(), &textureDesc);
+	if (!texture) {
+		throw std::runtime_error("Failed to create atlas page texture.");
+	}
+	return texture;
+}
+
+void Utilities::TextureAtlas::createSampler()
+{
+	WGPUSamplerDescriptor samplerDesc = {};
+	samplerDesc.nextInChain = nullptr;
+	samplerDesc.addressModeU = WGPUAddressMode_ClampToEdge;
+	samplerDesc.addressModeV = WGPUAddressMode_ClampToEdge;
+	samplerDesc.addressModeW = WGPUAddressMode_ClampToEdge;
+	samplerDesc.magFilter = WGPUFilterMode_Nearest;
+	samplerDesc.minFilter = WGPUFilterMode_Nearest;
+	samplerDesc.mipmapFilter = WGPUMipmapFilterMode_Nearest;
+	samplerDesc.lodMinClamp = 0.0f;
+	samplerDesc.lodMaxClamp = FLT_MAX;
+	samplerDesc.maxAnisotropy = 1;
+
+	sampler_ = wgpuDeviceCreateSampler(Core::Device(), &samplerDesc);
+	if (!sampler_) {
+		throw std::runtime_error("Failed to create atlas sampler.");
+	}
+}
+
+/**
+ * Writes the image with its edges repeated extrude_ pixels outwards at the reserved rect.
+ */
+void Utilities::TextureAtlas::upload(const Page& page, const PackedRect& reserved, const uint8_t* pixels, uint32_t width, uint32_t height, WGPU::Buffer::StagingBelt* stagingBelt)
+{
+	const uint32_t extrudedWidth = width + 2 * extrude_;
+	const uint32_t extrudedHeight = height + 2 * extrude_;
+	const size_t rowBytes = static_cast<size_t>(extrudedWidth) * 4;
+	extruded_.resize(rowBytes * extrudedHeight);
+
+	for (uint32_t row = 0; row < extrudedHeight; ++row) {
+		const uint32_t sourceRow = std::min(row > extrude_ ? row - extrude_ : 0, height - 1);
+		const uint8_t* source = pixels + static_cast<size_t>(sourceRow) * width * 4;
+		uint8_t* destination = extruded_.data() + row * rowBytes;
+
+		// Left edge, the row itself, right edge
+		for (uint32_t column = 0; column < extrude_; ++column) {
+			std::memcpy(destination + column * 4, source, 4);
+		}
+		std::memcpy(destination + extrude_ * 4, source, static_cast<size_t>(width) * 4);
+		for (uint32_t column = extrude_ + width; column < extrudedWidth; ++column) {
+			std::memcpy(destination + column * 4, source + (width - 1) * 4, 4);
+		}
+	}
+
+	WGPUImageCopyTexture destination = {};
+	destination.texture = page.texture;
+	destination.mipLevel = 0;
+	destination.origin = { reserved.x, reserved.y, 0 };
+	destination.aspect = WGPUTextureAspect_All;
+
+	const WGPUExtent3D copySize = { extrudedWidth, extrudedHeight, 1 };
+	if (stagingBelt) {
+		stagingBelt->WriteTexture(destination, extruded_.data(), static_cast<uint32_t>(rowBytes), copySize);
+	}
+	else {
+		WGPUTextureDataLayout source = {};
+		source.offset = 0;
+		source.bytesPerRow = static_cast<uint32_t>(rowBytes);
+		source.rowsPerImage = extrudedHeight;
+
+		wgpuQueueWriteTexture(Core::Queue(), &destination, extruded_.data(), extruded_.size(), &source, &copySize);
+	}
+}
+
+Utilities::AtlasRegion Utilities::TextureAtlas::regionOf(uint32_t page, const PackedRect& reserved, uint32_t width, uint32_t height) const
+{
+	AtlasRegion region;
+	region.page = page;
+	region.x = reserved.x + extrude_;
+	region.y = reserved.y + extrude_;
+	region.width = width;
+	region.height = height;
+
+	const float size = static_cast<float>(pageSize_);
+	region.uvRect = glm::vec4(
+		static_cast<float>(region.x) / size,
+		static_cast<float>(region.y) / size,
+		static_cast<float>(region.x + width) / size,
+		static_cast<float>(region.y + height) / size
+	);
+	return region;
+}
@@ -0,0 +1,155 @@
+#pragma once
+
+#include <webgpu/webgpu.h>
+#include <glm/glm.hpp>
+#include <core/Core.h>
+#include <wgpu/buffer/StagingBelt.h>
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+#include "MaxRectsPacker.h"
+
+namespace Utilities {
+	using AtlasHandle = uint32_t;
+
+	/**
+	 * Where an image ended up: its page and its rect on that page, in pixels and as the
+	 * (minU, minV, maxU, maxV) rect SpriteInstance::uvRect expects.
+	 */
+	struct AtlasRegion {
+		uint32_t page = 0;
+		glm::vec4 uvRect = glm::vec4(0.0f);
+		uint32_t x = 0;
+		uint32_t y = 0;
+		uint32_t width = 0;
+		uint32_t height = 0;
+	};
+
+	/**
+	 * @class TextureAtlas
+	 * @brief Packs many small RGBA8 images into a few large texture pages.
+	 *
+	 * Every page is one texture and one view, so everything on a page batches under one
+	 * bind group (e.g. one SpriteBatch per page) instead of one per image. Images are
+	 * placed with a MaxRectsPacker per page; a new page is opened only when none of the
+	 * existing ones has room.
+	 *
+	 * Each image is surrounded by `extrude` pixels copied from its own edge, so linear
+	 * filtering and rounding at the rect's border read the image rather than a neighbour,
+	 * plus `padding` empty pixels to the right and below.
+	 *
+	 * Remove() frees an image's space for later ones. When a page is too fragmented for a
+	 * new image, Repack() packs its images again from scratch and moves them on the GPU
+	 * with copyTextureToTexture: the page keeps its texture and view, so bind groups stay
+	 * valid, but the regions change. Re-read them with Get() when GetRevision() moves.
+	 *
+	 * @code
+	 * Utilities::TextureAtlas atlas;
+	 * Utilities::AtlasHandle hero = atlas.Add("../assets/hero.png", &stagingBelt);
+	 * stagingBelt.Submit();
+	 * const Utilities::AtlasRegion& region = atlas.Get(hero);
+	 * batch[region.page]->Draw(position, size, 0.0f, region.uvRect);
+	 * @endcode
+	 */
+	class TextureAtlas {
+	public:
+		static constexpr AtlasHandle InvalidHandle = 0;
+
+		/**
+		 * @param pageSize Width and height of every page, in pixels.
+		 * @param padding Empty pixels kept after every image, to the right and below.
+		 * @param extrude Pixels each image's edge is repeated by on every side.
+		 */
+		explicit TextureAtlas(uint32_t pageSize = 2048, uint32_t padding = 1, uint32_t extrude = 1);
+		~TextureAtlas();
+
+		TextureAtlas(const TextureAtlas&) = delete;
+		TextureAtlas& operator=(const TextureAtlas&) = delete;
+
+		/*============================================================
+		* PUBLIC
+		=============================================================*/
+
+		/**
+		 * @brief Loads an image file and adds it to the atlas.
+		 *
+		 * @return The image's handle, or InvalidHandle if the file could not be loaded.
+		 */
+		AtlasHandle Add(const char* path, WGPU::Buffer::StagingBelt* stagingBelt = nullptr);
+
+		/**
+		 * @brief Adds tightly packed RGBA8 pixels to the atlas.
+		 *
+		 * @throws std::invalid_argument If the image does not fit on an empty page.
+		 */
+		AtlasHandle Add(const uint8_t* pixels, uint32_t width, uint32_t height, WGPU::Buffer::StagingBelt* stagingBelt = nullptr);
+
+		/**
+		 * @brief Frees an image's space. Its pixels stay until something is placed over them.
+		 */
+		bool Remove(AtlasHandle handle);
+
+		/**
+		 * @brief Packs the images of a page again from scratch and moves them on the GPU.
+		 *
+		 * @param stagingBelt Optional belt to record the copies on, after its pending
+		 *        uploads; otherwise they are submitted right away.
+		 * @return false if the images no longer fit in a fresh layout (nothing changes).
+		 */
+		bool Repack(uint32_t page, WGPU::Buffer::StagingBelt* stagingBelt = nullptr);
+
+		/**
+		 * @throws std::out_of_range If the handle is not in the atlas.
+		 */
+		const AtlasRegion& Get(AtlasHandle handle) const;
+		bool Contains(AtlasHandle handle) const { return entries_.find(handle) != entries_.end(); }
+
+		size_t GetPageCount() const { return pages_.size(); }
+		WGPUTexture GetTexture(uint32_t page) const { return pages_.at(page)->texture; }
+		WGPUTextureView GetView(uint32_t page) const { return pages_.at(page)->view; }
+		WGPUSampler GetSampler() const { return sampler_; }
+		float GetOccupancy(uint32_t page) const { return pages_.at(page)->packer.GetOccupancy(); }
+		size_t GetImageCount() const { return entries_.size(); }
+		uint32_t GetPageSize() const { return pageSize_; }
+
+		/**
+		 * @brief Bumped by every Repack() that moved images.
+		 */
+		uint32_t GetRevision() const { return revision_; }
+	private:
+		struct Page {
+			WGPUTexture texture = nullptr;
+			WGPUTextureView view = nullptr;
+			MaxRectsPacker packer;
+			bool fragmented = false; // Something was removed since the last (re)pack
+
+			explicit Page(uint32_t size) : packer(size, size) {}
+		};
+
+		struct Entry {
+			uint32_t page = 0;
+			PackedRect reserved; // Extruded image plus padding
+			AtlasRegion region;
+		};
+
+		uint32_t pageSize_;
+		uint32_t padding_;
+		uint32_t extrude_;
+		uint32_t revision_ = 0;
+		AtlasHandle nextHandle_ = 1;
+
+		std::vector<std::unique_ptr<Page>> pages_;
+		std::unordered_map<AtlasHandle, Entry> entries_;
+		WGPUSampler sampler_ = nullptr;
+		std::vector<uint8_t> extruded_;
+
+		uint32_t createPage();
+		WGPUTexture createPageTexture(const char* label) const;
+		void createSampler();
+		void upload(const Page& page, const PackedRect& reserved, const uint8_t* pixels, uint32_t width, uint32_t height, WGPU::Buffer::StagingBelt* stagingBelt);
+		AtlasRegion regionOf(uint32_t page, const PackedRect& reserved, uint32_t width, uint32_t height) const;
+	};
+}
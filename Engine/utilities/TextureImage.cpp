@@ -3,10 +3,15 @@
 
 #include "TextureImage.h"
 
-Utilities::TextureImage::TextureImage(const char* path)
+#include <wgpu/pipelines/BindGroupCache.h>
+
+#include <cfloat>
+#include <cstring>
+
+Utilities::TextureImage::TextureImage(const char* path, WGPU::Buffer::StagingBelt* stagingBelt)
 {
 	// Load the texture
-	texture_ = loadTexture(path);
+	texture_ = loadTexture(path, stagingBelt);
     setView();
 	setSampler();
 }
@@ -18,16 +23,18 @@ Utilities::TextureImage::~TextureImage()
         wgpuTextureRelease(texture_);
     }
     if (view_) {
+        WGPU::Pipeline::BindGroupCache::Invalidate(view_);
         wgpuTextureViewRelease(view_);
         view_ = nullptr;
     }
     if (sampler_) {
+        WGPU::Pipeline::BindGroupCache::Invalidate(sampler_);
         wgpuSamplerRelease(sampler_);
         sampler_ = nullptr;
     }
 }
 
-WGPUTexture Utilities::TextureImage::loadTexture(const char* path)
+WGPUTexture Utilities::TextureImage::loadTexture(const char* path, WGPU::Buffer::StagingBelt* stagingBelt)
 {
     int width, height, channels;
     unsigned char* pixelData = stbi_load(path, &width, &height, &channels, STBI_rgb_alpha);
@@ -57,18 +64,19 @@ WGPUTexture Utilities::TextureImage::loadTexture(const char* path)
     destination.origin = { 0, 0, 0 };
     destination.aspect = WGPUTextureAspect_All;
 
-    WGPUTextureDataLayout source = {};
-    source.offset = 0;
-    source.bytesPerRow = 4 * textureDesc_.size.width;
-    source.rowsPerImage = height;
-
-    std::vector<unsigned char> alignedData(source.bytesPerRow * height, 0);
-    for (int row = 0; row < height; ++row) {
-        std::memcpy(&alignedData[row * source.bytesPerRow], &pixelData[row * width * 4], width * 4);
+    if (stagingBelt) {
+        // The belt re-lays the rows out for copyBufferToTexture while staging them
+        stagingBelt->WriteTexture(destination, pixelData, 4 * textureDesc_.size.width, textureDesc_.size);
     }
+    else {
+        // writeTexture has no row alignment requirement, so the pixels go up as loaded
+        WGPUTextureDataLayout source = {};
+        source.offset = 0;
+        source.bytesPerRow = 4 * textureDesc_.size.width;
+        source.rowsPerImage = height;
 
-    WGPUQueue queue = wgpuDeviceGetQueue(Core::Device());
-    wgpuQueueWriteTexture(queue, &destination, alignedData.data(), alignedData.size(), &source, &textureDesc_.size);
+        wgpuQueueWriteTexture(Core::Queue(), &destination, pixelData, static_cast<size_t>(source.bytesPerRow) * height, &source, &textureDesc_.size);
+    }
 
     stbi_image_free(pixelData);
 
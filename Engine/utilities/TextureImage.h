@@ -2,13 +2,14 @@
 
 #include <webgpu/webgpu.h>
 #include <core/Core.h>
+#include <wgpu/buffer/StagingBelt.h>
 #include <iostream>
 #include <vector>
 
 namespace Utilities {
 	class TextureImage {
 	public:
-		TextureImage(const char* path);
+		TextureImage(const char* path, WGPU::Buffer::StagingBelt* stagingBelt = nullptr);
 		~TextureImage();
 
 		TextureImage(TextureImage&& other) noexcept;
@@ -27,7 +28,7 @@ namespace Utilities {
 		WGPUTextureViewDescriptor textureViewDesc_{};
 		WGPUSamplerDescriptor samplerDesc_{};
 
-		WGPUTexture loadTexture(const char* path);
+		WGPUTexture loadTexture(const char* path, WGPU::Buffer::StagingBelt* stagingBelt);
 		bool setView();
 		bool setSampler();
 	};
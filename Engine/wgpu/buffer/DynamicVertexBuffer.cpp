@@ -0,0 +1,131 @@
+#include "DynamicVertexBuffer.h"
+#include "UniformLayout.h"
+
+#include <algorithm>
+#include <cstring>
+
+WGPU::Buffer::DynamicVertexBuffer::DynamicVertexBuffer(uint64_t initialCapacity, uint32_t framesInFlight, WGPUBufferUsageFlags usage) :
+	slots_(framesInFlight > 0 ? framesInFlight : 1),
+	capacity_(AlignUp(initialCapacity > 0 ? initialCapacity : 4, 4)),
+	usage_(usage | WGPUBufferUsage_CopyDst)
+{
+	if (!Core::Device()) {
+		throw std::runtime_error("WebGPU device not initialized.");
+	}
+	for (Slot& slot : slots_) {
+		createSlotBuffer(slot);
+	}
+}
+
+WGPU::Buffer::DynamicVertexBuffer::~DynamicVertexBuffer()
+{
+	std::cout << "WGPU::Buffer::DynamicVertexBuffer::~DynamicVertexBuffer - Releasing " << slots_.size() << " vertex buffers..." << std::endl;
+	for (Slot& slot : slots_) {
+		if (slot.buffer) {
+			wgpuBufferRelease(slot.buffer);
+			slot.buffer = nullptr;
+		}
+	}
+}
+
+void WGPU::Buffer::DynamicVertexBuffer::BeginFrame()
+{
+	current_ = (current_ + 1) % static_cast<uint32_t>(slots_.size());
+}
+
+void WGPU::Buffer::DynamicVertexBuffer::Update(uint64_t offset, std::span<const std::byte> data)
+{
+	if (data.empty()) {
+		return;
+	}
+	if (offset + data.size() > hostData_.size()) {
+		Resize(offset + data.size());
+	}
+	std::memcpy(hostData_.data() + offset, data.data(), data.size());
+	markDirty(offset, offset + data.size());
+}
+
+void WGPU::Buffer::DynamicVertexBuffer::Resize(uint64_t size)
+{
+	const uint64_t previous = hostData_.size();
+	hostData_.resize(size, std::byte{ 0 });
+
+	// Doubling keeps the number of reallocations logarithmic in the final size
+	const uint64_t required = AlignUp(size, 4);
+	while (capacity_ < required) {
+		capacity_ *= 2;
+	}
+
+	if (size > previous) {
+		markDirty(previous, size);
+	}
+}
+
+void WGPU::Buffer::DynamicVertexBuffer::Flush(StagingBelt* stagingBelt)
+{
+	Slot& slot = slots_[current_];
+	if (slot.capacity < capacity_) {
+		// Outgrown: the replacement starts empty and needs the whole mirror
+		if (slot.buffer) {
+			wgpuBufferRelease(slot.buffer);
+		}
+		createSlotBuffer(slot);
+		slot.dirtyBegin = 0;
+		slot.dirtyEnd = hostData_.size();
+	}
+
+	if (slot.dirtyBegin >= slot.dirtyEnd) {
+		return; // Already up to date
+	}
+
+	// Writes have to start and end on 4-byte boundaries; the padding lies inside the capacity
+	const uint64_t begin = slot.dirtyBegin / 4 * 4;
+	const uint64_t end = std::min(AlignUp(slot.dirtyEnd, 4), static_cast<uint64_t>(hostData_.size()));
+	const uint64_t size = end - begin;
+	if (size % 4 == 0) {
+		if (stagingBelt) {
+			stagingBelt->WriteBuffer(slot.buffer, begin, hostData_.data() + begin, size);
+		}
+		else {
+			wgpuQueueWriteBuffer(Core::Queue(), slot.buffer, begin, hostData_.data() + begin, size);
+		}
+	}
+	else {
+		// Mirror ends mid-word; send a zero-padded copy of the tail
+		std::vector<std::byte> padded(AlignUp(size, 4), std::byte{ 0 });
+		std::memcpy(padded.data(), hostData_.data() + begin, size);
+		if (stagingBelt) {
+			stagingBelt->WriteBuffer(slot.buffer, begin, padded.data(), padded.size());
+		}
+		else {
+			wgpuQueueWriteBuffer(Core::Queue(), slot.buffer, begin, padded.data(), padded.size());
+		}
+	}
+
+	slot.dirtyBegin = UINT64_MAX;
+	slot.dirtyEnd = 0;
+}
+
+void WGPU::Buffer::DynamicVertexBuffer::markDirty(uint64_t begin, uint64_t end)
+{
+	// Every buffer in the rotation has to catch up on the change
+	for (Slot& slot : slots_) {
+		slot.dirtyBegin = std::min(slot.dirtyBegin, begin);
+		slot.dirtyEnd = std::max(slot.dirtyEnd, end);
+	}
+}
+
+void WGPU::Buffer::DynamicVertexBuffer::createSlotBuffer(Slot& slot)
+{
+	WGPUBufferDescriptor bufferDesc = {};
+	bufferDesc.nextInChain = nullptr;
+	bufferDesc.label = "Dynamic vertex buffer";
+	bufferDesc.size = capacity_;
+	bufferDesc.usage = usage_;
+	bufferDesc.mappedAtCreation = false;
+	slot.buffer = wgpuDeviceCreateBuffer(Core::Device(), &bufferDesc);
+	if (!slot.buffer) {
+		throw std::runtime_error("Failed to create dynamic vertex buffer.");
+	}
+	slot.capacity = capacity_;
+}
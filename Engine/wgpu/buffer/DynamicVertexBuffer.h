@@ -0,0 +1,112 @@
+#pragma once
+
+#include <webgpu/webgpu.h>
+#include <core/Core.h>
+#include <cstddef>
+#include <ranges>
+#include <span>
+#include <vector>
+#include <stdexcept>
+#include <iostream>
+#include <type_traits>
+
+#include "StagingBelt.h"
+
+namespace WGPU::Buffer {
+
+	/**
+	 * @class DynamicVertexBuffer
+	 * @brief A vertex buffer meant to be rewritten every frame, in whole or in sub-ranges.
+	 *
+	 * The contents live in a host mirror; Update() only touches the mirror and records the
+	 * changed range. The GPU side is framesInFlight separate buffers used round-robin:
+	 * BeginFrame() moves to the next one and Flush() brings it up to date by uploading every
+	 * range changed since that buffer was last used. The CPU therefore never rewrites the
+	 * buffer the previous frames are still reading from. Capacity grows geometrically, and
+	 * each buffer is recreated at the new size the next time its frame comes around.
+	 *
+	 * @code
+	 * trail.BeginFrame();
+	 * trail.Update(head * stride, std::span(newVertices)); // only the moved segment
+	 * trail.Flush();
+	 * wgpuRenderPassEncoderSetVertexBuffer(pass, 0, trail.GetBuffer(), 0, trail.GetSize());
+	 * @endcode
+	 */
+	class DynamicVertexBuffer {
+	public:
+		/**
+		 * @param initialCapacity Initial size of each GPU buffer in bytes.
+		 * @param framesInFlight Number of GPU buffers rotated through; 2 or 3.
+		 * @param usage Buffer usage; CopyDst is always added.
+		 */
+		explicit DynamicVertexBuffer(
+			uint64_t initialCapacity = 64 << 10,
+			uint32_t framesInFlight = 3,
+			WGPUBufferUsageFlags usage = WGPUBufferUsage_Vertex
+		);
+		~DynamicVertexBuffer();
+
+		DynamicVertexBuffer(const DynamicVertexBuffer&) = delete;
+		DynamicVertexBuffer& operator=(const DynamicVertexBuffer&) = delete;
+
+		/*============================================================
+		* PUBLIC
+		=============================================================*/
+
+		/**
+		 * @brief Moves on to the next GPU buffer. Call once per frame before Flush().
+		 */
+		void BeginFrame();
+
+		/**
+		 * @brief Overwrites bytes starting at offset, growing the buffer if the range ends
+		 * past its current size.
+		 */
+		void Update(uint64_t offset, std::span<const std::byte> data);
+
+		template <std::ranges::contiguous_range R>
+		void Update(uint64_t offset, const R& data) {
+			using T = std::ranges::range_value_t<R>;
+			static_assert(std::is_trivially_copyable_v<T>, "Vertex data must be trivially copyable.");
+			Update(offset, std::as_bytes(std::span<const T>(std::ranges::data(data), std::ranges::size(data))));
+		}
+
+		/**
+		 * @brief Sets the logical size in bytes. Growing keeps the contents and zero-fills the
+		 * new tail; shrinking keeps the capacity.
+		 */
+		void Resize(uint64_t size);
+
+		/**
+		 * @brief Uploads everything the current GPU buffer is missing with one write.
+		 *
+		 * @param stagingBelt When set, the upload is staged on the belt instead of written
+		 * through the queue.
+		 */
+		void Flush(StagingBelt* stagingBelt = nullptr);
+
+		WGPUBuffer GetBuffer() const { return slots_[current_].buffer; }
+		uint64_t GetSize() const { return hostData_.size(); }
+		uint64_t GetCapacity() const { return capacity_; }
+		uint32_t GetFramesInFlight() const { return static_cast<uint32_t>(slots_.size()); }
+		uint32_t GetFrameIndex() const { return current_; }
+	private:
+		struct Slot {
+			WGPUBuffer buffer = nullptr;
+			uint64_t capacity = 0;
+
+			// Merged range [dirtyBegin, dirtyEnd) the buffer has not received yet
+			uint64_t dirtyBegin = UINT64_MAX;
+			uint64_t dirtyEnd = 0;
+		};
+
+		std::vector<std::byte> hostData_;
+		std::vector<Slot> slots_;
+		uint32_t current_ = 0;
+		uint64_t capacity_ = 0;
+		WGPUBufferUsageFlags usage_ = 0;
+
+		void markDirty(uint64_t begin, uint64_t end);
+		void createSlotBuffer(Slot& slot);
+	};
+}
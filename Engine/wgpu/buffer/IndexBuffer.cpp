@@ -1,20 +1,39 @@
 #include "IndexBuffer.h"
+#include "UniformLayout.h"
 
 WGPU::Buffer::IndexBuffer::IndexBuffer(
-    std::vector<uint16_t> indices,
+    std::span<const uint16_t> indices,
     unsigned int indexCount,
     WGPUDevice device,
-    WGPUQueue queue
+    WGPUQueue queue,
+    StagingBelt* stagingBelt
 ) :
     indexCount_(indexCount)
 {
     WGPUBufferDescriptor bufferDesc{};
     bufferDesc.nextInChain = nullptr;
-    bufferDesc.size = indices.size() * sizeof(uint16_t);
+    bufferDesc.size = AlignUp(indices.size() * sizeof(uint16_t), 4); // Copies must be a multiple of 4 bytes
     bufferDesc.usage = WGPUBufferUsage_CopyDst | WGPUBufferUsage_Index;
     indexBuffer_ = wgpuDeviceCreateBuffer(device, &bufferDesc);
 
-    wgpuQueueWriteBuffer(queue, indexBuffer_, 0, indices.data(), bufferDesc.size);
+    auto write = [&](uint64_t offset, const void* data, size_t size) {
+        if (stagingBelt) {
+            stagingBelt->WriteBuffer(indexBuffer_, offset, data, size);
+        }
+        else {
+            wgpuQueueWriteBuffer(queue, indexBuffer_, offset, data, size);
+        }
+    };
+
+    // Whole words straight from the caller's memory; an odd trailing index goes up padded
+    const size_t evenCount = indices.size() & ~size_t{ 1 };
+    if (evenCount > 0) {
+        write(0, indices.data(), evenCount * sizeof(uint16_t));
+    }
+    if (evenCount < indices.size()) {
+        const uint16_t tail[2] = { indices.back(), 0 };
+        write(evenCount * sizeof(uint16_t), tail, sizeof(tail));
+    }
 }
 
 WGPU::Buffer::IndexBuffer::~IndexBuffer()
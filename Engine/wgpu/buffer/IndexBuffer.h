@@ -1,17 +1,21 @@
 #pragma once
 
 #include <webgpu/webgpu.h>
+#include <span>
 #include <vector>
 #include <iostream>
 
+#include "StagingBelt.h"
+
 namespace WGPU::Buffer {
 	class IndexBuffer {
 	public:
 		IndexBuffer(
-			std::vector<uint16_t> indices,
+			std::span<const uint16_t> indices,
 			unsigned int indexCount,
 			WGPUDevice device,
-			WGPUQueue queue
+			WGPUQueue queue,
+			StagingBelt* stagingBelt = nullptr
 		);
 		~IndexBuffer();
 
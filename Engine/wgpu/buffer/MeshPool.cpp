@@ -0,0 +1,258 @@
+#include "MeshPool.h"
+#include "UniformLayout.h"
+
+#include <algorithm>
+
+WGPU::Buffer::MeshPool::MeshPool(uint32_t vertexStride, uint64_t vertexCapacity, uint64_t indexCapacity) :
+	vertexStride_(vertexStride)
+{
+	if (vertexStride_ == 0 || vertexStride_ % 4 != 0) {
+		throw std::invalid_argument("Mesh pool vertex stride must be a non-zero multiple of 4.");
+	}
+
+	vertices_.label = "Mesh pool vertices";
+	vertices_.usage = WGPUBufferUsage_Vertex | WGPUBufferUsage_CopyDst | WGPUBufferUsage_CopySrc;
+	vertices_.allocator.Reset(AlignUp(vertexCapacity, vertexStride_));
+	vertices_.buffer = createBuffer(vertices_, vertices_.allocator.GetCapacity());
+
+	indices_.label = "Mesh pool indices";
+	indices_.usage = WGPUBufferUsage_Index | WGPUBufferUsage_CopyDst | WGPUBufferUsage_CopySrc;
+	indices_.allocator.Reset(AlignUp(indexCapacity, 4));
+	indices_.buffer = createBuffer(indices_, indices_.allocator.GetCapacity());
+}
+
+WGPU::Buffer::MeshPool::~MeshPool()
+{
+	std::cout << "WGPU::Buffer::MeshPool::~MeshPool - Releasing mesh pool buffers..." << std::endl;
+	for (Region* region : { &vertices_, &indices_ }) {
+		if (region->buffer) {
+			wgpuBufferRelease(region->buffer);
+			region->buffer = nullptr;
+		}
+	}
+}
+
+WGPU::Buffer::MeshHandle WGPU::Buffer::MeshPool::Add(std::span<const std::byte> vertices, uint32_t stride, std::span<const uint16_t> indices, StagingBelt* stagingBelt)
+{
+	if (stride != vertexStride_) {
+		throw std::invalid_argument("Mesh vertex stride does not match the pool's vertex stride.");
+	}
+
+	const uint64_t vertexBytes = vertices.size_bytes();
+	if (vertexBytes == 0 || vertexBytes % vertexStride_ != 0 || indices.empty()) {
+		throw std::invalid_argument("Mesh must hold whole vertices and at least one index.");
+	}
+
+	MeshRange range;
+	range.vertexBytes = vertexBytes;
+	range.vertexCount = static_cast<uint32_t>(vertexBytes / vertexStride_);
+	range.indexBytes = AlignUp(indices.size_bytes(), 4); // Buffer copies move whole words
+	range.indexCount = static_cast<uint32_t>(indices.size());
+	range.vertexOffset = allocate(vertices_, range.vertexBytes, vertexStride_, stagingBelt);
+	range.indexOffset = allocate(indices_, range.indexBytes, 4, stagingBelt);
+	updateDrawOffsets(range);
+
+	// The index range is allocated in whole words, so the padded tail is ours to write
+	std::vector<uint16_t> padded(range.indexBytes / sizeof(uint16_t), 0);
+	std::copy(indices.begin(), indices.end(), padded.begin());
+	if (stagingBelt) {
+		stagingBelt->WriteBuffer(vertices_.buffer, range.vertexOffset, vertices.data(), vertexBytes);
+		stagingBelt->WriteBuffer(indices_.buffer, range.indexOffset, padded.data(), range.indexBytes);
+	}
+	else {
+		wgpuQueueWriteBuffer(Core::Queue(), vertices_.buffer, range.vertexOffset, vertices.data(), vertexBytes);
+		wgpuQueueWriteBuffer(Core::Queue(), indices_.buffer, range.indexOffset, padded.data(), range.indexBytes);
+	}
+
+	MeshHandle mesh;
+	if (!freeIds_.empty()) {
+		mesh.id = freeIds_.back();
+		freeIds_.pop_back();
+		meshes_[mesh.id] = range;
+		live_[mesh.id] = true;
+	}
+	else {
+		mesh.id = static_cast<uint32_t>(meshes_.size());
+		meshes_.push_back(range);
+		live_.push_back(true);
+	}
+	return mesh;
+}
+
+void WGPU::Buffer::MeshPool::Remove(MeshHandle mesh)
+{
+	const MeshRange& range = Get(mesh);
+	vertices_.allocator.Free(range.vertexOffset);
+	indices_.allocator.Free(range.indexOffset);
+	live_[mesh.id] = false;
+	freeIds_.push_back(mesh.id);
+}
+
+const WGPU::Buffer::MeshRange& WGPU::Buffer::MeshPool::Get(MeshHandle mesh) const
+{
+	if (!mesh.IsValid() || mesh.id >= meshes_.size() || !live_[mesh.id]) {
+		throw std::invalid_argument("Mesh handle does not refer to a live mesh in this pool.");
+	}
+	return meshes_[mesh.id];
+}
+
+void WGPU::Buffer::MeshPool::Bind(WGPURenderPassEncoder renderPass) const
+{
+	wgpuRenderPassEncoderSetVertexBuffer(renderPass, 0, vertices_.buffer, 0, vertices_.allocator.GetCapacity());
+	wgpuRenderPassEncoderSetIndexBuffer(renderPass, indices_.buffer, WGPUIndexFormat_Uint16, 0, indices_.allocator.GetCapacity());
+}
+
+void WGPU::Buffer::MeshPool::Draw(WGPURenderPassEncoder renderPass, MeshHandle mesh, uint32_t instanceCount) const
+{
+	const MeshRange& range = Get(mesh);
+	wgpuRenderPassEncoderDrawIndexed(renderPass, range.indexCount, instanceCount, range.firstIndex, range.baseVertex, 0);
+}
+
+void WGPU::Buffer::MeshPool::Defragment(StagingBelt* stagingBelt)
+{
+	WGPUCommandEncoder encoder = nullptr;
+	if (!stagingBelt) {
+		WGPUCommandEncoderDescriptor encoderDesc = {};
+		encoderDesc.nextInChain = nullptr;
+		encoderDesc.label = "Mesh pool defragment encoder";
+		encoder = wgpuDeviceCreateCommandEncoder(Core::Device(), &encoderDesc);
+	}
+
+	// Repack in current offset order so meshes keep their relative placement
+	std::vector<uint32_t> order;
+	for (uint32_t id = 0; id < meshes_.size(); ++id) {
+		if (live_[id]) {
+			order.push_back(id);
+		}
+	}
+
+	for (Region* region : { &vertices_, &indices_ }) {
+		const bool isVertex = region == &vertices_;
+		std::sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b) {
+			return isVertex ? meshes_[a].vertexOffset < meshes_[b].vertexOffset : meshes_[a].indexOffset < meshes_[b].indexOffset;
+		});
+
+		WGPUBuffer packed = createBuffer(*region, region->allocator.GetCapacity());
+		region->allocator.Reset(region->allocator.GetCapacity());
+
+		for (uint32_t id : order) {
+			MeshRange& range = meshes_[id];
+			uint64_t& offset = isVertex ? range.vertexOffset : range.indexOffset;
+			const uint64_t size = isVertex ? range.vertexBytes : range.indexBytes;
+			const uint64_t packedOffset = region->allocator.Allocate(size, isVertex ? vertexStride_ : 4);
+
+			if (stagingBelt) {
+				stagingBelt->CopyBuffer(region->buffer, offset, packed, packedOffset, size);
+			}
+			else {
+				wgpuCommandEncoderCopyBufferToBuffer(encoder, region->buffer, offset, packed, packedOffset, size);
+			}
+			offset = packedOffset;
+		}
+
+		// The recorded copies keep the old buffer alive until they have executed
+		wgpuBufferRelease(region->buffer);
+		region->buffer = packed;
+	}
+
+	for (uint32_t id : order) {
+		updateDrawOffsets(meshes_[id]);
+	}
+
+	if (encoder) {
+		submitCopies(encoder);
+	}
+	++defragmentCount_;
+}
+
+WGPU::Buffer::MeshPoolStats WGPU::Buffer::MeshPool::GetStats() const
+{
+	MeshPoolStats stats;
+	stats.meshCount = meshes_.size() - freeIds_.size();
+
+	stats.vertexCapacity = vertices_.allocator.GetCapacity();
+	stats.vertexUsed = vertices_.allocator.GetUsedBytes();
+	stats.vertexLargestFreeBlock = vertices_.allocator.GetLargestFreeBlock();
+	stats.vertexFreeBlocks = vertices_.allocator.GetFreeBlockCount();
+
+	stats.indexCapacity = indices_.allocator.GetCapacity();
+	stats.indexUsed = indices_.allocator.GetUsedBytes();
+	stats.indexLargestFreeBlock = indices_.allocator.GetLargestFreeBlock();
+	stats.indexFreeBlocks = indices_.allocator.GetFreeBlockCount();
+
+	stats.growCount = growCount_;
+	stats.defragmentCount = defragmentCount_;
+	return stats;
+}
+
+uint64_t WGPU::Buffer::MeshPool::allocate(Region& region, uint64_t size, uint64_t alignment, StagingBelt* stagingBelt)
+{
+	uint64_t offset = region.allocator.Allocate(size, alignment);
+	if (offset == RangeAllocator::InvalidOffset) {
+		grow(region, region.allocator.GetCapacity() + size + alignment, stagingBelt);
+		offset = region.allocator.Allocate(size, alignment);
+	}
+	return offset;
+}
+
+/**
+ * Replaces the region's buffer with one at least twice as large and copies the old
+ * contents across on the GPU. Offsets do not change, so no mesh has to be touched.
+ */
+void WGPU::Buffer::MeshPool::grow(Region& region, uint64_t minimumCapacity, StagingBelt* stagingBelt)
+{
+	const uint64_t oldCapacity = region.allocator.GetCapacity();
+	const uint64_t alignment = &region == &vertices_ ? vertexStride_ : 4;
+	const uint64_t capacity = AlignUp(std::max(oldCapacity * 2, minimumCapacity), alignment);
+
+	WGPUBuffer grown = createBuffer(region, capacity);
+	if (stagingBelt) {
+		stagingBelt->CopyBuffer(region.buffer, 0, grown, 0, oldCapacity);
+	}
+	else {
+		WGPUCommandEncoderDescriptor encoderDesc = {};
+		encoderDesc.nextInChain = nullptr;
+		encoderDesc.label = "Mesh pool grow encoder";
+		WGPUCommandEncoder encoder = wgpuDeviceCreateCommandEncoder(Core::Device(), &encoderDesc);
+		wgpuCommandEncoderCopyBufferToBuffer(encoder, region.buffer, 0, grown, 0, oldCapacity);
+		submitCopies(encoder);
+	}
+
+	wgpuBufferRelease(region.buffer);
+	region.buffer = grown;
+	region.allocator.Grow(capacity);
+	++growCount_;
+}
+
+void WGPU::Buffer::MeshPool::updateDrawOffsets(MeshRange& range) const
+{
+	range.baseVertex = static_cast<int32_t>(range.vertexOffset / vertexStride_);
+	range.firstIndex = static_cast<uint32_t>(range.indexOffset / sizeof(uint16_t));
+}
+
+WGPUBuffer WGPU::Buffer::MeshPool::createBuffer(const Region& region, uint64_t size)
+{
+	WGPUBufferDescriptor bufferDesc = {};
+	bufferDesc.nextInChain = nullptr;
+	bufferDesc.label = region.label;
+	bufferDesc.size = size;
+	bufferDesc.usage = region.usage;
+	bufferDesc.mappedAtCreation = false;
+	WGPUBuffer buffer = wgpuDeviceCreateBuffer(Core::Device(), &bufferDesc);
+	if (!buffer) {
+		throw std::runtime_error("Failed to create mesh pool buffer.");
+	}
+	return buffer;
+}
+
+void WGPU::Buffer::MeshPool::submitCopies(WGPUCommandEncoder encoder)
+{
+	WGPUCommandBufferDescriptor cmdBufferDescriptor = {};
+	cmdBufferDescriptor.nextInChain = nullptr;
+	cmdBufferDescriptor.label = "Mesh pool copies";
+	WGPUCommandBuffer command = wgpuCommandEncoderFinish(encoder, &cmdBufferDescriptor);
+	wgpuCommandEncoderRelease(encoder);
+
+	wgpuQueueSubmit(Core::Queue(), 1, &command);
+	wgpuCommandBufferRelease(command);
+}
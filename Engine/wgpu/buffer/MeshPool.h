@@ -0,0 +1,190 @@
+#pragma once
+
+#include <webgpu/webgpu.h>
+#include <core/Core.h>
+#include <cstddef>
+#include <span>
+#include <vector>
+#include <stdexcept>
+#include <iostream>
+
+#include "RangeAllocator.h"
+#include "StagingBelt.h"
+
+namespace WGPU::Buffer {
+
+	/**
+	 * @struct MeshHandle
+	 * @brief Stable reference to a mesh stored in a MeshPool; survives growth and defragmentation.
+	 */
+	struct MeshHandle {
+		uint32_t id = UINT32_MAX;
+
+		bool IsValid() const { return id != UINT32_MAX; }
+	};
+
+	/**
+	 * @struct MeshRange
+	 * @brief Where a mesh currently lives inside the pool's shared buffers.
+	 */
+	struct MeshRange {
+		uint64_t vertexOffset = 0;
+		uint64_t vertexBytes = 0;
+		uint64_t indexOffset = 0;
+		uint64_t indexBytes = 0;
+
+		int32_t baseVertex = 0;
+		uint32_t vertexCount = 0;
+		uint32_t firstIndex = 0;
+		uint32_t indexCount = 0;
+	};
+
+	/**
+	 * @struct MeshPoolStats
+	 * @brief Usage of the shared buffers, for profiling overlays and deciding when to Defragment().
+	 */
+	struct MeshPoolStats {
+		size_t meshCount = 0;
+
+		uint64_t vertexCapacity = 0;
+		uint64_t vertexUsed = 0;
+		uint64_t vertexLargestFreeBlock = 0;
+		size_t vertexFreeBlocks = 0;
+
+		uint64_t indexCapacity = 0;
+		uint64_t indexUsed = 0;
+		uint64_t indexLargestFreeBlock = 0;
+		size_t indexFreeBlocks = 0;
+
+		uint32_t growCount = 0;
+		uint32_t defragmentCount = 0;
+
+		/**
+		 * @brief 0 when all free space is one block, approaching 1 as it splinters.
+		 */
+		float Fragmentation() const {
+			const uint64_t free = (vertexCapacity - vertexUsed) + (indexCapacity - indexUsed);
+			const uint64_t largest = vertexLargestFreeBlock + indexLargestFreeBlock;
+			return free == 0 ? 0.0f : 1.0f - static_cast<float>(largest) / static_cast<float>(free);
+		}
+	};
+
+	/**
+	 * @class MeshPool
+	 * @brief Suballocates every mesh of one vertex format out of a single vertex buffer and a
+	 * single uint16 index buffer.
+	 *
+	 * Meshes get a range in each buffer from a RangeAllocator. Vertex ranges are aligned to
+	 * the vertex stride, so every mesh is addressed by baseVertex / firstIndex and all draws
+	 * from the pool share one SetVertexBuffer / SetIndexBuffer:
+	 *
+	 * @code
+	 * WGPU::Buffer::MeshPool pool(sizeof(float) * 4);
+	 * auto quad = pool.Add(quadStruct.Vertices, quadStruct.Indices);
+	 * pool.Bind(renderPass);
+	 * pool.Draw(renderPass, quad);
+	 * @endcode
+	 *
+	 * When a buffer runs out of space it is replaced by one twice as large and the old
+	 * contents are copied over on the GPU. Defragment() packs every live mesh to the front.
+	 * Handles stay valid across both; only the ranges behind them move.
+	 */
+	class MeshPool {
+	public:
+		/**
+		 * @param vertexStride Size of one vertex in bytes.
+		 * @param vertexCapacity Initial size of the vertex buffer in bytes.
+		 * @param indexCapacity Initial size of the index buffer in bytes.
+		 */
+		MeshPool(uint32_t vertexStride, uint64_t vertexCapacity = 1 << 20, uint64_t indexCapacity = 256 << 10);
+		~MeshPool();
+
+		MeshPool(const MeshPool&) = delete;
+		MeshPool& operator=(const MeshPool&) = delete;
+
+		/*============================================================
+		* PUBLIC
+		=============================================================*/
+
+		/**
+		 * @brief Uploads a mesh into the shared buffers.
+		 *
+		 * Takes raw bytes so any vertex encoding fits, e.g. CompactVertex2D:
+		 *
+		 * @code
+		 * auto mesh = pool.Add(std::as_bytes(std::span(compactVertices)), sizeof(CompactVertex2D), indices);
+		 * @endcode
+		 *
+		 * @param vertices Tightly packed vertices, a whole number of stride bytes each.
+		 * @param stride Size of one vertex in bytes; must be the pool's vertex stride.
+		 * @param indices uint16 indices relative to the mesh's first vertex.
+		 * @param stagingBelt When set, uploads and any growth copy are recorded on the belt.
+		 * Submit the belt before adding to the pool without it, otherwise a growth copy
+		 * submitted directly could run ahead of the pending uploads.
+		 * @throws std::invalid_argument If stride is not the pool's, or the data is not whole
+		 * vertices with at least one index.
+		 */
+		MeshHandle Add(std::span<const std::byte> vertices, uint32_t stride, std::span<const uint16_t> indices, StagingBelt* stagingBelt = nullptr);
+
+		/**
+		 * @brief Same as Add(bytes, stride, ...) for float vertices of the pool's stride.
+		 */
+		MeshHandle Add(std::span<const float> vertices, std::span<const uint16_t> indices, StagingBelt* stagingBelt = nullptr) {
+			return Add(std::as_bytes(vertices), vertexStride_, indices, stagingBelt);
+		}
+
+		/**
+		 * @brief Releases the mesh's ranges; the handle must not be used afterwards.
+		 */
+		void Remove(MeshHandle mesh);
+
+		const MeshRange& Get(MeshHandle mesh) const;
+
+		/**
+		 * @brief Binds the shared vertex buffer at slot 0 and the shared index buffer.
+		 */
+		void Bind(WGPURenderPassEncoder renderPass) const;
+
+		/**
+		 * @brief Draws one mesh; Bind() must have been called on the pass.
+		 */
+		void Draw(WGPURenderPassEncoder renderPass, MeshHandle mesh, uint32_t instanceCount = 1) const;
+
+		/**
+		 * @brief Packs every live mesh to the front of fresh buffers, so all free space is
+		 * one block at the end. Costs one copy per mesh, all recorded on a single encoder.
+		 */
+		void Defragment(StagingBelt* stagingBelt = nullptr);
+
+		MeshPoolStats GetStats() const;
+
+		WGPUBuffer GetVertexBuffer() const { return vertices_.buffer; }
+		WGPUBuffer GetIndexBuffer() const { return indices_.buffer; }
+		uint32_t GetVertexStride() const { return vertexStride_; }
+	private:
+		struct Region {
+			const char* label = nullptr;
+			WGPUBufferUsageFlags usage = 0;
+			WGPUBuffer buffer = nullptr;
+			RangeAllocator allocator;
+		};
+
+		uint32_t vertexStride_;
+		Region vertices_;
+		Region indices_;
+
+		std::vector<MeshRange> meshes_;
+		std::vector<bool> live_;
+		std::vector<uint32_t> freeIds_;
+
+		uint32_t growCount_ = 0;
+		uint32_t defragmentCount_ = 0;
+
+		uint64_t allocate(Region& region, uint64_t size, uint64_t alignment, StagingBelt* stagingBelt);
+		void grow(Region& region, uint64_t minimumCapacity, StagingBelt* stagingBelt);
+		void updateDrawOffsets(MeshRange& range) const;
+
+		static WGPUBuffer createBuffer(const Region& region, uint64_t size);
+		static void submitCopies(WGPUCommandEncoder encoder);
+	};
+}
@@ -0,0 +1,123 @@
+#include "RangeAllocator.h"
+#include "UniformLayout.h"
+
+#include <stdexcept>
+
+WGPU::Buffer::RangeAllocator::RangeAllocator(uint64_t capacity)
+{
+	Reset(capacity);
+}
+
+uint64_t WGPU::Buffer::RangeAllocator::Allocate(uint64_t size, uint64_t alignment)
+{
+	if (size == 0) {
+		throw std::invalid_argument("Cannot allocate an empty range.");
+	}
+	if (alignment == 0) {
+		alignment = 1;
+	}
+
+	// Smallest block that still fits once its start is aligned
+	for (auto it = freeBySize_.lower_bound(size); it != freeBySize_.end(); ++it) {
+		const uint64_t blockOffset = it->second;
+		const uint64_t blockSize = it->first;
+		const uint64_t offset = AlignUp(blockOffset, alignment);
+		if (offset + size > blockOffset + blockSize) {
+			continue;
+		}
+
+		eraseFree(freeByOffset_.find(blockOffset));
+		if (offset > blockOffset) {
+			insertFree(blockOffset, offset - blockOffset); // Alignment padding stays free
+		}
+		if (offset + size < blockOffset + blockSize) {
+			insertFree(offset + size, blockOffset + blockSize - offset - size);
+		}
+
+		allocations_.emplace(offset, size);
+		usedBytes_ += size;
+		return offset;
+	}
+	return InvalidOffset;
+}
+
+void WGPU::Buffer::RangeAllocator::Free(uint64_t offset)
+{
+	auto allocation = allocations_.find(offset);
+	if (allocation == allocations_.end()) {
+		throw std::invalid_argument("Range was not allocated by this allocator.");
+	}
+	uint64_t start = allocation->first;
+	uint64_t end = start + allocation->second;
+	usedBytes_ -= allocation->second;
+	allocations_.erase(allocation);
+
+	// Merge with the free neighbours on both sides
+	auto next = freeByOffset_.lower_bound(start);
+	if (next != freeByOffset_.end() && next->first == end) {
+		end += next->second;
+		next = std::next(next);
+		eraseFree(std::prev(next));
+	}
+	if (next != freeByOffset_.begin()) {
+		auto previous = std::prev(next);
+		if (previous->first + previous->second == start) {
+			start = previous->first;
+			eraseFree(previous);
+		}
+	}
+	insertFree(start, end - start);
+}
+
+void WGPU::Buffer::RangeAllocator::Grow(uint64_t newCapacity)
+{
+	if (newCapacity <= capacity_) {
+		return;
+	}
+
+	uint64_t start = capacity_;
+	if (!freeByOffset_.empty()) {
+		auto last = std::prev(freeByOffset_.end());
+		if (last->first + last->second == capacity_) {
+			start = last->first;
+			eraseFree(last);
+		}
+	}
+	insertFree(start, newCapacity - start);
+	capacity_ = newCapacity;
+}
+
+void WGPU::Buffer::RangeAllocator::Reset(uint64_t capacity)
+{
+	freeByOffset_.clear();
+	freeBySize_.clear();
+	allocations_.clear();
+	usedBytes_ = 0;
+	capacity_ = capacity;
+	if (capacity_ > 0) {
+		insertFree(0, capacity_);
+	}
+}
+
+uint64_t WGPU::Buffer::RangeAllocator::GetLargestFreeBlock() const
+{
+	return freeBySize_.empty() ? 0 : std::prev(freeBySize_.end())->first;
+}
+
+void WGPU::Buffer::RangeAllocator::insertFree(uint64_t offset, uint64_t size)
+{
+	freeByOffset_.emplace(offset, size);
+	freeBySize_.emplace(size, offset);
+}
+
+void WGPU::Buffer::RangeAllocator::eraseFree(std::map<uint64_t, uint64_t>::iterator block)
+{
+	auto [first, last] = freeBySize_.equal_range(block->second);
+	for (auto it = first; it != last; ++it) {
+		if (it->second == block->first) {
+			freeBySize_.erase(it);
+			break;
+		}
+	}
+	freeByOffset_.erase(block);
+}
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <unordered_map>
+
+namespace WGPU::Buffer {
+
+	/**
+	 * @class RangeAllocator
+	 * @brief Best-fit free-list allocator over an abstract [0, capacity) byte range.
+	 *
+	 * Holds no GPU memory itself; it only hands out offsets so several owners can share
+	 * one large buffer. Free blocks are indexed both by offset (to coalesce neighbours on
+	 * Free) and by size (to find the best fit in O(log n)).
+	 */
+	class RangeAllocator {
+	public:
+		static constexpr uint64_t InvalidOffset = UINT64_MAX;
+
+		explicit RangeAllocator(uint64_t capacity = 0);
+
+		/*============================================================
+		* PUBLIC
+		=============================================================*/
+
+		/**
+		 * @brief Reserves size bytes at an offset that is a multiple of alignment.
+		 *
+		 * @return The offset, or InvalidOffset when no free block fits.
+		 */
+		uint64_t Allocate(uint64_t size, uint64_t alignment);
+
+		/**
+		 * @brief Returns the allocation starting at offset to the free list.
+		 */
+		void Free(uint64_t offset);
+
+		/**
+		 * @brief Extends the range to newCapacity, adding the new tail as free space.
+		 */
+		void Grow(uint64_t newCapacity);
+
+		/**
+		 * @brief Forgets every allocation and makes [0, capacity) one free block.
+		 */
+		void Reset(uint64_t capacity);
+
+		uint64_t GetCapacity() const { return capacity_; }
+		uint64_t GetUsedBytes() const { return usedBytes_; }
+		uint64_t GetFreeBytes() const { return capacity_ - usedBytes_; }
+		uint64_t GetLargestFreeBlock() const;
+		size_t GetFreeBlockCount() const { return freeByOffset_.size(); }
+		size_t GetAllocationCount() const { return allocations_.size(); }
+	private:
+		uint64_t capacity_ = 0;
+		uint64_t usedBytes_ = 0;
+
+		std::map<uint64_t, uint64_t> freeByOffset_; // offset -> size
+		std::multimap<uint64_t, uint64_t> freeBySize_; // size -> offset
+		std::unordered_map<uint64_t, uint64_t> allocations_; // offset -> size
+
+		void insertFree(uint64_t offset, uint64_t size);
+		void eraseFree(std::map<uint64_t, uint64_t>::iterator block);
+	};
+}
@@ -0,0 +1,28 @@
+#pragma once
+
+#include <atomic>
+
+namespace WGPU::Buffer {
+	/**
+	 * @class ReleaseHook
+	 * @brief Tells whoever caches objects built on a buffer that the buffer is going away.
+	 *
+	 * Buffers call Notify() with their handle right before releasing it. The BindGroupCache
+	 * registers itself on creation, so the buffer layer never includes the pipeline layer;
+	 * before that no bind group can refer to a buffer and Notify() does nothing.
+	 */
+	class ReleaseHook {
+	public:
+		using Callback = void (*)(const void* resource);
+
+		static void Set(Callback callback) { callback_.store(callback); }
+
+		static void Notify(const void* resource) {
+			if (Callback callback = callback_.load()) {
+				callback(resource);
+			}
+		}
+	private:
+		inline static std::atomic<Callback> callback_{ nullptr };
+	};
+}
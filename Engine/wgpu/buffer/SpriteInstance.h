@@ -0,0 +1,43 @@
+#pragma once
+
+#include <glm/glm.hpp>
+#include <cstddef>
+#include <cstdint>
+
+namespace WGPU::Buffer {
+	/**
+	 * @struct SpriteInstance
+	 * @brief Per-sprite data streamed into the instance vertex buffer of a SpriteBatch.
+	 *
+	 * The layout is mirrored by the instance vertex attributes of SpriteBatchPipeline,
+	 * so the struct is uploaded as-is without any repacking.
+	 */
+	struct SpriteInstance {
+		glm::vec2 position{ 0.0f, 0.0f };           // Centre of the sprite in pixels
+		glm::vec2 size{ 1.0f, 1.0f };               // Width and height in pixels
+		float rotation = 0.0f;                      // Radians, around the centre
+		uint32_t layer = 0;                         // Array layer of a Texture2DArray sheet; ignored by 2D sheets
+		float padding_[2]{};                        // Keeps uvRect 16-byte aligned
+		glm::vec4 uvRect{ 0.0f, 0.0f, 1.0f, 1.0f }; // u0, v0, u1, v1
+		glm::vec4 tint{ 1.0f, 1.0f, 1.0f, 1.0f };   // Multiplied with the sampled colour
+	};
+
+	static_assert(sizeof(SpriteInstance) == 64, "SpriteInstance must stay 64 bytes to match the instance layout.");
+	static_assert(offsetof(SpriteInstance, uvRect) == 32, "SpriteInstance::uvRect must be 16-byte aligned.");
+	static_assert(offsetof(SpriteInstance, layer) == offsetof(SpriteInstance, rotation) + 4, "SpriteInstance::layer is read together with rotation.");
+
+	/**
+	 * @struct CompactSpriteInstance
+	 * @brief Quantized SpriteInstance, produced by PackSpriteInstances for the quantized
+	 * SpriteBatchPipeline variant.
+	 */
+	struct CompactSpriteInstance {
+		int16_t position[2];  // Sint16x2, whole pixels
+		uint16_t size[2];     // Float16x2
+		uint16_t rotation[2]; // Float16x2, radians in x, array layer in y
+		uint16_t uvRect[4];   // Unorm16x4
+		uint8_t tint[4];      // Unorm8x4
+	};
+
+	static_assert(sizeof(CompactSpriteInstance) == 24, "CompactSpriteInstance must stay 24 bytes to match the instance layout.");
+}
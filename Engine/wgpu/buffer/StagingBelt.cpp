@@ -0,0 +1,256 @@
+#include "StagingBelt.h"
+#include "UniformLayout.h"
+
+#include <cstring>
+
+namespace {
+	struct SubmittedBatch {
+		std::weak_ptr<void> state;
+		std::vector<void*> chunks;
+	};
+
+	struct ChunkMapping {
+		std::weak_ptr<void> state;
+		void* chunk;
+	};
+}
+
+WGPU::Buffer::StagingBelt::StagingBelt(size_t chunkSize) :
+	state_(std::make_shared<State>()),
+	chunkSize_(AlignUp(chunkSize, 256))
+{
+	state_->chunkSize = chunkSize_;
+}
+
+WGPU::Buffer::StagingBelt::~StagingBelt()
+{
+	if (encoder_) {
+		wgpuCommandEncoderRelease(encoder_);
+		encoder_ = nullptr;
+	}
+}
+
+WGPU::Buffer::StagingBelt::State::~State()
+{
+	std::cout << "WGPU::Buffer::StagingBelt - Releasing " << chunks.size() << " staging chunks..." << std::endl;
+	for (auto& chunk : chunks) {
+		if (chunk->buffer) {
+			wgpuBufferRelease(chunk->buffer);
+			chunk->buffer = nullptr;
+		}
+	}
+}
+
+void WGPU::Buffer::StagingBelt::WriteBuffer(WGPUBuffer destination, uint64_t destinationOffset, const void* data, size_t size)
+{
+	// Padding here would overwrite destination bytes the caller did not ask to write
+	if (destinationOffset % 4 != 0 || size % 4 != 0) {
+		throw std::invalid_argument("StagingBelt: buffer writes must start and end on 4-byte boundaries.");
+	}
+
+	WGPUBuffer source = nullptr;
+	uint64_t sourceOffset = 0;
+	uint8_t* staging = allocate(size, 4, source, sourceOffset);
+	std::memcpy(staging, data, size);
+
+	wgpuCommandEncoderCopyBufferToBuffer(encoder(), source, sourceOffset, destination, destinationOffset, size);
+}
+
+void WGPU::Buffer::StagingBelt::WriteTexture(const WGPUImageCopyTexture& destination, const void* data, uint32_t bytesPerRow, const WGPUExtent3D& copySize)
+{
+	const uint32_t alignedBytesPerRow = static_cast<uint32_t>(AlignUp(bytesPerRow, 256));
+	const size_t rows = static_cast<size_t>(copySize.height) * copySize.depthOrArrayLayers;
+
+	WGPUBuffer source = nullptr;
+	uint64_t sourceOffset = 0;
+	uint8_t* staging = allocate(alignedBytesPerRow * rows, 256, source, sourceOffset);
+
+	// Re-lay the rows out straight into the staging memory, no intermediate copy
+	const auto* pixels = static_cast<const uint8_t*>(data);
+	for (size_t row = 0; row < rows; ++row) {
+		std::memcpy(staging + row * alignedBytesPerRow, pixels + row * bytesPerRow, bytesPerRow);
+	}
+
+	WGPUImageCopyBuffer copySource = {};
+	copySource.nextInChain = nullptr;
+	copySource.buffer = source;
+	copySource.layout.nextInChain = nullptr;
+	copySource.layout.offset = sourceOffset;
+	copySource.layout.bytesPerRow = alignedBytesPerRow;
+	copySource.layout.rowsPerImage = copySize.height;
+
+	wgpuCommandEncoderCopyBufferToTexture(encoder(), &copySource, &destination, &copySize);
+}
+
+void WGPU::Buffer::StagingBelt::CopyBuffer(WGPUBuffer source, uint64_t sourceOffset, WGPUBuffer destination, uint64_t destinationOffset, uint64_t size)
+{
+	wgpuCommandEncoderCopyBufferToBuffer(encoder(), source, sourceOffset, destination, destinationOffset, size);
+}
+
+void WGPU::Buffer::StagingBelt::CopyTexture(const WGPUImageCopyTexture& source, const WGPUImageCopyTexture& destination, const WGPUExtent3D& copySize)
+{
+	wgpuCommandEncoderCopyTextureToTexture(encoder(), &source, &destination, &copySize);
+}
+
+void WGPU::Buffer::StagingBelt::Submit()
+{
+	// Empty submits count too, so chunks left over from a burst age out while idle
+	++submits_;
+	if (!encoder_) {
+		releaseIdleChunks();
+		return; // Nothing recorded
+	}
+
+	// Chunks have to be unmapped before the copies that read them execute
+	auto batch = new SubmittedBatch{ state_, {} };
+	for (auto& chunk : state_->chunks) {
+		if (chunk->state == ChunkState::Active) {
+			wgpuBufferUnmap(chunk->buffer);
+			chunk->mapped = nullptr;
+			chunk->state = ChunkState::InFlight;
+			chunk->lastSubmit = submits_;
+			batch->chunks.push_back(chunk.get());
+		}
+	}
+
+	WGPUCommandBufferDescriptor cmdBufferDescriptor = {};
+	cmdBufferDescriptor.nextInChain = nullptr;
+	cmdBufferDescriptor.label = "Staging belt uploads";
+	WGPUCommandBuffer command = wgpuCommandEncoderFinish(encoder_, &cmdBufferDescriptor);
+	wgpuCommandEncoderRelease(encoder_);
+	encoder_ = nullptr;
+
+	wgpuQueueSubmit(Core::Queue(), 1, &command);
+	wgpuCommandBufferRelease(command);
+
+	wgpuQueueOnSubmittedWorkDone(Core::Queue(), &StagingBelt::onSubmittedWorkDone, batch);
+	releaseIdleChunks();
+}
+
+size_t WGPU::Buffer::StagingBelt::GetChunkCount() const
+{
+	return state_->chunks.size();
+}
+
+size_t WGPU::Buffer::StagingBelt::GetFreeChunkCount() const
+{
+	size_t count = 0;
+	for (const auto& chunk : state_->chunks) {
+		count += chunk->state == ChunkState::Free ? 1 : 0;
+	}
+	return count;
+}
+
+/**
+ * Reserves size bytes in a mapped chunk, reusing the current chunk when it has room,
+ * then a recycled chunk, and creating a new one only when neither fits.
+ */
+uint8_t* WGPU::Buffer::StagingBelt::allocate(size_t size, size_t alignment, WGPUBuffer& buffer, uint64_t& offset)
+{
+	Chunk* target = nullptr;
+	for (auto& chunk : state_->chunks) {
+		if (chunk->state == ChunkState::Active && AlignUp(chunk->cursor, alignment) + size <= chunk->size) {
+			target = chunk.get();
+			break;
+		}
+	}
+	if (!target) {
+		for (auto& chunk : state_->chunks) {
+			if (chunk->state == ChunkState::Free && chunk->mapped && size <= chunk->size) {
+				target = chunk.get();
+				target->state = ChunkState::Active;
+				target->cursor = 0;
+				break;
+			}
+		}
+	}
+	if (!target) {
+		auto chunk = std::make_unique<Chunk>();
+		chunk->size = size > chunkSize_ ? AlignUp(size, chunkSize_) : chunkSize_;
+
+		WGPUBufferDescriptor bufferDesc = {};
+		bufferDesc.nextInChain = nullptr;
+		bufferDesc.label = "Staging chunk";
+		bufferDesc.size = chunk->size;
+		bufferDesc.usage = WGPUBufferUsage_MapWrite | WGPUBufferUsage_CopySrc;
+		bufferDesc.mappedAtCreation = true;
+		chunk->buffer = wgpuDeviceCreateBuffer(Core::Device(), &bufferDesc);
+		if (!chunk->buffer) {
+			throw std::runtime_error("Failed to create staging chunk.");
+		}
+		chunk->mapped = static_cast<uint8_t*>(wgpuBufferGetMappedRange(chunk->buffer, 0, chunk->size));
+		chunk->state = ChunkState::Active;
+
+		target = chunk.get();
+		state_->chunks.push_back(std::move(chunk));
+	}
+
+	const size_t start = AlignUp(target->cursor, alignment);
+	target->cursor = start + size;
+
+	buffer = target->buffer;
+	offset = start;
+	return target->mapped + start;
+}
+
+/**
+ * Free chunks are mapped and referenced by no pending callback, so they can go at once.
+ */
+void WGPU::Buffer::StagingBelt::releaseIdleChunks()
+{
+	std::erase_if(state_->chunks, [&](const std::unique_ptr<Chunk>& chunk) {
+		if (chunk->state != ChunkState::Free || submits_ - chunk->lastSubmit <= IdleSubmits) {
+			return false;
+		}
+		wgpuBufferRelease(chunk->buffer);
+		return true;
+	});
+}
+
+WGPUCommandEncoder WGPU::Buffer::StagingBelt::encoder()
+{
+	if (!encoder_) {
+		WGPUCommandEncoderDescriptor encoderDesc = {};
+		encoderDesc.nextInChain = nullptr;
+		encoderDesc.label = "Staging belt encoder";
+		encoder_ = wgpuDeviceCreateCommandEncoder(Core::Device(), &encoderDesc);
+	}
+	return encoder_;
+}
+
+void WGPU::Buffer::StagingBelt::onSubmittedWorkDone(WGPUQueueWorkDoneStatus status, void* userData)
+{
+	std::unique_ptr<SubmittedBatch> batch(static_cast<SubmittedBatch*>(userData));
+	auto state = batch->state.lock();
+	if (!state || status != WGPUQueueWorkDoneStatus_Success) {
+		return;
+	}
+
+	// The copies are done, map the chunks again so they can be refilled. Oversized chunks
+	// were made for one upload and are released instead of being kept around
+	auto* belt = static_cast<State*>(state.get());
+	for (void* chunk : batch->chunks) {
+		Chunk* target = static_cast<Chunk*>(chunk);
+		if (target->size > belt->chunkSize) {
+			wgpuBufferRelease(target->buffer);
+			std::erase_if(belt->chunks, [&](const std::unique_ptr<Chunk>& owned) { return owned.get() == target; });
+			continue;
+		}
+		auto* mapping = new ChunkMapping{ batch->state, chunk };
+		wgpuBufferMapAsync(target->buffer, WGPUMapMode_Write, 0, target->size, &StagingBelt::onChunkMapped, mapping);
+	}
+}
+
+void WGPU::Buffer::StagingBelt::onChunkMapped(WGPUBufferMapAsyncStatus status, void* userData)
+{
+	std::unique_ptr<ChunkMapping> mapping(static_cast<ChunkMapping*>(userData));
+	auto state = mapping->state.lock();
+	if (!state || status != WGPUBufferMapAsyncStatus_Success) {
+		return;
+	}
+
+	Chunk* chunk = static_cast<Chunk*>(mapping->chunk);
+	chunk->mapped = static_cast<uint8_t*>(wgpuBufferGetMappedRange(chunk->buffer, 0, chunk->size));
+	chunk->cursor = 0;
+	chunk->state = ChunkState::Free;
+}
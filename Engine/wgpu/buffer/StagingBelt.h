@@ -0,0 +1,120 @@
+#pragma once
+
+#include <webgpu/webgpu.h>
+#include <core/Core.h>
+#include <memory>
+#include <vector>
+#include <stdexcept>
+#include <iostream>
+
+namespace WGPU::Buffer {
+
+	/**
+	 * @class StagingBelt
+	 * @brief Batches buffer and texture uploads into one command encoder and one submit.
+	 *
+	 * Uploads are copied once into persistently mapped MapWrite | CopySrc chunks and recorded
+	 * as copyBufferToBuffer / copyBufferToTexture commands. Submit() unmaps the chunks used
+	 * this frame and submits the encoder; once wgpuQueueOnSubmittedWorkDone reports the copies
+	 * as done the chunks are mapped again and go back to the free list. Callbacks are delivered
+	 * by wgpuDeviceTick, which FrameContext::BeginFrame() calls every frame.
+	 *
+	 * Chunks made larger than chunkSize for a single big upload are released as soon as their
+	 * copies are done, and regular chunks left unused for IdleSubmits submits are released
+	 * too (empty submits count), so a burst of loading does not pin staging memory for the
+	 * rest of the run.
+	 *
+	 * @code
+	 * WGPU::Buffer::StagingBelt belt;
+	 * auto vb = std::make_unique<WGPU::Buffer::VertexBuffer>(..., &belt);
+	 * auto texture = std::make_unique<Utilities::TextureImage>("../assets/test.png", &belt);
+	 * belt.Submit(); // every upload above goes out with a single submit
+	 * @endcode
+	 */
+	class StagingBelt {
+	public:
+		static constexpr uint64_t IdleSubmits = 120;
+
+		explicit StagingBelt(size_t chunkSize = 1 << 20);
+		~StagingBelt();
+
+		StagingBelt(const StagingBelt&) = delete;
+		StagingBelt& operator=(const StagingBelt&) = delete;
+
+		/*============================================================
+		* PUBLIC
+		=============================================================*/
+
+		/**
+		 * @brief Stages size bytes and records a copy into destination at destinationOffset.
+		 *
+		 * @throws std::invalid_argument If destinationOffset or size is not a multiple of 4,
+		 * as copyBufferToBuffer requires. Pad the source data instead.
+		 */
+		void WriteBuffer(WGPUBuffer destination, uint64_t destinationOffset, const void* data, size_t size);
+
+		/**
+		 * @brief Stages tightly packed rows and records a copy into a texture region.
+		 *
+		 * Rows are re-laid out to the 256-byte bytesPerRow alignment required by
+		 * copyBufferToTexture while being copied into the staging chunk.
+		 *
+		 * @param destination The texture, mip level and origin to copy into.
+		 * @param data Tightly packed source rows.
+		 * @param bytesPerRow Bytes in one source row.
+		 * @param copySize Extent of the region in texels.
+		 */
+		void WriteTexture(const WGPUImageCopyTexture& destination, const void* data, uint32_t bytesPerRow, const WGPUExtent3D& copySize);
+
+		/**
+		 * @brief Records a GPU-side buffer copy on the belt's encoder, ordered after the
+		 * uploads staged so far.
+		 */
+		void CopyBuffer(WGPUBuffer source, uint64_t sourceOffset, WGPUBuffer destination, uint64_t destinationOffset, uint64_t size);
+
+		/**
+		 * @brief Records a GPU-side texture copy on the belt's encoder, ordered after the
+		 * uploads staged so far.
+		 */
+		void CopyTexture(const WGPUImageCopyTexture& source, const WGPUImageCopyTexture& destination, const WGPUExtent3D& copySize);
+
+		/**
+		 * @brief Submits every copy recorded since the last call with a single queue submit.
+		 */
+		void Submit();
+
+		bool HasPendingCopies() const { return encoder_ != nullptr; }
+		size_t GetChunkCount() const;
+		size_t GetFreeChunkCount() const;
+	private:
+		enum class ChunkState { Free, Active, InFlight };
+
+		struct Chunk {
+			WGPUBuffer buffer = nullptr;
+			size_t size = 0;
+			size_t cursor = 0;
+			uint8_t* mapped = nullptr;
+			ChunkState state = ChunkState::Free;
+			uint64_t lastSubmit = 0; // Submit() that last used the chunk
+		};
+
+		// Shared with the GPU callbacks so they can tell whether the belt is still alive
+		struct State {
+			std::vector<std::unique_ptr<Chunk>> chunks;
+			size_t chunkSize = 0;
+			~State();
+		};
+
+		std::shared_ptr<State> state_;
+		WGPUCommandEncoder encoder_ = nullptr;
+		size_t chunkSize_;
+		uint64_t submits_ = 0;
+
+		uint8_t* allocate(size_t size, size_t alignment, WGPUBuffer& buffer, uint64_t& offset);
+		WGPUCommandEncoder encoder();
+		void releaseIdleChunks();
+
+		static void onSubmittedWorkDone(WGPUQueueWorkDoneStatus status, void* userData);
+		static void onChunkMapped(WGPUBufferMapAsyncStatus status, void* userData);
+	};
+}
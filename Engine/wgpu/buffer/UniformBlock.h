@@ -0,0 +1,127 @@
+#pragma once
+
+#include <webgpu/webgpu.h>
+#include <array>
+#include <cstddef>
+#include <span>
+#include <type_traits>
+
+#include "UniformLayout.h"
+#include "UniformStorage.h"
+
+namespace WGPU::Buffer {
+
+    /**
+     * @class UniformBlock
+     * @brief A uniform buffer whose layout is a plain C++ struct checked against WGSL at compile time.
+     *
+     * The struct is the host mirror: members are written directly and Write() uploads the
+     * changed bytes with a single write through the UniformStorage it shares with
+     * UniformBuffer (queue or staging belt). Members must use types with a WGSL equivalent
+     * (see UniformTraits) and be declared so that their C++ offsets equal the WGSL ones,
+     * which usually means alignas(8) on a vec2 following a scalar and alignas(16) on
+     * vec3/vec4/mat4 following anything smaller:
+     *
+     * Sizes, alignments and member offsets are all checked when the block is instantiated.
+     * The offsets come from the struct's MemberOffsets() (see DeclaresMemberOffsets):
+     *
+     * @code
+     * struct QuadUniforms {
+     *     float time;
+     *     alignas(8) glm::vec2 position;
+     *     glm::vec2 size;
+     *     alignas(16) glm::mat4 Projection;
+     *
+     *     static constexpr std::array<size_t, 4> MemberOffsets() {
+     *         return { offsetof(QuadUniforms, time), offsetof(QuadUniforms, position),
+     *                  offsetof(QuadUniforms, size), offsetof(QuadUniforms, Projection) };
+     *     }
+     * };
+     * WGPU::Buffer::UniformBlock<QuadUniforms> block;
+     * block.Set<&QuadUniforms::time>(t); // marks only `time` dirty
+     * block.Write(&frameBelt); // or block.Write() for a direct queue write
+     * @endcode
+     *
+     * @tparam T An aggregate whose members mirror a WGSL uniform struct.
+     */
+    template <typename T>
+    class UniformBlock {
+    public:
+        using Layout = UniformLayoutOf<T>;
+
+        static_assert(std::is_aggregate_v<T>, "Uniform block struct must be an aggregate.");
+        static_assert(std::is_trivially_copyable_v<T>, "Uniform block struct must be trivially copyable.");
+        static_assert(std::is_standard_layout_v<T>, "Uniform block struct must be standard layout.");
+        static_assert(alignof(T) <= Layout::Alignment, "Uniform block struct is over-aligned for its WGSL layout.");
+        static_assert(sizeof(T) == Layout::Size,
+            "Uniform block struct does not match its WGSL layout; align members with alignas() to their WGSL alignment.");
+        static_assert(DeclaresMemberOffsets<T>,
+            "Uniform block struct must declare static constexpr std::array<size_t, N> MemberOffsets() listing offsetof() of every member.");
+        static_assert(Detail::memberOffsetsAscend<T>(),
+            "Uniform block struct MemberOffsets() must list every member once, in declaration order.");
+        static_assert(Detail::memberOffsetsMatchLayout<T>(),
+            "Uniform block member offsets do not match the WGSL layout; align members with alignas() to their WGSL alignment.");
+
+        explicit UniformBlock(const T& initial = T{}) : data_(initial) {
+            storage_.MarkDirty(0, sizeof(T));
+        }
+
+        UniformBlock(const UniformBlock&) = delete;
+        UniformBlock& operator=(const UniformBlock&) = delete;
+
+        /*============================================================
+        * PUBLIC
+        =============================================================*/
+
+        WGPUBuffer Get() const { return storage_.Get(); }
+        static constexpr size_t GetSize() { return sizeof(T); }
+
+        /**
+         * @brief Mutable access to the host mirror. Marks the whole block dirty, so changes
+         * reach the GPU on the next Write(); prefer Set<&T::member>() for single members.
+         */
+        T& Data() {
+            storage_.MarkDirty(0, sizeof(T));
+            return data_;
+        }
+        const T& Data() const { return data_; }
+
+        void Set(const T& value) {
+            data_ = value;
+            storage_.MarkDirty(0, sizeof(T));
+        }
+
+        /**
+         * @brief Updates a single member and marks only its bytes dirty.
+         *
+         * @tparam Member Pointer to the member to update, e.g. &QuadUniforms::time.
+         */
+        template <auto Member, typename V>
+        void Set(const V& value) {
+            auto& field = data_.*Member;
+            field = value;
+            const auto offset = static_cast<size_t>(reinterpret_cast<const std::byte*>(&field) - reinterpret_cast<const std::byte*>(&data_));
+            storage_.MarkDirty(offset, sizeof(field));
+        }
+
+        bool IsDirty() const { return storage_.IsDirty(); }
+
+        /**
+         * @brief Uploads the dirty byte range of the host mirror with a single write,
+         * creating the GPU buffer on first use. Does nothing when the block is clean.
+         *
+         * @param stagingBelt When set, the range is staged on the belt and copied with the
+         * belt's next submit instead of being written through the queue.
+         *
+         * @throws std::runtime_error If the WebGPU device or queue is not initialized, or if
+         * the uniform buffer creation fails.
+         */
+        void Write(StagingBelt* stagingBelt = nullptr) {
+            storage_.Write(std::as_bytes(std::span(&data_, 1)), stagingBelt);
+        }
+
+    private:
+        T data_;
+        UniformStorage storage_;
+    };
+}
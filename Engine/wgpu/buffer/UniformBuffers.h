@@ -1,17 +1,25 @@
+#pragma once
+
 #include <webgpu/webgpu.h>
 #include <core/Core.h>
 #include <string>
+#include <string_view>
+#include <type_traits>
+#include <unordered_map>
 #include <vector>
-#include <variant>
 #include <glm/glm.hpp>
-#pragma warning(push)
-#pragma warning(disable : 4201)
-#include <glm/gtc/type_ptr.hpp>
-#pragma warning(pop)
 #include <stdexcept>
 #include <iostream>
-#include <array>
-#include <cstring> // For memset
+#include <cstring> // For memcpy
+#include <cstdint>
+#include <cassert>
+#include <span>
+
+#include "UniformLayout.h"
+#include "UploadStats.h"
+#include "StagingBelt.h"
+#include "UniformStorage.h"
+#include <wgpu/shader/ShaderReflection.h>
 
 namespace WGPU {
     namespace Buffer {
@@ -21,170 +29,223 @@ namespace WGPU {
         =============================================================*/
         /**
          * @struct BufferData
-         * @brief Represents data stored in a GPU buffer for use with WebGPU.
+         * @brief Describes one uniform stored in the host mirror of a UniformBuffer.
          *
-         * This structure is designed to handle different types of data compatible
-         * with WebGPU, including scalar types, vectors, and matrices. It includes
-         * metadata about the buffer (name, size, and offset) and a variant to store
-         * the value in various formats.
+         * The value itself lives in the contiguous host mirror at `offset`; this entry only
+         * records where it is and what WGSL type it was added as.
          */
         struct BufferData {
             /**
-             * @brief The name of the buffer data.
-             * This is typically used to identify the purpose or variable associated
-             * with this buffer entry.
+             * @brief The name of the uniform, matching the WGSL struct member.
              */
             std::string name;
 
             /**
-             * @brief The size of the buffer data in bytes.
-             * This represents the total size of the data stored in the GPU buffer.
-             */
-            size_t size;
-
-            /**
-             * @brief The offset of the buffer data in bytes.
-             * This is the starting position of the data in the GPU buffer.
+             * @brief The size of the uniform in bytes.
              */
-            size_t offset;
+            size_t size = 0;
 
             /**
-             * @brief A variant type to store WebGPU-compatible data types.
-             *
-             * The possible types include:
-             * - `float`: A single scalar value.
-             * - `int`: A single integer value.
-             * - `uint32_t`: A single unsigned integer value.
-             * - `std::array<float, 2>`: A 2D vector (vec2).
-             * - `std::array<float, 3>`: A 3D vector (vec3).
-             * - `std::array<float, 4>`: A 4D vector (vec4).
-             * - `std::array<float, 8>`: Padding for alignment or other purposes.
-             * - `std::array<float, 12>`: Padding for alignment or other purposes.
-             * - `std::array<float, 16>`: A 4x4 matrix (mat4).
+             * @brief The offset of the uniform in bytes, aligned per the WGSL rules.
              */
-            using ValueType = std::variant<
-                float,
-                int,
-                uint32_t,
-                std::array<float, 2>,  // For vec2
-                std::array<float, 3>,  // For vec3
-                std::array<float, 4>,  // For vec4
-                std::array<float, 8>,  // Padding
-                std::array<float, 12>, // Padding
-                std::array<float, 16>  // For mat4
-            >;
+            size_t offset = 0;
 
             /**
-             * @brief The value stored in the buffer.
-             * This can hold any type defined in the ValueType variant.
+             * @brief The WGSL type the uniform was added as; updates must use the same type.
              */
-            ValueType value;
+            UniformKind kind = UniformKind::F32;
+        };
 
-            /**
-             * @brief Default constructor.
-             * Initializes the buffer data with default values.
-             */
-            BufferData()
-                : name(""), size(0), offset(0), value() {}
+        /*============================================================
+        * UNIFORM HANDLE
+        =============================================================*/
+        /**
+         * @struct UniformHandle
+         * @brief Typed reference to a uniform inside a UniformBuffer.
+         *
+         * Holds the byte offset in the host mirror and the field index; the value type is
+         * part of the handle type, so mismatched updates are rejected at compile time.
+         */
+        template <UniformType T>
+        struct UniformHandle {
+            uint32_t offset = 0;
+            uint32_t index = 0;
+        };
 
-            /**
-             * @brief Constructor with parameters.
-             *
-             * @param name The name of the buffer data.
-             * @param size The size of the buffer data in bytes.
-             * @param offset The offset of the buffer data in bytes.
-             * @param value The value to initialize the buffer data.
-             */
-            BufferData(const std::string& name, size_t size, size_t offset, const ValueType& value)
-                : name(name), size(size), offset(offset), value(value) {}
+        /**
+         * @brief Transparent hash so the name table can be searched with a string_view.
+         */
+        struct NameHash {
+            using is_transparent = void;
+            size_t operator()(std::string_view name) const noexcept { return std::hash<std::string_view>{}(name); }
         };
 
+        /**
+         * @class UniformBuffer
+         * @brief A uniform buffer whose layout is assembled at runtime from named values.
+         *
+         * This is the dynamic counterpart of UniformBlock: it uses the same WGSL traits to place
+         * each value in a contiguous host mirror and the same UniformStorage to upload it, so
+         * Write() is a single queue write or belt copy. Prefer UniformBlock when the layout is
+         * known at compile time.
+         */
         class UniformBuffer {
         public:
             UniformBuffer();
-            ~UniformBuffer();
+
+            /**
+             * @brief Lays the buffer out from a reflected WGSL struct, one zeroed uniform per member.
+             *
+             * Handles for the members are then looked up with Find<T>(name).
+             *
+             * @throws std::invalid_argument If a member has no host uniform type or the struct
+             * uses @align/@size attributes that move it away from the default layout.
+             */
+            explicit UniformBuffer(const Shader::ReflectedStruct& layout);
+
+            UniformBuffer(const UniformBuffer&) = delete;
+            UniformBuffer& operator=(const UniformBuffer&) = delete;
 
             /*============================================================
             * PUBLIC
             =============================================================*/
 
-            WGPUBuffer Get() const { return uniformBuffer_; }
+            WGPUBuffer Get() const { return storage_.Get(); }
 
             /**
              * @brief Adds a new uniform to the buffer, ensuring proper alignment and padding.
              *
-             * This method handles adding a new uniform value to the buffer, including any
-             * necessary padding to maintain proper alignment based on the WebGPU alignment rules.
-             * It calculates the total size of the buffer, adjusts offsets, and ensures correct
-             * memory layout.
+             * The value is placed at the next offset satisfying its WGSL alignment; any gap
+             * before it stays zeroed in the host mirror.
              *
              * @tparam T The type of the value being added to the buffer.
              * @param name The name of the uniform variable.
              * @param value The value of the uniform variable to add.
+             * @return A typed handle for allocation-free updates in the frame loop.
+             * @throws std::invalid_argument If a uniform with the same name already exists.
              */
-            template <typename T>
-            void Add(const std::string& name, const T& value) {
-				// Handle padding on stride prior to adding the new uniform
-                BufferData padding = getPadding<T>();
-                if (padding.size > 0) {
-					totalSize_ += padding.size;
-					bufferData_.emplace_back(padding);
+            template <UniformType T>
+            UniformHandle<T> Add(std::string_view name, const T& value) {
+                if (nameIndex_.find(name) != nameIndex_.end()) {
+                    throw std::invalid_argument("Uniform buffer already contains this name.");
                 }
-                
-				// Add the new uniform
-                BufferData uniform = convertToStandardFormat(name, value);
-                uniform.offset = totalSize_;
+
+                BufferData uniform;
+                uniform.name = name;
+                uniform.size = UniformTraits<T>::Size;
+                uniform.offset = AlignUp(totalSize_, UniformTraits<T>::Alignment);
+                uniform.kind = UniformTraits<T>::Kind;
+
+                totalSize_ = uniform.offset + uniform.size;
+                if (UniformTraits<T>::Alignment > alignment_) {
+                    alignment_ = UniformTraits<T>::Alignment;
+                }
+                hostData_.resize(AlignUp(totalSize_, alignment_), 0);
+                std::memcpy(hostData_.data() + uniform.offset, &value, uniform.size);
+
+                const auto index = static_cast<uint32_t>(bufferData_.size());
+                nameIndex_.emplace(uniform.name, index);
                 bufferData_.emplace_back(uniform);
+                storage_.MarkDirty(uniform.offset, uniform.size);
 
-                totalSize_ += uniform.size;
+                return UniformHandle<T>{ static_cast<uint32_t>(uniform.offset), index };
             }
 
             /**
-             * @brief Updates the value of an existing uniform in the buffer.
+             * @brief Updates the value of an existing uniform through its handle.
              *
-             * This method searches for a uniform by its name and updates its value if the
-             * uniform exists and the type matches. If the uniform does not exist or the
-             * type does not match, an exception is thrown.
+             * O(1) and allocation-free. The handle carries the type, so passing a value of
+             * another type fails to compile. Writing the value that is already stored leaves
+             * the uniform clean.
+             *
+             * @tparam T The type of the uniform.
+             * @param handle The handle returned by Add().
+             * @param value The new value to set for the uniform.
+             * @throws std::invalid_argument If the handle was not returned by this buffer (asserts
+             * in debug builds).
+             */
+            template <UniformType T>
+            void Update(UniformHandle<T> handle, const std::type_identity_t<T>& value) {
+                // A default-constructed handle or one from another buffer would write out of bounds
+                const bool valid = handle.index < bufferData_.size()
+                    && bufferData_[handle.index].offset == handle.offset
+                    && bufferData_[handle.index].size == sizeof(T);
+                assert(valid && "Uniform handle does not belong to this buffer.");
+                if (!valid) {
+                    throw std::invalid_argument("Uniform handle does not belong to this buffer.");
+                }
+
+                uint8_t* destination = hostData_.data() + handle.offset;
+                if (std::memcmp(destination, &value, sizeof(T)) != 0) {
+                    std::memcpy(destination, &value, sizeof(T));
+                    storage_.MarkDirty(handle.offset, sizeof(T));
+                }
+            }
+
+            /**
+             * @brief Updates the value of an existing uniform by name.
+             *
+             * Meant for tooling; the frame loop should hold on to the handle returned by Add().
              *
              * @tparam T The type of the value to update.
              * @param name The name of the uniform to update.
              * @param value The new value to set for the uniform.
              * @throws std::invalid_argument If the uniform is not found or if there is a type mismatch.
              */
-            template <typename T>
-            void Update(const std::string& name, const T& value) {
-                for (auto& data : bufferData_) {
-                    if (data.name == name) {
-                        // Convert value into the correct variant type
-                        auto convertedValue = convertToStandardFormat(name, value).value;
+            template <UniformType T>
+            void Update(std::string_view name, const T& value) {
+                Update(Find<T>(name), value);
+            }
 
-                        // Check if the stored type matches the converted type
-                        if (data.value.index() == convertedValue.index()) {
-                            data.value = convertedValue;
-                            return;
-                        }
-                        else {
-                            throw std::invalid_argument("Type mismatch for uniform buffer value.");
-                        }
-                    }
+            /**
+             * @brief Looks up the handle of a uniform by name through the hashed name table.
+             *
+             * @tparam T The type the uniform is expected to have.
+             * @param name The name of the uniform.
+             * @throws std::invalid_argument If the uniform is not found or if there is a type mismatch.
+             */
+            template <UniformType T>
+            UniformHandle<T> Find(std::string_view name) const {
+                auto it = nameIndex_.find(name);
+                if (it == nameIndex_.end()) {
+                    throw std::invalid_argument("Uniform buffer not found.");
+                }
+                const BufferData& data = bufferData_[it->second];
+                if (data.kind != UniformTraits<T>::Kind) {
+                    throw std::invalid_argument("Type mismatch for uniform buffer value.");
                 }
-                throw std::invalid_argument("Uniform buffer not found.");
+                return UniformHandle<T>{ static_cast<uint32_t>(data.offset), it->second };
             }
 
-
+            const std::vector<BufferData>& GetFields() const { return bufferData_; }
 
             /**
              * @brief Writes the uniform buffer data to the GPU.
              *
              * This method checks if the WebGPU device and queue are initialized, creates or updates
-             * the uniform buffer if needed, and writes the current uniform buffer data to the GPU.
+             * the uniform buffer if needed, and uploads the merged byte range of every uniform
+             * changed since the last call with a single queue write. Nothing is uploaded when no
+             * uniform changed.
+             *
+             * @param stagingBelt When set, the range is staged on the belt and copied with the
+             * belt's next submit instead of being written through the queue.
              *
              * @throws std::runtime_error If the WebGPU device or queue is not initialized, or if
              * the uniform buffer creation fails.
              */
-            void Write();
+            void Write(StagingBelt* stagingBelt = nullptr) {
+                storage_.Write(std::as_bytes(std::span(hostData_)), stagingBelt);
+            }
+
+            /**
+             * @brief Size of the buffer as seen by WGSL, rounded up to the struct alignment.
+             */
+            size_t GetCurrentBufferSize() const { return hostData_.size(); }
 
-			size_t GetCurrentBufferSize() { return totalSize_; }
+            /**
+             * @brief True when at least one uniform changed since the last Write().
+             */
+            bool IsDirty() const { return storage_.IsDirty(); }
         private:
 
 
@@ -192,115 +253,12 @@ namespace WGPU {
             * PRIVATE PROPERTIES
             =============================================================*/
 
-            WGPUBuffer uniformBuffer_ = nullptr;
             size_t totalSize_ = 0;
+            size_t alignment_ = 4;
             std::vector<BufferData> bufferData_;
-			WGPUBufferDescriptor bufferDesc_ = {};
-
-
-            /*============================================================
-            * PRIVATE METHODS
-            =============================================================*/
-
-            template <typename T>
-            BufferData convertToStandardFormat(const std::string& name, const T& value) {
-                using ValueType = typename BufferData::ValueType; // Use the correct variant type from BufferData
-
-                if constexpr (
-                    std::is_same_v<T, float> || 
-                    std::is_same_v<T, int> || 
-                    std::is_same_v<T, uint32_t>
-                )  {
-                    return BufferData(name, sizeof(T), 0, value);
-                }
-                else if constexpr (std::is_same_v<T, glm::vec2>) {
-                    std::array<float, 2> converted = { value.x, value.y };
-                    return BufferData(name, sizeof(converted), 0, converted);
-                }
-                else if constexpr (std::is_same_v<T, glm::vec3>) {
-                    std::array<float, 3> converted = { value.x, value.y, value.z };
-                    return BufferData(name, sizeof(converted), 0, converted);
-                }
-                else if constexpr (std::is_same_v<T, glm::vec4>) {
-                    std::array<float, 4> converted = { value.x, value.y, value.z, value.w };
-                    return BufferData(name, sizeof(converted), 0, converted);
-                }
-                else if constexpr (std::is_same_v<T, glm::mat4>) {
-                    std::array<float, 16> converted;
-                    const float* ptr = glm::value_ptr(value); // Extract matrix data as a float array
-                    std::copy(ptr, ptr + 16, converted.begin());
-                    return BufferData(name, sizeof(converted), 0, converted);
-                }
-                else {
-                    throw std::invalid_argument("Unsupported data type.");
-                }
-            }
-
-
-            template <typename T>
-            size_t getAlignment() const {
-                if constexpr (
-                    std::is_same_v<T, float> || 
-                    std::is_same_v<T, int> || 
-                    std::is_same_v<T, uint32_t>
-                )  {
-                    return 4; // Scalars are 4-byte aligned
-                }
-                else if constexpr (std::is_same_v<T, glm::vec2>) {
-                    return 8; // vec2 is 8-byte aligned
-                }
-                else if constexpr (std::is_same_v<T, glm::vec3> || std::is_same_v<T, glm::vec4>) {
-                    return 16; // vec3 and vec4 are both 16-byte aligned, altough vec3 is stored with 12 bytes
-                }
-                else if constexpr (std::is_same_v<T, glm::mat4>) {
-                    return 16; // mat4 elements are 16-byte aligned (each column is vec4)
-                }
-                else {
-                    throw std::invalid_argument("Unsupported data type.");
-                }
-            }
-
-            template <std::size_t N>
-            BufferData createPadding(size_t padding) {
-                std::array<float, N> paddingValue = {}; // All elements initialized to 0
-
-                // Create and return the BufferData for padding
-                return BufferData(
-                    "padding_" + std::to_string(bufferData_.size()), // Name
-                    padding,                                         // Size of the padding
-                    totalSize_,                                      // Offset for the padding
-                    paddingValue                                     // ValueType-compatible
-                );
-            }
-
-			template <typename T>
-            BufferData getPadding() {
-                // Get the alignment for the current type
-                std::size_t alignment = getAlignment<T>();
-
-                // Calculate padding size
-                std::size_t padding = 0;
-                if (totalSize_ % alignment != 0) {
-                    padding = alignment - (totalSize_ % alignment);
-                }
-
-                if (padding == 0) {
-                    return BufferData();
-                }
-
-                if (padding == 4) {
-                    return createPadding<4>(padding);
-                }
-                else if (padding == 8) {
-                    return createPadding<8>(padding);
-                }
-                else if (padding == 12) {
-                    return createPadding<12>(padding);
-                }
-                else {
-                    throw std::runtime_error("Unsupported padding size.");
-                }
-            }
+            std::unordered_map<std::string, uint32_t, NameHash, std::equal_to<>> nameIndex_;
+            std::vector<uint8_t> hostData_;
+            UniformStorage storage_;
         };
     }
 }
@@ -0,0 +1,229 @@
+#pragma once
+
+#include <glm/glm.hpp>
+#include <array>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <utility>
+
+namespace WGPU::Buffer {
+
+    /*============================================================
+    * UNIFORM TRAITS
+    =============================================================*/
+    /**
+     * @brief Identifies a WGSL type that can live in a uniform block.
+     */
+    enum class UniformKind : uint8_t {
+        F32,
+        I32,
+        U32,
+        Vec2,
+        Vec3,
+        Vec4,
+        Mat4
+    };
+
+    /**
+     * @struct UniformTraits
+     * @brief WGSL size and alignment (AlignOf / SizeOf) of a host type used in a uniform block.
+     *
+     * Only specialised for types with a one-to-one WGSL equivalent, so using anything
+     * else inside a uniform block fails to compile.
+     */
+    template <typename T>
+    struct UniformTraits;
+
+    template <> struct UniformTraits<float>     { static constexpr size_t Size = 4;  static constexpr size_t Alignment = 4;  static constexpr UniformKind Kind = UniformKind::F32; };
+    template <> struct UniformTraits<int32_t>   { static constexpr size_t Size = 4;  static constexpr size_t Alignment = 4;  static constexpr UniformKind Kind = UniformKind::I32; };
+    template <> struct UniformTraits<uint32_t>  { static constexpr size_t Size = 4;  static constexpr size_t Alignment = 4;  static constexpr UniformKind Kind = UniformKind::U32; };
+    template <> struct UniformTraits<glm::vec2> { static constexpr size_t Size = 8;  static constexpr size_t Alignment = 8;  static constexpr UniformKind Kind = UniformKind::Vec2; };
+    template <> struct UniformTraits<glm::vec3> { static constexpr size_t Size = 12; static constexpr size_t Alignment = 16; static constexpr UniformKind Kind = UniformKind::Vec3; };
+    template <> struct UniformTraits<glm::vec4> { static constexpr size_t Size = 16; static constexpr size_t Alignment = 16; static constexpr UniformKind Kind = UniformKind::Vec4; };
+    template <> struct UniformTraits<glm::mat4> { static constexpr size_t Size = 64; static constexpr size_t Alignment = 16; static constexpr UniformKind Kind = UniformKind::Mat4; };
+
+    /**
+     * @brief Satisfied by every host type with a WGSL uniform equivalent whose
+     * in-memory representation is the tightly packed WGSL one.
+     */
+    template <typename T>
+    concept UniformType = requires {
+        UniformTraits<T>::Size;
+        UniformTraits<T>::Alignment;
+    } && std::is_trivially_copyable_v<T> && sizeof(T) == UniformTraits<T>::Size;
+
+    constexpr size_t AlignUp(size_t value, size_t alignment) {
+        return (value + alignment - 1) / alignment * alignment;
+    }
+
+    /*============================================================
+    * UNIFORM LAYOUT
+    =============================================================*/
+    template <typename... Ts>
+    struct TypeList {};
+
+    /**
+     * @struct UniformLayout
+     * @brief WGSL struct layout of an ordered list of members, computed at compile time.
+     *
+     * Offsets follow the WGSL rule offset(i) = roundUp(AlignOf(Ti), end(i - 1)) and the
+     * struct size is rounded up to the largest member alignment.
+     */
+    template <typename List>
+    struct UniformLayout;
+
+    template <UniformType... Ts>
+    struct UniformLayout<TypeList<Ts...>> {
+        static constexpr size_t Count = sizeof...(Ts);
+
+        static constexpr size_t Alignment = [] {
+            size_t alignment = 4;
+            ((alignment = UniformTraits<Ts>::Alignment > alignment ? UniformTraits<Ts>::Alignment : alignment), ...);
+            return alignment;
+        }();
+
+        static constexpr std::array<UniformKind, Count> Kinds = { UniformTraits<Ts>::Kind... };
+
+        static constexpr std::array<size_t, Count> Offsets = [] {
+            std::array<size_t, Count> offsets{};
+            size_t cursor = 0;
+            size_t index = 0;
+            ((offsets[index] = AlignUp(cursor, UniformTraits<Ts>::Alignment),
+              cursor = offsets[index] + UniformTraits<Ts>::Size,
+              ++index), ...);
+            return offsets;
+        }();
+
+        static constexpr size_t Size = [] {
+            size_t end = 0;
+            size_t index = 0;
+            ((end = Offsets[index++] + UniformTraits<Ts>::Size), ...);
+            return AlignUp(end, Alignment);
+        }();
+    };
+
+    /*============================================================
+    * STRUCT REFLECTION
+    =============================================================*/
+    namespace Detail {
+        // Converts to any member type; only used in unevaluated aggregate initialisation.
+        struct AnyField {
+            template <typename U>
+            constexpr operator U() const noexcept;
+        };
+
+        template <typename T, size_t... I>
+        constexpr bool isBraceConstructible(std::index_sequence<I...>) {
+            return requires { T{ (void(I), AnyField{})... }; };
+        }
+
+        inline constexpr size_t MaxFields = 12;
+
+        template <typename T, size_t N = MaxFields>
+        constexpr size_t fieldCount() {
+            if constexpr (N == 0) {
+                return 0;
+            }
+            else if constexpr (isBraceConstructible<T>(std::make_index_sequence<N>{})) {
+                return N;
+            }
+            else {
+                return fieldCount<T, N - 1>();
+            }
+        }
+
+        struct CollectFieldTypes {
+            template <typename... Fields>
+            constexpr TypeList<std::remove_cvref_t<Fields>...> operator()(Fields&...) const { return {}; }
+        };
+
+        // Brace initialisation also accepts fewer initialisers than members, so a struct
+        // with more members than the visitor can bind has to be caught explicitly
+        template <typename T>
+        constexpr size_t checkedFieldCount() {
+            static_assert(!isBraceConstructible<T>(std::make_index_sequence<MaxFields + 1>{}),
+                "Uniform block struct has more than 12 members; split it or group members into a vec4/mat4.");
+            return fieldCount<T>();
+        }
+    }
+
+    /**
+     * @brief Number of members of an aggregate, up to 12. Fails to compile for more.
+     */
+    template <typename T>
+    inline constexpr size_t FieldCount = Detail::checkedFieldCount<T>();
+
+    /**
+     * @brief Invokes visitor with a reference to every member of the aggregate, in declaration order.
+     */
+    template <typename T, typename Visitor>
+    constexpr decltype(auto) ApplyFields(T& object, Visitor&& visitor) {
+        constexpr size_t count = FieldCount<std::remove_const_t<T>>;
+        static_assert(count > 0, "Uniform block struct must have at least one member.");
+        static_assert(count <= Detail::MaxFields, "Uniform block struct supports at most 12 members.");
+
+        if constexpr (count == 1) { auto& [a] = object; return visitor(a); }
+        else if constexpr (count == 2) { auto& [a, b] = object; return visitor(a, b); }
+        else if constexpr (count == 3) { auto& [a, b, c] = object; return visitor(a, b, c); }
+        else if constexpr (count == 4) { auto& [a, b, c, d] = object; return visitor(a, b, c, d); }
+        else if constexpr (count == 5) { auto& [a, b, c, d, e] = object; return visitor(a, b, c, d, e); }
+        else if constexpr (count == 6) { auto& [a, b, c, d, e, f] = object; return visitor(a, b, c, d, e, f); }
+        else if constexpr (count == 7) { auto& [a, b, c, d, e, f, g] = object; return visitor(a, b, c, d, e, f, g); }
+        else if constexpr (count == 8) { auto& [a, b, c, d, e, f, g, h] = object; return visitor(a, b, c, d, e, f, g, h); }
+        else if constexpr (count == 9) { auto& [a, b, c, d, e, f, g, h, i] = object; return visitor(a, b, c, d, e, f, g, h, i); }
+        else if constexpr (count == 10) { auto& [a, b, c, d, e, f, g, h, i, j] = object; return visitor(a, b, c, d, e, f, g, h, i, j); }
+        else if constexpr (count == 11) { auto& [a, b, c, d, e, f, g, h, i, j, k] = object; return visitor(a, b, c, d, e, f, g, h, i, j, k); }
+        else { auto& [a, b, c, d, e, f, g, h, i, j, k, l] = object; return visitor(a, b, c, d, e, f, g, h, i, j, k, l); }
+    }
+
+    /**
+     * @brief Member types of an aggregate, in declaration order.
+     */
+    template <typename T>
+    using FieldTypes = decltype(ApplyFields(std::declval<T&>(), Detail::CollectFieldTypes{}));
+
+    /**
+     * @brief WGSL layout of a plain C++ struct, derived from its member types.
+     */
+    template <typename T>
+    using UniformLayoutOf = UniformLayout<FieldTypes<T>>;
+
+    /**
+     * @brief Satisfied by a struct that lists its member offsets for the compile-time layout
+     * check, in declaration order:
+     *
+     * @code
+     * static constexpr std::array<size_t, 2> MemberOffsets() {
+     *     return { offsetof(QuadUniforms, time), offsetof(QuadUniforms, position) };
+     * }
+     * @endcode
+     *
+     * Member offsets cannot be read in a constant expression without naming the members,
+     * so the struct has to name them once with offsetof.
+     */
+    template <typename T>
+    concept DeclaresMemberOffsets = requires {
+        { T::MemberOffsets() } -> std::convertible_to<std::array<size_t, FieldCount<T>>>;
+    };
+
+    namespace Detail {
+        template <typename T>
+        constexpr bool memberOffsetsAscend() {
+            constexpr std::array<size_t, FieldCount<T>> offsets = T::MemberOffsets();
+            for (size_t i = 1; i < offsets.size(); ++i) {
+                if (offsets[i] <= offsets[i - 1]) {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        template <typename T>
+        constexpr bool memberOffsetsMatchLayout() {
+            constexpr std::array<size_t, FieldCount<T>> offsets = T::MemberOffsets();
+            return offsets == UniformLayoutOf<T>::Offsets;
+        }
+    }
+}
@@ -0,0 +1,84 @@
+#include "UniformRing.h"
+
+#include "ReleaseHook.h"
+
+WGPU::Buffer::UniformRing::UniformRing(size_t bindingSize, size_t slicesPerFrame, uint32_t framesInFlight) :
+	bindingSize_(bindingSize),
+	framesInFlight_(framesInFlight > 0 ? framesInFlight : 1)
+{
+	if (!Core::Device()) {
+		throw std::runtime_error("WebGPU device not initialized.");
+	}
+
+	// Every dynamic offset has to be a multiple of minUniformBufferOffsetAlignment
+	size_t alignment = Core::Limits().minUniformBufferOffsetAlignment;
+	if (alignment == 0) {
+		alignment = 256; // WebGPU default limit
+	}
+	stride_ = AlignUp(bindingSize_, alignment);
+	frameSize_ = stride_ * (slicesPerFrame > 0 ? slicesPerFrame : 1);
+	hostData_.resize(frameSize_, 0);
+
+	WGPUBufferDescriptor bufferDesc = {};
+	bufferDesc.nextInChain = nullptr;
+	bufferDesc.label = "Uniform ring";
+	bufferDesc.size = frameSize_ * framesInFlight_;
+	bufferDesc.usage = WGPUBufferUsage_Uniform | WGPUBufferUsage_CopyDst;
+	bufferDesc.mappedAtCreation = false;
+	buffer_ = wgpuDeviceCreateBuffer(Core::Device(), &bufferDesc);
+	if (!buffer_) {
+		throw std::runtime_error("Failed to create uniform ring buffer.");
+	}
+}
+
+WGPU::Buffer::UniformRing::~UniformRing()
+{
+	if (buffer_) {
+		std::cout << "WGPU::Buffer::UniformRing::~UniformRing - Releasing uniform ring..." << std::endl;
+		ReleaseHook::Notify(buffer_);
+		wgpuBufferRelease(buffer_);
+		buffer_ = nullptr;
+	}
+}
+
+void WGPU::Buffer::UniformRing::BeginFrame()
+{
+	frameIndex_ = (frameIndex_ + 1) % framesInFlight_;
+	cursor_ = 0;
+	flushed_ = 0;
+}
+
+uint32_t WGPU::Buffer::UniformRing::Allocate(const void* data, size_t size)
+{
+	if (size > bindingSize_) {
+		throw std::invalid_argument("Uniform slice is larger than the ring binding size.");
+	}
+	if (cursor_ + stride_ > frameSize_) {
+		throw std::length_error("Uniform ring frame region is full.");
+	}
+
+	const size_t local = cursor_;
+	std::memcpy(hostData_.data() + local, data, size);
+	cursor_ += stride_;
+
+	return static_cast<uint32_t>(frameSize_ * frameIndex_ + local);
+}
+
+void WGPU::Buffer::UniformRing::Flush()
+{
+	if (cursor_ == flushed_) {
+		return; // Nothing allocated since the last flush
+	}
+
+	// Slices allocated after a previous flush in the same frame go up on their own
+	const size_t size = cursor_ - flushed_;
+	wgpuQueueWriteBuffer(
+		Core::Queue(),
+		buffer_,
+		frameSize_ * frameIndex_ + flushed_,
+		hostData_.data() + flushed_,
+		size
+	);
+	UniformUploads::Record(size);
+	flushed_ = cursor_;
+}
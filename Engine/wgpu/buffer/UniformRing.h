@@ -0,0 +1,83 @@
+#pragma once
+
+#include <webgpu/webgpu.h>
+#include <core/Core.h>
+#include <vector>
+#include <stdexcept>
+#include <iostream>
+#include <cstring>
+
+#include "UniformLayout.h"
+#include "UploadStats.h"
+
+namespace WGPU::Buffer {
+
+	/**
+	 * @class UniformRing
+	 * @brief Per-frame uniform ring that hands out aligned slices addressed by dynamic offsets.
+	 *
+	 * One GPU buffer is split into framesInFlight regions. Each frame writes its per-draw
+	 * uniforms into the next region, then Flush() uploads the used part of that region with
+	 * a single queue write. A pipeline built with a dynamic-offset uniform binding can bind
+	 * the ring once and select each draw's slice through the dynamic offset passed to
+	 * wgpuRenderPassEncoderSetBindGroup.
+	 */
+	class UniformRing {
+	public:
+		/**
+		 * @param bindingSize Size of one slice as seen by the shader (the WGSL struct size).
+		 * @param slicesPerFrame Maximum number of slices handed out in a single frame.
+		 * @param framesInFlight Number of frame regions the ring cycles through.
+		 */
+		UniformRing(size_t bindingSize, size_t slicesPerFrame, uint32_t framesInFlight = 2);
+		~UniformRing();
+
+		UniformRing(const UniformRing&) = delete;
+		UniformRing& operator=(const UniformRing&) = delete;
+
+		/*============================================================
+		* PUBLIC
+		=============================================================*/
+
+		/**
+		 * @brief Moves to the next frame region and forgets the slices of the previous use of it.
+		 */
+		void BeginFrame();
+
+		/**
+		 * @brief Copies one slice into the current frame region.
+		 *
+		 * @return The dynamic offset to pass to SetBindGroup for this slice.
+		 * @throws std::length_error If the frame region is full.
+		 */
+		uint32_t Allocate(const void* data, size_t size);
+
+		template <typename T>
+		uint32_t Push(const T& value) {
+			static_assert(std::is_trivially_copyable_v<T>, "Uniform slices must be trivially copyable.");
+			return Allocate(&value, sizeof(T));
+		}
+
+		/**
+		 * @brief Uploads every slice allocated this frame with a single queue write.
+		 */
+		void Flush();
+
+		WGPUBuffer Get() const { return buffer_; }
+		size_t GetBindingSize() const { return bindingSize_; }
+		size_t GetStride() const { return stride_; }
+		uint32_t GetFrameIndex() const { return frameIndex_; }
+		size_t GetSliceCount() const { return cursor_ / stride_; }
+	private:
+		WGPUBuffer buffer_ = nullptr;
+		std::vector<uint8_t> hostData_;
+
+		size_t bindingSize_ = 0;
+		size_t stride_ = 0;
+		size_t frameSize_ = 0;
+		uint32_t framesInFlight_ = 0;
+		uint32_t frameIndex_ = 0;
+		size_t cursor_ = 0;
+		size_t flushed_ = 0;
+	};
+}
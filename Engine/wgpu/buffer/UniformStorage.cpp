@@ -0,0 +1,76 @@
+#include "UniformStorage.h"
+
+#include "ReleaseHook.h"
+#include "UniformLayout.h"
+#include "UploadStats.h"
+
+#include <core/Core.h>
+#include <iostream>
+#include <stdexcept>
+
+WGPU::Buffer::UniformStorage::~UniformStorage()
+{
+    if (buffer_) {
+        std::cout << "WGPU::Buffer::UniformStorage::~UniformStorage - Releasing uniform buffer..." << std::endl;
+        release();
+    }
+}
+
+void WGPU::Buffer::UniformStorage::Write(std::span<const std::byte> mirror, StagingBelt* stagingBelt)
+{
+    if (!Core::Device() || !Core::Queue()) {
+        throw std::runtime_error("WebGPU device or queue not initialized.");
+    }
+
+    if (mirror.empty()) {
+        return; // No data to write
+    }
+
+    if (!buffer_ || bufferSize_ != mirror.size()) {
+        release();
+
+        WGPUBufferDescriptor bufferDesc = {};
+        bufferDesc.nextInChain = nullptr;
+        bufferDesc.size = mirror.size();
+        bufferDesc.usage = WGPUBufferUsage_Uniform | WGPUBufferUsage_CopyDst;
+        bufferDesc.mappedAtCreation = false;
+
+        buffer_ = wgpuDeviceCreateBuffer(Core::Device(), &bufferDesc);
+        if (!buffer_) {
+            throw std::runtime_error("Failed to create uniform buffer.");
+        }
+        bufferSize_ = mirror.size();
+
+        // A fresh buffer holds nothing yet, so everything has to go up
+        MarkDirty(0, mirror.size());
+    }
+
+    if (!IsDirty()) {
+        return; // Nothing changed since the last write
+    }
+
+    // Queue writes and belt copies must be 4-byte aligned; every WGSL member already is,
+    // and the mirror is padded to its struct alignment
+    const size_t begin = dirtyBegin_ / 4 * 4;
+    const size_t end = AlignUp(dirtyEnd_ < mirror.size() ? dirtyEnd_ : mirror.size(), 4);
+    if (stagingBelt) {
+        stagingBelt->WriteBuffer(buffer_, begin, mirror.data() + begin, end - begin);
+    }
+    else {
+        wgpuQueueWriteBuffer(Core::Queue(), buffer_, begin, mirror.data() + begin, end - begin);
+    }
+    UniformUploads::Record(end - begin);
+
+    dirtyBegin_ = SIZE_MAX;
+    dirtyEnd_ = 0;
+}
+
+void WGPU::Buffer::UniformStorage::release()
+{
+    if (buffer_) {
+        ReleaseHook::Notify(buffer_);
+        wgpuBufferRelease(buffer_);
+        buffer_ = nullptr;
+        bufferSize_ = 0;
+    }
+}
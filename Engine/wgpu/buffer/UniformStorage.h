@@ -0,0 +1,67 @@
+#pragma once
+
+#include <webgpu/webgpu.h>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+#include "StagingBelt.h"
+
+namespace WGPU::Buffer {
+
+    /**
+     * @class UniformStorage
+     * @brief The GPU side shared by UniformBlock and UniformBuffer: the uniform buffer, the
+     * dirty byte range and the upload of that range.
+     *
+     * The host mirror stays with the owner, since UniformBlock's is the typed struct itself
+     * and UniformBuffer's is a byte vector that grows with Add(); Write() is handed the
+     * mirror and (re)creates the buffer whenever its size changed.
+     */
+    class UniformStorage {
+    public:
+        UniformStorage() = default;
+        ~UniformStorage();
+
+        UniformStorage(const UniformStorage&) = delete;
+        UniformStorage& operator=(const UniformStorage&) = delete;
+
+        /*============================================================
+        * PUBLIC
+        =============================================================*/
+
+        WGPUBuffer Get() const { return buffer_; }
+
+        /**
+         * @brief Grows the dirty range to cover [offset, offset + size).
+         */
+        void MarkDirty(size_t offset, size_t size) {
+            dirtyBegin_ = offset < dirtyBegin_ ? offset : dirtyBegin_;
+            dirtyEnd_ = offset + size > dirtyEnd_ ? offset + size : dirtyEnd_;
+        }
+
+        bool IsDirty() const { return dirtyBegin_ < dirtyEnd_; }
+
+        /**
+         * @brief Uploads the dirty range of mirror with a single write, creating the buffer
+         * on first use and recreating it when the mirror changed size. Does nothing when
+         * the mirror is empty or clean.
+         *
+         * @param stagingBelt When set, the range is staged on the belt and copied with the
+         * belt's next submit instead of being written through the queue.
+         *
+         * @throws std::runtime_error If the WebGPU device or queue is not initialized, or if
+         * the uniform buffer creation fails.
+         */
+        void Write(std::span<const std::byte> mirror, StagingBelt* stagingBelt = nullptr);
+    private:
+        WGPUBuffer buffer_ = nullptr;
+        size_t bufferSize_ = 0;
+
+        // Merged byte range [dirtyBegin_, dirtyEnd_) changed since the last Write()
+        size_t dirtyBegin_ = SIZE_MAX;
+        size_t dirtyEnd_ = 0;
+
+        void release();
+    };
+}
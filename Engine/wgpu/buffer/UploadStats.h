@@ -0,0 +1,40 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace WGPU::Buffer {
+	/**
+	 * @struct UploadStats
+	 * @brief Bytes and queue writes issued by uniform uploads.
+	 */
+	struct UploadStats {
+		uint64_t bytes = 0;
+		uint32_t calls = 0;
+	};
+
+	/**
+	 * @class UniformUploads
+	 * @brief Per-frame counters shared by every UniformBuffer and UniformBlock.
+	 *
+	 * EndFrame() reads the totals and starts counting again. FrameContext::EndFrame() calls
+	 * it once per frame; read the result through FrameContext::GetLastUniformUploads().
+	 */
+	class UniformUploads {
+	public:
+		static void Record(size_t bytes) {
+			frame_.bytes += bytes;
+			++frame_.calls;
+		}
+
+		static const UploadStats& Frame() { return frame_; }
+
+		static UploadStats EndFrame() {
+			UploadStats stats = frame_;
+			frame_ = {};
+			return stats;
+		}
+	private:
+		inline static UploadStats frame_{};
+	};
+}
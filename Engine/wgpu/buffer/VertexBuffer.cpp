@@ -1,26 +1,71 @@
 #include "VertexBuffer.h"
 #include "core/Core.h"
+#include "UniformLayout.h"
+
+#include <cstring>
 
 WGPU::Buffer::VertexBuffer::VertexBuffer(
-    std::vector<float> vertices,
+    std::span<const std::byte> vertices,
+    uint64_t stride,
+    WGPUDevice device,
+    WGPUQueue queue,
+    StagingBelt* stagingBelt
+):
+    vertexCount_(0),
+    stride_(stride)
+{
+    if (stride_ == 0 || vertices.size() % stride_ != 0) {
+        throw std::invalid_argument("Vertex data is not a whole number of vertices.");
+    }
+    vertexCount_ = static_cast<int>(vertices.size() / stride_);
+    upload(vertices, device, queue, stagingBelt);
+}
+
+WGPU::Buffer::VertexBuffer::VertexBuffer(
+    std::span<const float> vertices,
 	unsigned int vertexCount,
     WGPUDevice device,
-    WGPUQueue queue
+    WGPUQueue queue,
+    StagingBelt* stagingBelt
 ):
-    vertexCount_(vertexCount)
+    vertexCount_(vertexCount),
+    stride_(vertexCount > 0 ? vertices.size_bytes() / vertexCount : 0)
+{
+    upload(std::as_bytes(vertices), device, queue, stagingBelt);
+}
+
+WGPU::Buffer::VertexBuffer::~VertexBuffer()
+{
+    std::cout << "Releasing vertex buffer" << std::endl;
+    wgpuBufferRelease(vertexBuffer_);
+}
+
+void WGPU::Buffer::VertexBuffer::upload(std::span<const std::byte> vertices, WGPUDevice device, WGPUQueue queue, StagingBelt* stagingBelt)
 {
     WGPUBufferDescriptor bufferDesc{};
     bufferDesc.nextInChain = nullptr;
-    bufferDesc.size = vertices.size() * sizeof(float);
+    bufferDesc.size = AlignUp(vertices.size(), 4); // Copies must be a multiple of 4 bytes
     bufferDesc.usage = WGPUBufferUsage_CopyDst | WGPUBufferUsage_Vertex;
     bufferDesc.mappedAtCreation = false;
     vertexBuffer_ = wgpuDeviceCreateBuffer(device, &bufferDesc);
 
-    wgpuQueueWriteBuffer(queue, vertexBuffer_, 0, vertices.data(), bufferDesc.size);
-}
+    auto write = [&](uint64_t offset, const void* data, size_t size) {
+        if (stagingBelt) {
+            stagingBelt->WriteBuffer(vertexBuffer_, offset, data, size);
+        }
+        else {
+            wgpuQueueWriteBuffer(queue, vertexBuffer_, offset, data, size);
+        }
+    };
 
-WGPU::Buffer::VertexBuffer::~VertexBuffer()
-{
-    std::cout << "Releasing vertex buffer" << std::endl;
-    wgpuBufferRelease(vertexBuffer_);
+    // Whole words straight from the caller's memory; a partial trailing word goes up padded
+    const size_t wholeBytes = vertices.size() & ~size_t{ 3 };
+    if (wholeBytes > 0) {
+        write(0, vertices.data(), wholeBytes);
+    }
+    if (wholeBytes < vertices.size()) {
+        std::byte tail[4] = {};
+        std::memcpy(tail, vertices.data() + wholeBytes, vertices.size() - wholeBytes);
+        write(wholeBytes, tail, sizeof(tail));
+    }
 }
@@ -1,22 +1,66 @@
 #pragma once
 
 #include <webgpu/webgpu.h>
+#include <memory>
+#include <ranges>
+#include <span>
+#include <stdexcept>
 #include <vector>
 #include <iostream>
 
+#include "StagingBelt.h"
+#include "VertexLayout.h"
+
 namespace WGPU::Buffer{
 	class VertexBuffer {
 	public:
+		/**
+		 * Uploads vertices straight from the caller's memory; nothing is copied on the host
+		 * unless a staging belt is given, which copies once into its mapped chunk.
+		 *
+		 * @param vertices Raw vertex bytes, a whole number of stride each.
+		 * @param stride Size of one vertex in bytes.
+		 */
+		VertexBuffer(
+			std::span<const std::byte> vertices,
+			uint64_t stride,
+			WGPUDevice device,
+			WGPUQueue queue,
+			StagingBelt* stagingBelt = nullptr
+		);
+
 		VertexBuffer(
-			std::vector<float> vertices,
+			std::span<const float> vertices,
 			unsigned int vertexCount,
 			WGPUDevice device,
-			WGPUQueue queue
+			WGPUQueue queue,
+			StagingBelt* stagingBelt = nullptr
 		);
 		~VertexBuffer();
+
+		/**
+		 * Creates a buffer whose stride comes from a VertexLayout, so the vertex count is
+		 * derived from the data rather than passed alongside it.
+		 *
+		 * @code
+		 * auto vb = WGPU::Buffer::VertexBuffer::Create<Quad2DPipeline::VertexLayout>(quad.Vertices, Core::Device(), Core::Queue());
+		 * @endcode
+		 */
+		template <typename Layout, std::ranges::contiguous_range R>
+		static std::unique_ptr<VertexBuffer> Create(const R& vertices, WGPUDevice device, WGPUQueue queue, StagingBelt* stagingBelt = nullptr) {
+			using T = std::ranges::range_value_t<R>;
+			const auto bytes = std::as_bytes(std::span<const T>(std::ranges::data(vertices), std::ranges::size(vertices)));
+			return std::make_unique<VertexBuffer>(bytes, Layout::Stride, device, queue, stagingBelt);
+		}
+
 		WGPUBuffer GetBuffer() const { return vertexBuffer_; }
+		uint32_t GetVertexCount() const { return static_cast<uint32_t>(vertexCount_); }
+		uint64_t GetStride() const { return stride_; }
 	private:
 		WGPUBuffer vertexBuffer_;
 		int vertexCount_;
+		uint64_t stride_ = 0;
+
+		void upload(std::span<const std::byte> vertices, WGPUDevice device, WGPUQueue queue, StagingBelt* stagingBelt);
 	};
-}
\ No newline at end of file
+}
@@ -0,0 +1,153 @@
+#pragma once
+
+#include <webgpu/webgpu.h>
+#include <glm/glm.hpp>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+namespace WGPU::Buffer {
+
+	/*============================================================
+	* VERTEX FORMATS
+	=============================================================*/
+	/**
+	 * @brief Which vertex formats a pipeline is created for. Quantized pipelines read
+	 * 16-bit and 8-bit attributes packed by the routines in VertexPacking.h.
+	 */
+	enum class VertexEncoding : uint8_t {
+		Float32,
+		Quantized
+	};
+
+	/**
+	 * @brief Size in bytes of one attribute of the given format.
+	 */
+	constexpr uint64_t VertexFormatSize(WGPUVertexFormat format) {
+		switch (format) {
+		case WGPUVertexFormat_Uint8x2: case WGPUVertexFormat_Sint8x2:
+		case WGPUVertexFormat_Unorm8x2: case WGPUVertexFormat_Snorm8x2:
+			return 2;
+		case WGPUVertexFormat_Uint8x4: case WGPUVertexFormat_Sint8x4:
+		case WGPUVertexFormat_Unorm8x4: case WGPUVertexFormat_Snorm8x4:
+		case WGPUVertexFormat_Uint16x2: case WGPUVertexFormat_Sint16x2:
+		case WGPUVertexFormat_Unorm16x2: case WGPUVertexFormat_Snorm16x2:
+		case WGPUVertexFormat_Float16x2:
+		case WGPUVertexFormat_Float32: case WGPUVertexFormat_Uint32: case WGPUVertexFormat_Sint32:
+			return 4;
+		case WGPUVertexFormat_Uint16x4: case WGPUVertexFormat_Sint16x4:
+		case WGPUVertexFormat_Unorm16x4: case WGPUVertexFormat_Snorm16x4:
+		case WGPUVertexFormat_Float16x4:
+		case WGPUVertexFormat_Float32x2: case WGPUVertexFormat_Uint32x2: case WGPUVertexFormat_Sint32x2:
+			return 8;
+		case WGPUVertexFormat_Float32x3: case WGPUVertexFormat_Uint32x3: case WGPUVertexFormat_Sint32x3:
+			return 12;
+		case WGPUVertexFormat_Float32x4: case WGPUVertexFormat_Uint32x4: case WGPUVertexFormat_Sint32x4:
+			return 16;
+		default:
+			return 0;
+		}
+	}
+
+	/**
+	 * @struct VertexAttr
+	 * @brief An attribute given by its WebGPU format, for formats with no single host type
+	 * (e.g. VertexAttr<WGPUVertexFormat_Unorm8x4> for a packed colour).
+	 */
+	template <WGPUVertexFormat F>
+	struct VertexAttr {
+		static_assert(VertexFormatSize(F) > 0, "Unsupported vertex format.");
+		static constexpr bool IsAttribute = true;
+		static constexpr WGPUVertexFormat Format = F;
+		static constexpr uint64_t Size = VertexFormatSize(F);
+	};
+
+	/**
+	 * @struct VertexPad
+	 * @brief Unused bytes inside a vertex, e.g. explicit padding in an instance struct.
+	 */
+	template <uint64_t Bytes>
+	struct VertexPad {
+		static constexpr bool IsAttribute = false;
+		static constexpr WGPUVertexFormat Format = WGPUVertexFormat_Undefined;
+		static constexpr uint64_t Size = Bytes;
+	};
+
+	/**
+	 * @brief Maps a layout element to its VertexAttr / VertexPad description. Host types
+	 * with an obvious format can be named directly.
+	 */
+	template <typename T> struct VertexElement : T {};
+	template <> struct VertexElement<float> : VertexAttr<WGPUVertexFormat_Float32> {};
+	template <> struct VertexElement<glm::vec2> : VertexAttr<WGPUVertexFormat_Float32x2> {};
+	template <> struct VertexElement<glm::vec3> : VertexAttr<WGPUVertexFormat_Float32x3> {};
+	template <> struct VertexElement<glm::vec4> : VertexAttr<WGPUVertexFormat_Float32x4> {};
+	template <> struct VertexElement<uint32_t> : VertexAttr<WGPUVertexFormat_Uint32> {};
+	template <> struct VertexElement<int32_t> : VertexAttr<WGPUVertexFormat_Sint32> {};
+
+	/*============================================================
+	* VERTEX LAYOUT
+	=============================================================*/
+	/**
+	 * @struct VertexLayout
+	 * @brief Compile-time description of one vertex buffer: element order, offsets and stride.
+	 *
+	 * Elements are packed in declaration order with no implicit padding. The same type
+	 * feeds the buffers (stride and vertex count) and the pipeline (attributes), so the two
+	 * cannot drift apart:
+	 *
+	 * @code
+	 * using QuadLayout = WGPU::Buffer::VertexLayout<glm::vec2, glm::vec2>; // position, uv
+	 * auto attributes = QuadLayout::Attributes();         // locations 0 and 1
+	 * auto layout = QuadLayout::BufferLayout(attributes.data());
+	 * @endcode
+	 */
+	template <typename... Elements>
+	struct VertexLayout {
+		static constexpr size_t AttributeCount = (size_t{ VertexElement<Elements>::IsAttribute } + ... + 0);
+		static constexpr uint64_t Stride = (VertexElement<Elements>::Size + ... + 0);
+
+		static constexpr std::array<WGPUVertexFormat, AttributeCount> Formats = [] {
+			std::array<WGPUVertexFormat, AttributeCount> formats{};
+			size_t index = 0;
+			((VertexElement<Elements>::IsAttribute ? void(formats[index++] = VertexElement<Elements>::Format) : void()), ...);
+			return formats;
+		}();
+
+		static constexpr std::array<uint64_t, AttributeCount> Offsets = [] {
+			std::array<uint64_t, AttributeCount> offsets{};
+			size_t index = 0;
+			uint64_t cursor = 0;
+			((VertexElement<Elements>::IsAttribute ? void(offsets[index++] = cursor) : void(), cursor += VertexElement<Elements>::Size), ...);
+			return offsets;
+		}();
+
+		static_assert(Stride % 4 == 0, "Vertex stride must be a multiple of 4 bytes.");
+
+		/**
+		 * @brief The attribute array, numbering shader locations from firstLocation.
+		 */
+		static constexpr std::array<WGPUVertexAttribute, AttributeCount> Attributes(uint32_t firstLocation = 0) {
+			std::array<WGPUVertexAttribute, AttributeCount> attributes{};
+			for (size_t i = 0; i < AttributeCount; ++i) {
+				attributes[i].format = Formats[i];
+				attributes[i].offset = Offsets[i];
+				attributes[i].shaderLocation = firstLocation + static_cast<uint32_t>(i);
+			}
+			return attributes;
+		}
+
+		/**
+		 * @brief The buffer layout for a pipeline; attributes must come from Attributes()
+		 * and outlive the pipeline creation.
+		 */
+		static WGPUVertexBufferLayout BufferLayout(const WGPUVertexAttribute* attributes, WGPUVertexStepMode stepMode = WGPUVertexStepMode_Vertex) {
+			WGPUVertexBufferLayout layout = {};
+			layout.arrayStride = Stride;
+			layout.stepMode = stepMode;
+			layout.attributeCount = AttributeCount;
+			layout.attributes = attributes;
+			return layout;
+		}
+	};
+}
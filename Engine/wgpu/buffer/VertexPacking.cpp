@@ -0,0 +1,244 @@
+#include "VertexPacking.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define WGPU_PACK_SSE2 1
+#include <emmintrin.h>
+#if defined(__F16C__) || defined(__AVX2__)
+#define WGPU_PACK_F16C 1
+#include <immintrin.h>
+#endif
+#endif
+
+namespace {
+
+	/*============================================================
+	* FOUR-WIDE KERNELS
+	=============================================================*/
+	// Each kernel converts exactly four floats. The span routines run them over the bulk
+	// and pad the tail into a local block, so every kernel can assume a full vector.
+
+#if WGPU_PACK_SSE2
+	inline __m128i roundClamped(const float* in, float low, float high, float scale)
+	{
+		__m128 v = _mm_loadu_ps(in);
+		v = _mm_min_ps(_mm_max_ps(v, _mm_set1_ps(low)), _mm_set1_ps(high));
+		return _mm_cvtps_epi32(_mm_mul_ps(v, _mm_set1_ps(scale))); // round to nearest even
+	}
+
+	inline void unorm16x4(const float* in, uint16_t* out)
+	{
+		// SSE2 has no unsigned 32->16 pack; bias into the signed range and back
+		__m128i v = _mm_sub_epi32(roundClamped(in, 0.0f, 1.0f, 65535.0f), _mm_set1_epi32(32768));
+		v = _mm_xor_si128(_mm_packs_epi32(v, v), _mm_set1_epi16(static_cast<short>(0x8000)));
+		_mm_storel_epi64(reinterpret_cast<__m128i*>(out), v);
+	}
+
+	inline void snorm16x4(const float* in, int16_t* out)
+	{
+		const __m128i v = roundClamped(in, -1.0f, 1.0f, 32767.0f);
+		_mm_storel_epi64(reinterpret_cast<__m128i*>(out), _mm_packs_epi32(v, v));
+	}
+
+	inline void sint16x4(const float* in, int16_t* out)
+	{
+		// Clamp before converting: cvtps turns anything past INT32_MAX into INT32_MIN
+		const __m128i v = roundClamped(in, -32768.0f, 32767.0f, 1.0f);
+		_mm_storel_epi64(reinterpret_cast<__m128i*>(out), _mm_packs_epi32(v, v));
+	}
+
+	inline void unorm8x4(const float* in, uint8_t* out)
+	{
+		__m128i v = roundClamped(in, 0.0f, 1.0f, 255.0f);
+		v = _mm_packs_epi32(v, v);
+		v = _mm_packus_epi16(v, v);
+		const int32_t packed = _mm_cvtsi128_si32(v);
+		std::memcpy(out, &packed, 4);
+	}
+#else
+	inline float roundEven(float value)
+	{
+		return std::nearbyint(value); // default rounding mode is to nearest, ties to even
+	}
+
+	inline void unorm16x4(const float* in, uint16_t* out)
+	{
+		for (int i = 0; i < 4; ++i) {
+			out[i] = static_cast<uint16_t>(roundEven(std::clamp(in[i], 0.0f, 1.0f) * 65535.0f));
+		}
+	}
+
+	inline void snorm16x4(const float* in, int16_t* out)
+	{
+		for (int i = 0; i < 4; ++i) {
+			out[i] = static_cast<int16_t>(roundEven(std::clamp(in[i], -1.0f, 1.0f) * 32767.0f));
+		}
+	}
+
+	inline void sint16x4(const float* in, int16_t* out)
+	{
+		for (int i = 0; i < 4; ++i) {
+			out[i] = static_cast<int16_t>(std::clamp(roundEven(in[i]), -32768.0f, 32767.0f));
+		}
+	}
+
+	inline void unorm8x4(const float* in, uint8_t* out)
+	{
+		for (int i = 0; i < 4; ++i) {
+			out[i] = static_cast<uint8_t>(roundEven(std::clamp(in[i], 0.0f, 1.0f) * 255.0f));
+		}
+	}
+#endif
+
+#if WGPU_PACK_F16C
+	inline void halfx4(const float* in, uint16_t* out)
+	{
+		const __m128i v = _mm_cvtps_ph(_mm_loadu_ps(in), _MM_FROUND_TO_NEAREST_INT);
+		_mm_storel_epi64(reinterpret_cast<__m128i*>(out), v);
+	}
+#else
+	inline void halfx4(const float* in, uint16_t* out)
+	{
+		for (int i = 0; i < 4; ++i) {
+			out[i] = WGPU::Buffer::FloatToHalf(in[i]);
+		}
+	}
+#endif
+
+	template <typename Out, typename Kernel>
+	void packSpan(std::span<const float> values, std::span<Out> out, Kernel kernel)
+	{
+		const size_t count = std::min(values.size(), out.size());
+		size_t i = 0;
+		for (; i + 4 <= count; i += 4) {
+			kernel(values.data() + i, out.data() + i);
+		}
+		if (i < count) {
+			float tail[4] = {};
+			Out packed[4] = {};
+			std::copy(values.begin() + i, values.begin() + count, tail);
+			kernel(tail, packed);
+			std::copy(packed, packed + (count - i), out.begin() + i);
+		}
+	}
+}
+
+/*============================================================
+* PACK ROUTINES
+=============================================================*/
+
+void WGPU::Buffer::PackUnorm16(std::span<const float> values, std::span<uint16_t> out)
+{
+	packSpan(values, out, unorm16x4);
+}
+
+void WGPU::Buffer::PackSnorm16(std::span<const float> values, std::span<int16_t> out)
+{
+	packSpan(values, out, snorm16x4);
+}
+
+void WGPU::Buffer::PackSint16(std::span<const float> values, std::span<int16_t> out)
+{
+	packSpan(values, out, sint16x4);
+}
+
+void WGPU::Buffer::PackUnorm8(std::span<const float> values, std::span<uint8_t> out)
+{
+	packSpan(values, out, unorm8x4);
+}
+
+void WGPU::Buffer::PackHalf(std::span<const float> values, std::span<uint16_t> out)
+{
+	packSpan(values, out, halfx4);
+}
+
+uint16_t WGPU::Buffer::FloatToHalf(float value)
+{
+	uint32_t bits;
+	std::memcpy(&bits, &value, sizeof(bits));
+
+	const uint32_t sign = (bits >> 16) & 0x8000u;
+	const int32_t exponent = static_cast<int32_t>((bits >> 23) & 0xffu);
+	uint32_t mantissa = bits & 0x007fffffu;
+
+	if (exponent == 0xff) {
+		return static_cast<uint16_t>(sign | 0x7c00u | (mantissa ? 0x0200u : 0u)); // Inf / NaN
+	}
+
+	const int32_t halfExponent = exponent - 127 + 15;
+	if (halfExponent >= 0x1f) {
+		return static_cast<uint16_t>(sign | 0x7c00u); // Too large: infinity
+	}
+
+	if (halfExponent <= 0) {
+		// Subnormal half (or zero): shift the full significand down, rounding ties to even
+		if (halfExponent < -10) {
+			return static_cast<uint16_t>(sign);
+		}
+		mantissa |= 0x00800000u;
+		const uint32_t shift = static_cast<uint32_t>(14 - halfExponent);
+		uint32_t half = mantissa >> shift;
+		const uint32_t remainder = mantissa & ((1u << shift) - 1u);
+		const uint32_t halfway = 1u << (shift - 1u);
+		if (remainder > halfway || (remainder == halfway && (half & 1u))) {
+			++half;
+		}
+		return static_cast<uint16_t>(sign | half);
+	}
+
+	// A carry out of the mantissa bumps the exponent, which is the correct result (up to Inf)
+	uint32_t half = (static_cast<uint32_t>(halfExponent) << 10) | (mantissa >> 13);
+	const uint32_t remainder = mantissa & 0x1fffu;
+	if (remainder > 0x1000u || (remainder == 0x1000u && (half & 1u))) {
+		++half;
+	}
+	return static_cast<uint16_t>(sign | half);
+}
+
+void WGPU::Buffer::PackVertices2D(std::span<const float> positionUv, std::span<CompactVertex2D> out)
+{
+	const size_t count = std::min(positionUv.size() / 4, out.size());
+	for (size_t i = 0; i < count; ++i) {
+		const float* vertex = positionUv.data() + i * 4;
+		// Converting a full block and keeping half of it is cheaper than a scalar path
+		int16_t position[4];
+		uint16_t uv[4];
+		snorm16x4(vertex, position);
+		unorm16x4(vertex, uv);
+		out[i].position[0] = position[0];
+		out[i].position[1] = position[1];
+		out[i].uv[0] = uv[2];
+		out[i].uv[1] = uv[3];
+	}
+}
+
+void WGPU::Buffer::PackSpriteInstances(std::span<const SpriteInstance> sprites, std::span<CompactSpriteInstance> out)
+{
+	static_assert(offsetof(SpriteInstance, size) == offsetof(SpriteInstance, position) + 8, "position and size must be adjacent.");
+
+	const size_t count = std::min(sprites.size(), out.size());
+	for (size_t i = 0; i < count; ++i) {
+		const SpriteInstance& sprite = sprites[i];
+		CompactSpriteInstance& packed = out[i];
+
+		// position.xy and size.xy are one 16-byte block
+		const float* positionSize = &sprite.position.x;
+		int16_t position[4];
+		uint16_t sizeRotation[4];
+		const float halfInputs[4] = { positionSize[2], positionSize[3], sprite.rotation, static_cast<float>(sprite.layer) };
+		sint16x4(positionSize, position);
+		halfx4(halfInputs, sizeRotation);
+
+		packed.position[0] = position[0];
+		packed.position[1] = position[1];
+		packed.size[0] = sizeRotation[0];
+		packed.size[1] = sizeRotation[1];
+		packed.rotation[0] = sizeRotation[2];
+		packed.rotation[1] = sizeRotation[3];
+		unorm16x4(&sprite.uvRect.x, packed.uvRect);
+		unorm8x4(&sprite.tint.x, packed.tint);
+	}
+}
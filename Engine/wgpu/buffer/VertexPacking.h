@@ -0,0 +1,68 @@
+#pragma once
+
+#include <glm/glm.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+#include "SpriteInstance.h"
+#include "VertexLayout.h"
+
+namespace WGPU::Buffer {
+
+	/*============================================================
+	* COMPACT VERTICES
+	=============================================================*/
+	/**
+	 * @struct CompactVertex2D
+	 * @brief 8-byte counterpart of the position + UV float vertex (16 bytes).
+	 *
+	 * Positions are Snorm16 (unit quads live in [-1, 1]) and UVs Unorm16, which the
+	 * vertex fetch turns back into vec2f, so the shader is the same for both encodings.
+	 */
+	struct CompactVertex2D {
+		int16_t position[2];
+		uint16_t uv[2];
+	};
+
+	using CompactVertex2DLayout = VertexLayout<VertexAttr<WGPUVertexFormat_Snorm16x2>, VertexAttr<WGPUVertexFormat_Unorm16x2>>;
+	static_assert(CompactVertex2DLayout::Stride == sizeof(CompactVertex2D), "CompactVertex2D does not match its layout.");
+
+	/*============================================================
+	* PACK ROUTINES
+	=============================================================*/
+	// Each routine converts values.size() floats into the same number of outputs; out must
+	// be at least as long. SSE2 is used when available (F16C for halves), with a scalar
+	// fallback that rounds the same way (to nearest, ties to even).
+
+	/** @brief [0, 1] -> [0, 65535]; out of range values are clamped. */
+	void PackUnorm16(std::span<const float> values, std::span<uint16_t> out);
+
+	/** @brief [-1, 1] -> [-32767, 32767]; out of range values are clamped. */
+	void PackSnorm16(std::span<const float> values, std::span<int16_t> out);
+
+	/** @brief Rounds to the nearest integer, saturating to the int16 range. */
+	void PackSint16(std::span<const float> values, std::span<int16_t> out);
+
+	/** @brief [0, 1] -> [0, 255]; out of range values are clamped. */
+	void PackUnorm8(std::span<const float> values, std::span<uint8_t> out);
+
+	/** @brief IEEE binary16 conversion; overflow becomes infinity. */
+	void PackHalf(std::span<const float> values, std::span<uint16_t> out);
+
+	uint16_t FloatToHalf(float value);
+
+	/**
+	 * @brief Packs interleaved position + UV floats (4 per vertex) into CompactVertex2D.
+	 */
+	void PackVertices2D(std::span<const float> positionUv, std::span<CompactVertex2D> out);
+
+	/**
+	 * @brief Packs sprites into CompactSpriteInstance, 24 bytes each instead of 64.
+	 *
+	 * Positions are rounded to whole pixels, which also keeps pixel art on the grid. The
+	 * layer rides in the unused half of the rotation lane; half floats hold it exactly up
+	 * to 2048, past any array texture's layer limit.
+	 */
+	void PackSpriteInstances(std::span<const SpriteInstance> sprites, std::span<CompactSpriteInstance> out);
+}
@@ -0,0 +1,178 @@
+#include "BindGroupCache.h"
+
+#include <algorithm>
+#include <type_traits>
+
+#include <wgpu/buffer/ReleaseHook.h>
+
+namespace {
+	template <typename T>
+	void append(std::string& key, const T& value)
+	{
+		static_assert(std::is_trivially_copyable_v<T>, "Only plain values go into a key.");
+		key.append(reinterpret_cast<const char*>(&value), sizeof(T));
+	}
+}
+
+WGPU::Pipeline::BindGroupCache::BindGroup::~BindGroup()
+{
+	if (handle) {
+		wgpuBindGroupRelease(handle);
+		handle = nullptr;
+	}
+}
+
+// Buffers report their releases through the hook; nothing can be bound before the cache exists
+WGPU::Pipeline::BindGroupCache::BindGroupCache()
+{
+	Buffer::ReleaseHook::Set(&BindGroupCache::Invalidate);
+}
+
+WGPU::Pipeline::BindGroupCache::~BindGroupCache()
+{
+	Buffer::ReleaseHook::Set(nullptr);
+}
+
+WGPU::Pipeline::BindGroupCache::BindGroupRef WGPU::Pipeline::BindGroupCache::Acquire(WGPUBindGroupLayout layout, std::span<const WGPUBindGroupEntry> entries, const char* label)
+{
+	BindGroupCache& cache = retrieveInstance();
+	std::string key = keyOf(layout, entries);
+
+	std::lock_guard<std::mutex> lock(cache.mutex_);
+	auto found = cache.index_.find(key);
+	if (found != cache.index_.end()) {
+		cache.entries_.splice(cache.entries_.begin(), cache.entries_, found->second);
+		++cache.hits_;
+		return found->second->bindGroup;
+	}
+
+	WGPUBindGroupDescriptor desc{};
+	desc.nextInChain = nullptr;
+	desc.label = label ? label : "Cached bind group";
+	desc.layout = layout;
+	desc.entryCount = entries.size();
+	desc.entries = entries.data();
+
+	auto bindGroup = std::make_shared<BindGroup>();
+	bindGroup->handle = wgpuDeviceCreateBindGroup(Core::Device(), &desc);
+	if (!bindGroup->handle) {
+		throw std::runtime_error("BindGroupCache: failed to create bind group.");
+	}
+
+	Entry entry;
+	entry.key = key;
+	entry.bindGroup = bindGroup;
+	entry.resources.push_back(layout);
+	for (const WGPUBindGroupEntry& binding : entries) {
+		for (const void* resource : { static_cast<const void*>(binding.buffer), static_cast<const void*>(binding.textureView), static_cast<const void*>(binding.sampler) }) {
+			if (resource) {
+				entry.resources.push_back(resource);
+			}
+		}
+	}
+	for (const void* resource : entry.resources) {
+		++cache.bound_[resource];
+	}
+
+	cache.entries_.push_front(std::move(entry));
+	cache.index_.emplace(std::move(key), cache.entries_.begin());
+	++cache.misses_;
+	cache.evict();
+	return bindGroup;
+}
+
+void WGPU::Pipeline::BindGroupCache::Invalidate(const void* resource)
+{
+	BindGroupCache& cache = retrieveInstance();
+	std::lock_guard<std::mutex> lock(cache.mutex_);
+	if (!resource || !cache.bound_.contains(resource)) {
+		return; // The common case: released without ever being bound through the cache
+	}
+
+	for (auto entry = cache.entries_.begin(); entry != cache.entries_.end();) {
+		const auto next = std::next(entry);
+		if (std::find(entry->resources.begin(), entry->resources.end(), resource) != entry->resources.end()) {
+			cache.erase(entry);
+			++cache.invalidations_;
+		}
+		entry = next;
+	}
+}
+
+void WGPU::Pipeline::BindGroupCache::SetCapacity(size_t capacity)
+{
+	BindGroupCache& cache = retrieveInstance();
+	std::lock_guard<std::mutex> lock(cache.mutex_);
+	cache.capacity_ = capacity;
+	cache.evict();
+}
+
+void WGPU::Pipeline::BindGroupCache::Clear()
+{
+	BindGroupCache& cache = retrieveInstance();
+	std::lock_guard<std::mutex> lock(cache.mutex_);
+	cache.index_.clear();
+	cache.bound_.clear();
+	cache.entries_.clear();
+}
+
+WGPU::Pipeline::BindGroupCache::Stats WGPU::Pipeline::BindGroupCache::GetStats()
+{
+	BindGroupCache& cache = retrieveInstance();
+	std::lock_guard<std::mutex> lock(cache.mutex_);
+
+	Stats stats;
+	stats.hits = cache.hits_;
+	stats.misses = cache.misses_;
+	stats.evictions = cache.evictions_;
+	stats.invalidations = cache.invalidations_;
+	stats.size = cache.entries_.size();
+	stats.capacity = cache.capacity_;
+	return stats;
+}
+
+void WGPU::Pipeline::BindGroupCache::erase(std::list<Entry>::iterator entry)
+{
+	for (const void* resource : entry->resources) {
+		auto count = bound_.find(resource);
+		if (--count->second == 0) {
+			bound_.erase(count);
+		}
+	}
+	index_.erase(entry->key);
+	entries_.erase(entry);
+}
+
+void WGPU::Pipeline::BindGroupCache::evict()
+{
+	while (entries_.size() > capacity_) {
+		erase(std::prev(entries_.end()));
+		++evictions_;
+	}
+}
+
+/**
+ * The layout and each entry's binding and resource handles, in binding order, so the same
+ * entries given in another order share a bind group.
+ */
+std::string WGPU::Pipeline::BindGroupCache::keyOf(WGPUBindGroupLayout layout, std::span<const WGPUBindGroupEntry> entries)
+{
+	std::vector<const WGPUBindGroupEntry*> sorted;
+	for (const WGPUBindGroupEntry& entry : entries) {
+		sorted.push_back(&entry);
+	}
+	std::sort(sorted.begin(), sorted.end(), [](const WGPUBindGroupEntry* a, const WGPUBindGroupEntry* b) { return a->binding < b->binding; });
+
+	std::string key;
+	append(key, layout);
+	append(key, sorted.size());
+	for (const WGPUBindGroupEntry* entry : sorted) {
+		append(key, entry->binding);
+		append(key, entry->buffer);
+		append(key, entry->offset);
+		append(key, entry->size);
+		append(key, entry->sampler);
+		append(key, entry->textureView);
+	}
+	return key;
+}
@@ -0,0 +1,124 @@
+#pragma once
+
+#include <webgpu/webgpu.h>
+#include <cstdint>
+#include <iostream>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <core/Core.h>
+
+namespace WGPU::Pipeline {
+	/**
+	 * @class BindGroupCache
+	 * @brief Process-wide cache of bind groups keyed by the resources they bind.
+	 *
+	 * Acquire() hashes the layout and every entry's buffer range, texture view and sampler,
+	 * and returns the existing bind group when the same tuple was bound before. Together with
+	 * the PipelineCache, which interns bind group layouts, this lets every pipeline object of
+	 * one configuration share the bind group for a texture instead of creating its own, so
+	 * the number of bind groups follows the number of distinct textures, not of sprites.
+	 *
+	 * The cache keeps at most GetStats().capacity bind groups and drops the least recently
+	 * acquired one beyond that. A dropped bind group lives on while a BindGroupRef to it
+	 * exists. Owners of bound resources call Invalidate() when they release a handle, which
+	 * drops every entry binding it, so a new resource that reuses the address never hits a
+	 * stale bind group. TextureImage, TextureArray, TextureAtlas and the PipelineCache's bind
+	 * group layouts already do; the uniform buffers reach it through Buffer::ReleaseHook.
+	 *
+	 * @code
+	 * WGPUBindGroupEntry entries[2] = {};
+	 * entries[0].binding = 0; entries[0].textureView = texture->GetView();
+	 * entries[1].binding = 1; entries[1].sampler = texture->GetSampler();
+	 * auto bindGroup = WGPU::Pipeline::BindGroupCache::Acquire(pipeline->GetBindGroupLayout(0), entries);
+	 * wgpuRenderPassEncoderSetBindGroup(renderPass, 0, bindGroup->handle, 0, nullptr);
+	 * @endcode
+	 */
+	class BindGroupCache {
+	public:
+		struct BindGroup {
+			WGPUBindGroup handle = nullptr;
+			~BindGroup();
+		};
+
+		using BindGroupRef = std::shared_ptr<const BindGroup>;
+
+		struct Stats {
+			uint64_t hits = 0;
+			uint64_t misses = 0;        // Bind groups actually created
+			uint64_t evictions = 0;     // Dropped for capacity
+			uint64_t invalidations = 0; // Dropped because a bound resource was released
+			size_t size = 0;
+			size_t capacity = 0;
+		};
+
+		/*============================================================
+		* PUBLIC
+		=============================================================*/
+
+		/**
+		 * @brief The bind group binding entries with layout, created on first use.
+		 *
+		 * @param label Used for the first creation only; not part of the key.
+		 * @throws std::runtime_error If the bind group cannot be created.
+		 */
+		static BindGroupRef Acquire(WGPUBindGroupLayout layout, std::span<const WGPUBindGroupEntry> entries, const char* label = nullptr);
+
+		/**
+		 * @brief Drops every cached bind group that binds resource (a buffer, texture view,
+		 * sampler or bind group layout handle). Call it before releasing the handle.
+		 */
+		static void Invalidate(const void* resource);
+
+		/**
+		 * @brief Sets how many bind groups are kept, evicting the oldest ones now if needed.
+		 */
+		static void SetCapacity(size_t capacity);
+
+		/**
+		 * @brief Drops every cached bind group.
+		 */
+		static void Clear();
+
+		static Stats GetStats();
+
+		BindGroupCache(const BindGroupCache&) = delete;
+		BindGroupCache& operator=(const BindGroupCache&) = delete;
+	private:
+		BindGroupCache();
+		~BindGroupCache();
+
+		static BindGroupCache& retrieveInstance() {
+			static BindGroupCache instance;
+			return instance;
+		}
+
+		struct Entry {
+			std::string key;
+			BindGroupRef bindGroup;
+			std::vector<const void*> resources; // Layout first, then every bound handle
+		};
+
+		std::mutex mutex_;
+		std::list<Entry> entries_; // Most recently acquired first
+		std::unordered_map<std::string, std::list<Entry>::iterator> index_;
+		std::unordered_map<const void*, uint32_t> bound_; // How many entries bind each resource
+		size_t capacity_ = 1024;
+		uint64_t hits_ = 0;
+		uint64_t misses_ = 0;
+		uint64_t evictions_ = 0;
+		uint64_t invalidations_ = 0;
+
+		// Callers hold mutex_
+		void erase(std::list<Entry>::iterator entry);
+		void evict();
+
+		static std::string keyOf(WGPUBindGroupLayout layout, std::span<const WGPUBindGroupEntry> entries);
+	};
+}
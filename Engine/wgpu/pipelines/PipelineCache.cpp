@@ -0,0 +1,462 @@
+#include "PipelineCache.h"
+#include "BindGroupCache.h"
+
+#include <algorithm>
+#include <type_traits>
+#include <utility>
+
+namespace {
+	// Keys are the state's fields appended one by one, never whole structs, so padding
+	// bytes and chain pointers cannot make equal states differ
+	template <typename T>
+	void append(std::string& key, const T& value)
+	{
+		static_assert(std::is_trivially_copyable_v<T>, "Only plain values go into a key.");
+		key.append(reinterpret_cast<const char*>(&value), sizeof(T));
+	}
+
+	void appendText(std::string& key, std::string_view text)
+	{
+		append(key, text.size());
+		key.append(text);
+	}
+
+	template <typename T>
+	size_t countLive(const std::unordered_map<std::string, std::weak_ptr<T>>& map)
+	{
+		return static_cast<size_t>(std::count_if(map.begin(), map.end(), [](const auto& entry) { return !entry.second.expired(); }));
+	}
+}
+
+WGPU::Pipeline::PipelineCache::BindGroupLayout::~BindGroupLayout()
+{
+	if (handle) {
+		BindGroupCache::Invalidate(handle);
+		wgpuBindGroupLayoutRelease(handle);
+		handle = nullptr;
+	}
+}
+
+WGPU::Pipeline::PipelineCache::PipelineLayout::~PipelineLayout()
+{
+	if (handle) {
+		wgpuPipelineLayoutRelease(handle);
+		handle = nullptr;
+	}
+}
+
+WGPU::Pipeline::PipelineCache::RenderPipeline::~RenderPipeline()
+{
+	std::cout << "Releasing cached render pipeline..." << std::endl;
+	if (handle) {
+		wgpuRenderPipelineRelease(handle);
+		handle = nullptr;
+	}
+}
+
+WGPU::Pipeline::PipelineCache::RenderPipelineRef WGPU::Pipeline::PipelineCache::AcquireRenderPipeline(const RenderPipelineState& state)
+{
+	PipelineCache& cache = retrieveInstance();
+	const std::string key = keyOf(state);
+
+	std::lock_guard<std::mutex> lock(cache.mutex_);
+	std::weak_ptr<RenderPipeline>& slot = cache.renderPipelines_[key];
+	if (RenderPipelineRef pipeline = slot.lock()) {
+		++cache.pipelineHits_;
+		return pipeline;
+	}
+
+	auto pipeline = std::make_shared<RenderPipeline>();
+	pipeline->state = state;
+	pipeline->module = Shader::ShaderLibrary::AcquireModule(state.GetSource());
+	pipeline->layout = cache.acquirePipelineLayout(cache.acquireBindGroupLayouts(state));
+
+	PipelineDescriptor descriptor;
+	describe(state, pipeline->layout->handle, pipeline->module->handle, descriptor);
+	pipeline->handle = wgpuDeviceCreateRenderPipeline(Core::Device(), &descriptor.desc);
+	if (!pipeline->handle) {
+		throw std::runtime_error("PipelineCache: failed to create render pipeline.");
+	}
+	slot = pipeline;
+	++cache.pipelineMisses_;
+	return pipeline;
+}
+
+WGPU::Pipeline::PipelineCache::BindGroupLayoutRef WGPU::Pipeline::PipelineCache::AcquireBindGroupLayout(std::span<const WGPUBindGroupLayoutEntry> entries)
+{
+	PipelineCache& cache = retrieveInstance();
+	std::lock_guard<std::mutex> lock(cache.mutex_);
+	return cache.acquireBindGroupLayout(entries);
+}
+
+WGPU::Pipeline::PipelineCache::PipelineLayoutRef WGPU::Pipeline::PipelineCache::AcquirePipelineLayout(const std::vector<BindGroupLayoutRef>& bindGroupLayouts)
+{
+	PipelineCache& cache = retrieveInstance();
+	std::lock_guard<std::mutex> lock(cache.mutex_);
+	return cache.acquirePipelineLayout(bindGroupLayouts);
+}
+
+void WGPU::Pipeline::PipelineCache::Update()
+{
+	PipelineCache& cache = retrieveInstance();
+	std::lock_guard<std::mutex> lock(cache.mutex_);
+
+	// Finish first, so a version waiting on the one in flight can start this frame
+	std::erase_if(cache.reloadsInFlight_, [&cache](const std::unique_ptr<Reload>& reload) { return cache.finishReload(*reload); });
+
+	std::vector<Shader::ShaderRef> programs = std::exchange(cache.reloadsWaiting_, {});
+	for (Shader::ShaderRef& program : Shader::ShaderLibrary::TakeReloads()) {
+		std::erase_if(programs, [&program](const Shader::ShaderRef& waiting) { return waiting->name == program->name; });
+		programs.push_back(std::move(program));
+	}
+	for (const Shader::ShaderRef& program : programs) {
+		cache.startReload(program);
+	}
+}
+
+void WGPU::Pipeline::PipelineCache::Trim()
+{
+	PipelineCache& cache = retrieveInstance();
+	std::lock_guard<std::mutex> lock(cache.mutex_);
+	std::erase_if(cache.renderPipelines_, [](const auto& entry) { return entry.second.expired(); });
+	std::erase_if(cache.pipelineLayouts_, [](const auto& entry) { return entry.second.expired(); });
+	std::erase_if(cache.bindGroupLayouts_, [](const auto& entry) { return entry.second.expired(); });
+}
+
+WGPU::Pipeline::PipelineCache::Stats WGPU::Pipeline::PipelineCache::GetStats()
+{
+	PipelineCache& cache = retrieveInstance();
+	std::lock_guard<std::mutex> lock(cache.mutex_);
+
+	Stats stats;
+	stats.pipelineHits = cache.pipelineHits_;
+	stats.pipelineMisses = cache.pipelineMisses_;
+	stats.reloads = cache.reloads_;
+	stats.failedReloads = cache.failedReloads_;
+	stats.livePipelines = countLive(cache.renderPipelines_);
+	stats.livePipelineLayouts = countLive(cache.pipelineLayouts_);
+	stats.liveBindGroupLayouts = countLive(cache.bindGroupLayouts_);
+	return stats;
+}
+
+WGPU::Pipeline::PipelineCache::BindGroupLayoutRef WGPU::Pipeline::PipelineCache::acquireBindGroupLayout(std::span<const WGPUBindGroupLayoutEntry> entries)
+{
+	std::weak_ptr<const BindGroupLayout>& slot = bindGroupLayouts_[keyOf(entries)];
+	if (BindGroupLayoutRef layout = slot.lock()) {
+		return layout;
+	}
+
+	WGPUBindGroupLayoutDescriptor desc{};
+	desc.nextInChain = nullptr;
+	desc.label = "Cached bind group layout";
+	desc.entryCount = entries.size();
+	desc.entries = entries.data();
+
+	auto layout = std::make_shared<BindGroupLayout>();
+	layout->handle = wgpuDeviceCreateBindGroupLayout(Core::Device(), &desc);
+	if (!layout->handle) {
+		throw std::runtime_error("PipelineCache: failed to create bind group layout.");
+	}
+	slot = layout;
+	return layout;
+}
+
+WGPU::Pipeline::PipelineCache::PipelineLayoutRef WGPU::Pipeline::PipelineCache::acquirePipelineLayout(const std::vector<BindGroupLayoutRef>& bindGroupLayouts)
+{
+	// Bind group layouts are interned, so their handles identify them
+	std::string key;
+	std::vector<WGPUBindGroupLayout> handles;
+	for (const BindGroupLayoutRef& bindGroupLayout : bindGroupLayouts) {
+		append(key, bindGroupLayout->handle);
+		handles.push_back(bindGroupLayout->handle);
+	}
+
+	std::weak_ptr<const PipelineLayout>& slot = pipelineLayouts_[key];
+	if (PipelineLayoutRef layout = slot.lock()) {
+		return layout;
+	}
+
+	WGPUPipelineLayoutDescriptor desc{};
+	desc.nextInChain = nullptr;
+	desc.label = "Cached pipeline layout";
+	desc.bindGroupLayoutCount = handles.size();
+	desc.bindGroupLayouts = handles.data();
+
+	auto layout = std::make_shared<PipelineLayout>();
+	layout->handle = wgpuDeviceCreatePipelineLayout(Core::Device(), &desc);
+	if (!layout->handle) {
+		throw std::runtime_error("PipelineCache: failed to create pipeline layout.");
+	}
+	layout->bindGroupLayouts = bindGroupLayouts;
+	slot = layout;
+	return layout;
+}
+
+/**
+ * Bind group layouts come from the shader; group 0 buffers may take a dynamic offset.
+ */
+std::vector<WGPU::Pipeline::PipelineCache::BindGroupLayoutRef> WGPU::Pipeline::PipelineCache::acquireBindGroupLayouts(const RenderPipelineState& state)
+{
+	const auto reflection = Shader::ShaderReflection::Reflect(state.GetSource());
+	std::vector<BindGroupLayoutRef> bindGroupLayouts;
+	for (uint32_t group = 0; group < reflection->GetGroupCount(); ++group) {
+		std::vector<WGPUBindGroupLayoutEntry> entries = reflection->CreateLayoutEntries(group);
+		if (group == 0) {
+			for (WGPUBindGroupLayoutEntry& entry : entries) {
+				if (std::find(state.dynamicOffsetBindings.begin(), state.dynamicOffsetBindings.end(), entry.binding) != state.dynamicOffsetBindings.end()) {
+					entry.buffer.hasDynamicOffset = true;
+				}
+			}
+		}
+		bindGroupLayouts.push_back(acquireBindGroupLayout(entries));
+	}
+	return bindGroupLayouts;
+}
+
+/**
+ * Starts compiling every live pipeline still on an older version of program. The compiles
+ * run in the background and report through onPipelineCompiled; nothing is swapped here.
+ */
+void WGPU::Pipeline::PipelineCache::startReload(const Shader::ShaderRef& program)
+{
+	for (const std::unique_ptr<Reload>& inFlight : reloadsInFlight_) {
+		if (inFlight->program->name == program->name) {
+			reloadsWaiting_.push_back(program);
+			return;
+		}
+	}
+
+	auto reload = std::make_unique<Reload>();
+	reload->program = program;
+	try {
+		for (const auto& [key, slot] : renderPipelines_) {
+			std::shared_ptr<RenderPipeline> target = slot.lock();
+			if (!target || !target->state.shader || target->state.shader->name != program->name || target->state.shader->version >= program->version) {
+				continue;
+			}
+
+			RenderPipelineState state = target->state;
+			state.shader = program;
+			if (acquireBindGroupLayouts(state) != target->layout->bindGroupLayouts) {
+				throw std::runtime_error("the resource interface changed; restart to apply it");
+			}
+			// Equal layouts only mean equal binding sizes; host buffers also rely on member offsets
+			Shader::ShaderReflection::Reflect(program->source)->ValidateUniformLayouts(*Shader::ShaderReflection::Reflect(target->state.GetSource()));
+
+			auto recompile = std::make_unique<Recompile>();
+			recompile->target = target;
+			recompile->module = Shader::ShaderLibrary::AcquireModule(program->source);
+			reload->recompiles.push_back(std::move(recompile));
+		}
+	}
+	catch (const std::exception& e) {
+		std::cerr << "PipelineCache: cannot reload shader '" << program->name << "': " << e.what() << std::endl;
+		++failedReloads_;
+		return;
+	}
+
+	if (reload->recompiles.empty()) {
+		Shader::ShaderLibrary::Commit(program); // No pipeline uses it; the next one built will
+		return;
+	}
+
+	for (const std::unique_ptr<Recompile>& recompile : reload->recompiles) {
+		RenderPipelineState state = recompile->target->state;
+		state.shader = program;
+
+		PipelineDescriptor descriptor;
+		describe(state, recompile->target->layout->handle, recompile->module->handle, descriptor);
+		wgpuDeviceCreateRenderPipelineAsync(Core::Device(), &descriptor.desc, onPipelineCompiled, recompile.get());
+	}
+	reloadsInFlight_.push_back(std::move(reload));
+}
+
+/**
+ * Swaps in a reload once all of its compiles have reported; every pipeline of the shader
+ * changes in the same frame, or none does.
+ *
+ * @return Whether the reload is done with, applied or dropped.
+ */
+bool WGPU::Pipeline::PipelineCache::finishReload(Reload& reload)
+{
+	std::string error;
+	for (const std::unique_ptr<Recompile>& recompile : reload.recompiles) {
+		if (!recompile->done) {
+			return false;
+		}
+		if (!recompile->compiled && error.empty()) {
+			error = recompile->error.empty() ? "pipeline creation failed" : recompile->error;
+		}
+	}
+
+	if (!error.empty()) {
+		for (const std::unique_ptr<Recompile>& recompile : reload.recompiles) {
+			if (recompile->compiled) {
+				wgpuRenderPipelineRelease(recompile->compiled);
+			}
+		}
+		std::cerr << "PipelineCache: shader '" << reload.program->name << "' failed to compile, keeping the previous version: " << error << std::endl;
+		++failedReloads_;
+		return true;
+	}
+
+	for (const std::unique_ptr<Recompile>& recompile : reload.recompiles) {
+		RenderPipeline& target = *recompile->target;
+		wgpuRenderPipelineRelease(target.handle);
+		target.handle = recompile->compiled;
+		target.module = std::move(recompile->module);
+		target.state.shader = reload.program;
+	}
+	Shader::ShaderLibrary::Commit(reload.program);
+	++reloads_;
+	std::cout << "PipelineCache: reloaded shader '" << reload.program->name << "' (version " << reload.program->version
+		<< ", " << reload.recompiles.size() << " pipelines)." << std::endl;
+
+	// Pipelines created from the old version while this one compiled still need it
+	for (const auto& [key, slot] : renderPipelines_) {
+		std::shared_ptr<RenderPipeline> pipeline = slot.lock();
+		if (pipeline && pipeline->state.shader && pipeline->state.shader->name == reload.program->name && pipeline->state.shader->version < reload.program->version) {
+			reloadsWaiting_.push_back(reload.program);
+			break;
+		}
+	}
+	return true;
+}
+
+/**
+ * Fills out.desc for state; the descriptor points into out, which must stay where it is
+ * until the pipeline has been created.
+ */
+void WGPU::Pipeline::PipelineCache::describe(const RenderPipelineState& state, WGPUPipelineLayout layout, WGPUShaderModule module, PipelineDescriptor& out)
+{
+	out.vertexBuffers.clear();
+	for (const VertexBufferState& buffer : state.vertexBuffers) {
+		WGPUVertexBufferLayout bufferLayout{};
+		bufferLayout.arrayStride = buffer.arrayStride;
+		bufferLayout.stepMode = buffer.stepMode;
+		bufferLayout.attributeCount = buffer.attributes.size();
+		bufferLayout.attributes = buffer.attributes.data();
+		out.vertexBuffers.push_back(bufferLayout);
+	}
+
+	WGPURenderPipelineDescriptor& pipelineDesc = out.desc;
+	pipelineDesc = WGPURenderPipelineDescriptor{};
+	pipelineDesc.nextInChain = nullptr;
+	pipelineDesc.label = state.label;
+	pipelineDesc.layout = layout;
+
+	pipelineDesc.vertex.module = module;
+	pipelineDesc.vertex.entryPoint = state.vertexEntryPoint.c_str();
+	pipelineDesc.vertex.constantCount = 0;
+	pipelineDesc.vertex.constants = nullptr;
+	pipelineDesc.vertex.bufferCount = out.vertexBuffers.size();
+	pipelineDesc.vertex.buffers = out.vertexBuffers.empty() ? nullptr : out.vertexBuffers.data();
+
+	pipelineDesc.primitive.topology = state.topology;
+	pipelineDesc.primitive.stripIndexFormat = WGPUIndexFormat_Undefined;
+	pipelineDesc.primitive.frontFace = state.frontFace;
+	pipelineDesc.primitive.cullMode = state.cullMode;
+
+	out.blend = state.blend.value_or(WGPUBlendState{});
+	out.colorTarget = WGPUColorTargetState{};
+	out.colorTarget.format = state.targetFormat;
+	out.colorTarget.blend = state.blend ? &out.blend : nullptr;
+	out.colorTarget.writeMask = state.writeMask;
+
+	out.fragment = WGPUFragmentState{};
+	out.fragment.module = module;
+	out.fragment.entryPoint = state.fragmentEntryPoint.c_str();
+	out.fragment.constantCount = 0;
+	out.fragment.constants = nullptr;
+	out.fragment.targetCount = 1;
+	out.fragment.targets = &out.colorTarget;
+	pipelineDesc.fragment = &out.fragment;
+
+	pipelineDesc.depthStencil = nullptr;
+	pipelineDesc.multisample.count = 1;
+	pipelineDesc.multisample.mask = ~0u;
+	pipelineDesc.multisample.alphaToCoverageEnabled = false;
+}
+
+/**
+ * Called from wgpuDeviceTick on the main thread; only records the result for Update().
+ */
+void WGPU::Pipeline::PipelineCache::onPipelineCompiled(WGPUCreatePipelineAsyncStatus status, WGPURenderPipeline pipeline, const char* message, void* userData)
+{
+	Recompile& recompile = *static_cast<Recompile*>(userData);
+	if (status == WGPUCreatePipelineAsyncStatus_Success) {
+		recompile.compiled = pipeline;
+	}
+	else {
+		if (pipeline) {
+			wgpuRenderPipelineRelease(pipeline);
+		}
+		recompile.error = message ? message : "";
+	}
+	recompile.done = true;
+}
+
+std::string WGPU::Pipeline::PipelineCache::keyOf(const RenderPipelineState& state)
+{
+	// A library shader is keyed by name, so the pipeline stays the same entry across reloads
+	std::string key;
+	append(key, state.shader != nullptr);
+	appendText(key, state.shader ? std::string_view(state.shader->name) : state.shaderSource);
+	appendText(key, state.vertexEntryPoint);
+	appendText(key, state.fragmentEntryPoint);
+
+	append(key, state.vertexBuffers.size());
+	for (const VertexBufferState& buffer : state.vertexBuffers) {
+		append(key, buffer.arrayStride);
+		append(key, buffer.stepMode);
+		append(key, buffer.attributes.size());
+		for (const WGPUVertexAttribute& attribute : buffer.attributes) {
+			append(key, attribute.format);
+			append(key, attribute.offset);
+			append(key, attribute.shaderLocation);
+		}
+	}
+
+	append(key, state.targetFormat);
+	append(key, state.blend.has_value());
+	if (state.blend) {
+		for (const WGPUBlendComponent& component : { state.blend->color, state.blend->alpha }) {
+			append(key, component.operation);
+			append(key, component.srcFactor);
+			append(key, component.dstFactor);
+		}
+	}
+	append(key, state.writeMask);
+	append(key, state.topology);
+	append(key, state.frontFace);
+	append(key, state.cullMode);
+
+	std::vector<uint32_t> dynamicOffsetBindings = state.dynamicOffsetBindings;
+	std::sort(dynamicOffsetBindings.begin(), dynamicOffsetBindings.end());
+	append(key, dynamicOffsetBindings.size());
+	for (uint32_t binding : dynamicOffsetBindings) {
+		append(key, binding);
+	}
+	return key;
+}
+
+std::string WGPU::Pipeline::PipelineCache::keyOf(std::span<const WGPUBindGroupLayoutEntry> entries)
+{
+	std::string key;
+	append(key, entries.size());
+	for (const WGPUBindGroupLayoutEntry& entry : entries) {
+		append(key, entry.binding);
+		append(key, entry.visibility);
+		append(key, entry.buffer.type);
+		append(key, entry.buffer.hasDynamicOffset);
+		append(key, entry.buffer.minBindingSize);
+		append(key, entry.sampler.type);
+		append(key, entry.texture.sampleType);
+		append(key, entry.texture.viewDimension);
+		append(key, entry.texture.multisampled);
+		append(key, entry.storageTexture.access);
+		append(key, entry.storageTexture.format);
+		append(key, entry.storageTexture.viewDimension);
+	}
+	return key;
+}
@@ -0,0 +1,253 @@
+#pragma once
+
+#include <webgpu/webgpu.h>
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include <core/Core.h>
+#include <wgpu/shader/ShaderLibrary.h>
+#include <wgpu/shader/ShaderReflection.h>
+
+namespace WGPU::Pipeline {
+	/**
+	 * @struct VertexBufferState
+	 * @brief One vertex buffer slot of a RenderPipelineState, owning its attributes.
+	 */
+	struct VertexBufferState {
+		uint64_t arrayStride = 0;
+		WGPUVertexStepMode stepMode = WGPUVertexStepMode_Vertex;
+		std::vector<WGPUVertexAttribute> attributes;
+
+		/**
+		 * @brief The slot for a Buffer::VertexLayout, numbering locations from firstLocation.
+		 */
+		template <typename Layout>
+		static VertexBufferState FromLayout(uint32_t firstLocation = 0, WGPUVertexStepMode stepMode = WGPUVertexStepMode_Vertex) {
+			const auto attributes = Layout::Attributes(firstLocation);
+			return VertexBufferState{ Layout::Stride, stepMode, std::vector<WGPUVertexAttribute>(attributes.begin(), attributes.end()) };
+		}
+	};
+
+	/**
+	 * @brief Src * SrcAlpha + Dst * (1 - SrcAlpha) on colour, destination alpha kept; the
+	 * blending every 2D pipeline here uses.
+	 */
+	inline WGPUBlendState AlphaBlending() {
+		WGPUBlendState blend{};
+		blend.color.srcFactor = WGPUBlendFactor_SrcAlpha;
+		blend.color.dstFactor = WGPUBlendFactor_OneMinusSrcAlpha;
+		blend.color.operation = WGPUBlendOperation_Add;
+		blend.alpha.srcFactor = WGPUBlendFactor_Zero;
+		blend.alpha.dstFactor = WGPUBlendFactor_One;
+		blend.alpha.operation = WGPUBlendOperation_Add;
+		return blend;
+	}
+
+	/**
+	 * @struct RenderPipelineState
+	 * @brief Everything a render pipeline is created from; two equal states share one pipeline.
+	 *
+	 * The bind group layouts are not part of the state: they are reflected from the shader,
+	 * with dynamicOffsetBindings marking the group 0 buffers that take a dynamic offset.
+	 *
+	 * The shader is either a ShaderLibrary shader, which the pipeline then follows through
+	 * hot reloads, or a plain source that must outlive the pipeline.
+	 */
+	struct RenderPipelineState {
+		Shader::ShaderRef shader;
+		std::string_view shaderSource; // Used when shader is not set
+		std::string vertexEntryPoint = "vs_main";
+		std::string fragmentEntryPoint = "fs_main";
+		std::vector<VertexBufferState> vertexBuffers;
+		WGPUTextureFormat targetFormat = WGPUTextureFormat_Undefined;
+		std::optional<WGPUBlendState> blend = AlphaBlending();
+		WGPUColorWriteMaskFlags writeMask = WGPUColorWriteMask_All;
+		WGPUPrimitiveTopology topology = WGPUPrimitiveTopology_TriangleList;
+		WGPUFrontFace frontFace = WGPUFrontFace_CCW;
+		WGPUCullMode cullMode = WGPUCullMode_None;
+		std::vector<uint32_t> dynamicOffsetBindings;
+		const char* label = nullptr; // Used for the first creation only; not part of the key
+
+		std::string_view GetSource() const { return shader ? std::string_view(shader->source) : shaderSource; }
+	};
+
+	/**
+	 * @class PipelineCache
+	 * @brief Process-wide cache of render pipelines, pipeline layouts and bind group layouts.
+	 *
+	 * AcquireRenderPipeline() hashes the full RenderPipelineState (shader text, entry points,
+	 * vertex buffers, target format, blending, primitive state, dynamic offsets) and hands
+	 * out the existing pipeline when an equal state was acquired before, so constructing the
+	 * same kind of pipeline object again compiles nothing. Pipeline layouts are interned by
+	 * their bind group layouts, and bind group layouts by their entries, so pipelines with
+	 * the same resource interface also share those objects and each other's bind groups.
+	 *
+	 * Everything is handed out as a shared_ptr: the GPU object is released with its last
+	 * reference, and the cache itself only keeps weak references. A pipeline holds its
+	 * layout and the layout its bind group layouts, so each lives as long as its users.
+	 * Shader modules come from ShaderLibrary::AcquireModule and are shared the same way.
+	 *
+	 * Pipelines built from a ShaderLibrary shader follow its hot reloads. Update(), called
+	 * once per frame before any recording, starts an asynchronous compile of every live
+	 * pipeline using a reloaded shader, and once all of them have compiled swaps their
+	 * handles in one go, between two frames. Users keep their RenderPipelineRef and pick up
+	 * the new handle the next time they read it. A reload has to keep the shader's bind
+	 * group layouts, since existing bind groups are built against them, and the member
+	 * layout of its uniform structs, since host buffers write at those offsets. One that
+	 * changes either, or fails to compile, is dropped and the old pipelines keep running.
+	 *
+	 * @code
+	 * WGPU::Pipeline::RenderPipelineState state;
+	 * state.shaderSource = shaderSource_;
+	 * state.vertexBuffers.push_back(WGPU::Pipeline::VertexBufferState::FromLayout<VertexLayout>());
+	 * state.targetFormat = Surface::Format();
+	 * pipeline_ = WGPU::Pipeline::PipelineCache::AcquireRenderPipeline(state); // compiled once per state
+	 * wgpuRenderPassEncoderSetPipeline(renderPass, pipeline_->handle);
+	 * @endcode
+	 */
+	class PipelineCache {
+	public:
+		struct BindGroupLayout {
+			WGPUBindGroupLayout handle = nullptr;
+			~BindGroupLayout();
+		};
+
+		struct PipelineLayout {
+			WGPUPipelineLayout handle = nullptr;
+			std::vector<std::shared_ptr<const BindGroupLayout>> bindGroupLayouts;
+			~PipelineLayout();
+		};
+
+		struct RenderPipeline {
+			WGPURenderPipeline handle = nullptr; // Replaced in place when the shader reloads
+			std::shared_ptr<const PipelineLayout> layout;
+			Shader::ShaderModuleRef module;
+			RenderPipelineState state; // What the current handle was created from
+			~RenderPipeline();
+
+			/**
+			 * @throws std::out_of_range If the pipeline has no such group.
+			 */
+			WGPUBindGroupLayout GetBindGroupLayout(uint32_t group) const { return layout->bindGroupLayouts.at(group)->handle; }
+		};
+
+		using BindGroupLayoutRef = std::shared_ptr<const BindGroupLayout>;
+		using PipelineLayoutRef = std::shared_ptr<const PipelineLayout>;
+		using RenderPipelineRef = std::shared_ptr<const RenderPipeline>;
+
+		struct Stats {
+			uint64_t pipelineHits = 0;
+			uint64_t pipelineMisses = 0; // Pipelines actually created
+			uint64_t reloads = 0;        // Shader versions swapped in
+			uint64_t failedReloads = 0;
+			size_t livePipelines = 0;
+			size_t livePipelineLayouts = 0;
+			size_t liveBindGroupLayouts = 0;
+		};
+
+		/*============================================================
+		* PUBLIC
+		=============================================================*/
+
+		/**
+		 * @brief The pipeline for state, created on first use or after every earlier user
+		 * released it.
+		 *
+		 * @throws std::runtime_error If the shader cannot be reflected or the pipeline
+		 * cannot be created.
+		 */
+		static RenderPipelineRef AcquireRenderPipeline(const RenderPipelineState& state);
+
+		/**
+		 * @brief The bind group layout with exactly these entries.
+		 */
+		static BindGroupLayoutRef AcquireBindGroupLayout(std::span<const WGPUBindGroupLayoutEntry> entries);
+
+		/**
+		 * @brief The pipeline layout over these bind group layouts, in group order.
+		 */
+		static PipelineLayoutRef AcquirePipelineLayout(const std::vector<BindGroupLayoutRef>& bindGroupLayouts);
+
+		/**
+		 * @brief Applies shader reloads: starts compiles for new ShaderLibrary versions and
+		 * swaps in the ones that finished. Call at the frame boundary, on the main thread.
+		 * Compile results are delivered by wgpuDeviceTick, which FrameContext::BeginFrame() calls.
+		 */
+		static void Update();
+
+		/**
+		 * @brief Drops the cache entries whose objects have all been released.
+		 */
+		static void Trim();
+
+		static Stats GetStats();
+
+		PipelineCache(const PipelineCache&) = delete;
+		PipelineCache& operator=(const PipelineCache&) = delete;
+	private:
+		PipelineCache() = default;
+
+		static PipelineCache& retrieveInstance() {
+			static PipelineCache instance;
+			return instance;
+		}
+
+		std::mutex mutex_;
+		std::unordered_map<std::string, std::weak_ptr<const BindGroupLayout>> bindGroupLayouts_;
+		std::unordered_map<std::string, std::weak_ptr<const PipelineLayout>> pipelineLayouts_;
+		std::unordered_map<std::string, std::weak_ptr<RenderPipeline>> renderPipelines_;
+		uint64_t pipelineHits_ = 0;
+		uint64_t pipelineMisses_ = 0;
+		uint64_t reloads_ = 0;
+		uint64_t failedReloads_ = 0;
+
+		// The descriptor and the arrays it points into
+		struct PipelineDescriptor {
+			WGPURenderPipelineDescriptor desc{};
+			std::vector<WGPUVertexBufferLayout> vertexBuffers;
+			WGPUBlendState blend{};
+			WGPUColorTargetState colorTarget{};
+			WGPUFragmentState fragment{};
+		};
+
+		// One pipeline being recompiled for a reload
+		struct Recompile {
+			std::shared_ptr<RenderPipeline> target;
+			Shader::ShaderModuleRef module;
+			WGPURenderPipeline compiled = nullptr;
+			bool done = false;
+			std::string error;
+		};
+
+		// Every pipeline of one reloaded shader version; swapped together or not at all
+		struct Reload {
+			Shader::ShaderRef program;
+			std::vector<std::unique_ptr<Recompile>> recompiles;
+		};
+
+		std::vector<std::unique_ptr<Reload>> reloadsInFlight_;
+		std::vector<Shader::ShaderRef> reloadsWaiting_; // A version of the same shader is in flight
+
+		// Callers hold mutex_
+		BindGroupLayoutRef acquireBindGroupLayout(std::span<const WGPUBindGroupLayoutEntry> entries);
+		PipelineLayoutRef acquirePipelineLayout(const std::vector<BindGroupLayoutRef>& bindGroupLayouts);
+		std::vector<BindGroupLayoutRef> acquireBindGroupLayouts(const RenderPipelineState& state);
+		void startReload(const Shader::ShaderRef& program);
+		bool finishReload(Reload& reload);
+
+		static void describe(const RenderPipelineState& state, WGPUPipelineLayout layout, WGPUShaderModule module, PipelineDescriptor& out);
+		static void onPipelineCompiled(WGPUCreatePipelineAsyncStatus status, WGPURenderPipeline pipeline, const char* message, void* userData);
+
+		static std::string keyOf(const RenderPipelineState& state);
+		static std::string keyOf(std::span<const WGPUBindGroupLayoutEntry> entries);
+	};
+}
@@ -0,0 +1,151 @@
+#include "PresentPipeline.h"
+
+WGPU::Pipeline::PresentPipeline::PresentPipeline(WGPUTextureView sceneView, WGPUTextureFormat targetFormat)
+{
+	pipelineDesc_.nextInChain = nullptr;
+
+	createShaderModule(); // Load and create the shader module
+	createSampler(); // Nearest filtering keeps the pixels sharp
+	createBindGroup(sceneView); // Bind group layout from the shader, bound to the scene
+	createRenderPipeline(targetFormat); // Pipeline layout and render pipeline
+
+	wgpuShaderModuleRelease(shaderModule_);
+	shaderModule_ = nullptr;
+}
+
+WGPU::Pipeline::PresentPipeline::~PresentPipeline()
+{
+	std::cout << "Releasing PresentPipeline..." << std::endl;
+	if (pipeline_) {
+		wgpuRenderPipelineRelease(pipeline_);
+		pipeline_ = nullptr;
+	}
+	if (layout_) {
+		wgpuPipelineLayoutRelease(layout_);
+		layout_ = nullptr;
+	}
+	if (bindGroup_) {
+		wgpuBindGroupRelease(bindGroup_);
+		bindGroup_ = nullptr;
+	}
+	if (bindGroupLayout_) {
+		wgpuBindGroupLayoutRelease(bindGroupLayout_);
+		bindGroupLayout_ = nullptr;
+	}
+	if (sampler_) {
+		wgpuSamplerRelease(sampler_);
+		sampler_ = nullptr;
+	}
+}
+
+/**
+ * Loads and creates the shader module used for the pipeline.
+ */
+void WGPU::Pipeline::PresentPipeline::createShaderModule()
+{
+	WGPUShaderModuleDescriptor shaderDesc{};
+
+	WGPUShaderModuleWGSLDescriptor shaderCodeDesc{};
+	shaderCodeDesc.chain.next = nullptr;
+	shaderCodeDesc.chain.sType = WGPUSType_ShaderModuleWGSLDescriptor;
+	shaderDesc.nextInChain = &shaderCodeDesc.chain;
+	shaderCodeDesc.code = shaderSource_;
+
+	shaderModule_ = wgpuDeviceCreateShaderModule(Core::Device(), &shaderDesc);
+}
+
+/**
+ * Creates the nearest-neighbour sampler the scene is read with.
+ */
+void WGPU::Pipeline::PresentPipeline::createSampler()
+{
+	WGPUSamplerDescriptor samplerDesc = {};
+	samplerDesc.nextInChain = nullptr;
+	samplerDesc.label = "Present sampler";
+	samplerDesc.addressModeU = WGPUAddressMode_ClampToEdge;
+	samplerDesc.addressModeV = WGPUAddressMode_ClampToEdge;
+	samplerDesc.addressModeW = WGPUAddressMode_ClampToEdge;
+	samplerDesc.magFilter = WGPUFilterMode_Nearest;
+	samplerDesc.minFilter = WGPUFilterMode_Nearest;
+	samplerDesc.mipmapFilter = WGPUMipmapFilterMode_Nearest;
+	samplerDesc.lodMinClamp = 0.0f;
+	samplerDesc.lodMaxClamp = 1.0f;
+	samplerDesc.compare = WGPUCompareFunction_Undefined;
+	samplerDesc.maxAnisotropy = 1;
+	sampler_ = wgpuDeviceCreateSampler(Core::Device(), &samplerDesc);
+}
+
+/**
+ * Creates the bind group layout from the reflected shader and binds the scene to it.
+ *
+ * @param sceneView View of the native-resolution scene texture.
+ */
+void WGPU::Pipeline::PresentPipeline::createBindGroup(WGPUTextureView sceneView)
+{
+	bindGroupLayout_ = Shader::ShaderReflection::Reflect(shaderSource_)->CreateBindGroupLayout(0);
+
+	WGPUBindGroupEntry bindings[2] = {};
+	bindings[0].nextInChain = nullptr;
+	bindings[0].binding = 0;
+	bindings[0].textureView = sceneView;
+	bindings[1].nextInChain = nullptr;
+	bindings[1].binding = 1;
+	bindings[1].sampler = sampler_;
+
+	WGPUBindGroupDescriptor bindGroupDesc = {};
+	bindGroupDesc.nextInChain = nullptr;
+	bindGroupDesc.label = "Present bind group";
+	bindGroupDesc.layout = bindGroupLayout_;
+	bindGroupDesc.entryCount = 2;
+	bindGroupDesc.entries = bindings;
+	bindGroup_ = wgpuDeviceCreateBindGroup(Core::Device(), &bindGroupDesc);
+}
+
+/**
+ * Creates the pipeline layout and the render pipeline. There are no vertex buffers and
+ * no blending: the blit overwrites the viewport.
+ *
+ * @param targetFormat Format of the surface.
+ */
+void WGPU::Pipeline::PresentPipeline::createRenderPipeline(WGPUTextureFormat targetFormat)
+{
+	WGPUPipelineLayoutDescriptor layoutDesc = {};
+	layoutDesc.nextInChain = nullptr;
+	layoutDesc.bindGroupLayoutCount = 1;
+	layoutDesc.bindGroupLayouts = &bindGroupLayout_;
+	layout_ = wgpuDeviceCreatePipelineLayout(Core::Device(), &layoutDesc);
+
+	pipelineDesc_.vertex.bufferCount = 0;
+	pipelineDesc_.vertex.buffers = nullptr;
+	pipelineDesc_.vertex.module = shaderModule_;
+	pipelineDesc_.vertex.entryPoint = "vs_main";
+	pipelineDesc_.vertex.constantCount = 0;
+	pipelineDesc_.vertex.constants = nullptr;
+
+	pipelineDesc_.primitive.topology = WGPUPrimitiveTopology_TriangleList;
+	pipelineDesc_.primitive.stripIndexFormat = WGPUIndexFormat_Undefined;
+	pipelineDesc_.primitive.frontFace = WGPUFrontFace_CCW;
+	pipelineDesc_.primitive.cullMode = WGPUCullMode_None;
+
+	colorTarget_.format = targetFormat;
+	colorTarget_.blend = nullptr;
+	colorTarget_.writeMask = WGPUColorWriteMask_All;
+
+	fragmentState_.module = shaderModule_;
+	fragmentState_.entryPoint = "fs_main";
+	fragmentState_.constantCount = 0;
+	fragmentState_.constants = nullptr;
+	fragmentState_.targetCount = 1;
+	fragmentState_.targets = &colorTarget_;
+	pipelineDesc_.fragment = &fragmentState_;
+
+	pipelineDesc_.depthStencil = nullptr;
+	pipelineDesc_.multisample.count = 1;
+	pipelineDesc_.multisample.mask = ~0u;
+	pipelineDesc_.multisample.alphaToCoverageEnabled = false;
+	pipelineDesc_.layout = layout_;
+	pipeline_ = wgpuDeviceCreateRenderPipeline(Core::Device(), &pipelineDesc_);
+	if (!pipeline_) {
+		throw std::runtime_error("Failed to create present pipeline.");
+	}
+}
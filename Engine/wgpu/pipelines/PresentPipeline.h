@@ -0,0 +1,79 @@
+#pragma once
+
+#include <webgpu/webgpu.h>
+#include <iostream>
+#include <stdexcept>
+
+#include <core/Core.h>
+#include <wgpu/shader/ShaderReflection.h>
+
+namespace WGPU::Pipeline {
+	/**
+	 * Copies the native-resolution scene onto the surface.
+	 *
+	 * One fullscreen triangle, generated from the vertex index, covers whatever viewport
+	 * the pass sets; the scene is sampled with a nearest filter so an integer viewport
+	 * scale keeps every native pixel a sharp square block.
+	 */
+	class PresentPipeline {
+	public:
+		/**
+		 * @param sceneView View of the native-resolution scene texture.
+		 * @param targetFormat Format of the surface it is presented to.
+		 */
+		PresentPipeline(WGPUTextureView sceneView, WGPUTextureFormat targetFormat);
+		~PresentPipeline();
+
+		PresentPipeline(const PresentPipeline&) = delete;
+		PresentPipeline& operator=(const PresentPipeline&) = delete;
+
+		WGPURenderPipeline GetPipeline() const { return pipeline_; }
+		WGPUBindGroup GetBindGroup() const { return bindGroup_; }
+
+		static const char* GetShaderSource() { return shaderSource_; }
+	private:
+		static constexpr const char* shaderSource_ = R"(
+			@group(0) @binding(0) var sceneTexture: texture_2d<f32>;
+			@group(0) @binding(1) var sceneSampler: sampler;
+
+			struct VertexOutput {
+				@builtin(position) position: vec4f,
+				@location(0) uv: vec2f
+			};
+
+			@vertex
+			fn vs_main(@builtin(vertex_index) vertex_index: u32) -> VertexOutput {
+				// Triangle with corners (-1,-1), (3,-1), (-1,3): covers the viewport in one draw
+				let corner = vec2f(f32((vertex_index << 1u) & 2u), f32(vertex_index & 2u));
+
+				var output: VertexOutput;
+				output.position = vec4f(corner * 2.0 - 1.0, 0.0, 1.0);
+				output.uv = vec2f(corner.x, 1.0 - corner.y);
+				return output;
+			}
+
+			@fragment
+			fn fs_main(in: VertexOutput) -> @location(0) vec4f {
+				return textureSample(sceneTexture, sceneSampler, in.uv);
+			}
+		)";
+
+		// WebGPU resources
+		WGPURenderPipeline pipeline_ = nullptr;
+		WGPUPipelineLayout layout_ = nullptr;
+		WGPUBindGroupLayout bindGroupLayout_ = nullptr;
+		WGPUBindGroup bindGroup_ = nullptr;
+		WGPUSampler sampler_ = nullptr;
+		WGPUShaderModule shaderModule_ = nullptr;
+
+		// WebGPU descriptors
+		WGPURenderPipelineDescriptor pipelineDesc_{};
+		WGPUFragmentState fragmentState_{};
+		WGPUColorTargetState colorTarget_{};
+
+		void createShaderModule();
+		void createSampler();
+		void createBindGroup(WGPUTextureView sceneView);
+		void createRenderPipeline(WGPUTextureFormat targetFormat);
+	};
+}
@@ -1,31 +1,82 @@
 #pragma once
 
 #include <webgpu/webgpu.h>
+#include <glm/glm.hpp>
+#include <array>
 #include <iostream>
 
 #include <core/Core.h>
 #include <core/Surface.h>
+#include <wgpu/shader/ShaderReflection.h>
+#include <wgpu/buffer/VertexLayout.h>
+#include <wgpu/buffer/VertexPacking.h>
+
+#include "BindGroupCache.h"
+#include "PipelineCache.h"
 
 namespace WGPU::Pipeline {
+	/**
+	 * Textured quad pipeline. The render pipeline, its layout and bind group layout come
+	 * from the PipelineCache, so every Quad2DPipeline with the same encoding, dynamic offset
+	 * choice and surface format shares one compiled pipeline; only the bind group is per
+	 * object.
+	 */
 	class Quad2DPipeline {
 	public:
+		/**
+		 * Vertex format of the meshes this pipeline draws: position, then UV.
+		 */
+		using VertexLayout = Buffer::VertexLayout<glm::vec2, glm::vec2>;
+
+		/**
+		 * Quantized vertex format (CompactVertex2D): Snorm16 position, Unorm16 UV. The vertex
+		 * fetch decodes both to vec2f, so only the pipeline's buffer layout changes.
+		 */
+		using CompactVertexLayout = Buffer::CompactVertex2DLayout;
+
 		Quad2DPipeline(
             WGPUBuffer uniformBuffer,
             size_t bufferSize,
             WGPUTextureView textureView,
-            WGPUSampler sampler
+            WGPUSampler sampler,
+            bool dynamicOffset = false,
+            Buffer::VertexEncoding encoding = Buffer::VertexEncoding::Float32
         );
 		~Quad2DPipeline();
 
-		WGPURenderPipeline GetPipeline() const { return pipeline_; }
-		WGPUBindGroup GetBindGroup() const { return bindGroup_; }
+		WGPURenderPipeline GetPipeline() const { return pipeline_->handle; }
+		WGPUBindGroup GetBindGroup() const { return bindGroup_->handle; }
+
+		/**
+		 * @brief The bind group for this pipeline's uniform buffer with another texture.
+		 * It comes from the BindGroupCache, so every Quad2DPipeline of the same configuration
+		 * drawing that texture shares it, and one pipeline object can draw any number of
+		 * textures.
+		 */
+		BindGroupCache::BindGroupRef AcquireBindGroup(WGPUTextureView textureView, WGPUSampler sampler) const;
+		Buffer::VertexEncoding GetEncoding() const { return encoding_; }
+		uint64_t GetVertexStride() const { return vertexStride_; }
+
+		/**
+		 * The shader the pipeline is built from: Quad2D.wgsl through the ShaderLibrary, or the
+		 * built-in copy when the file is missing. Lay uniform buffers out from its source; a
+		 * reload has to keep the same resource interface and uniform member layout.
+		 */
+		static Shader::ShaderRef LoadShader();
+
+		/**
+		 * The built-in WGSL module, used when Quad2D.wgsl cannot be read.
+		 */
+		static const char* GetShaderSource() { return shaderSource_; }
 	private:
-        const char* shaderSource_ = R"(
+        // Loaded through the ShaderLibrary so it hot reloads; the source below is the fallback
+        static constexpr const char* shaderPath_ = "../assets/shaders/Quad2D.wgsl";
+        static constexpr const char* shaderSource_ = R"(
             struct Uniforms {
                 uTime: f32,                       // Offset: 0, Size: 4 bytes
-                position: vec2<f32>,              // Offset: 80, Size: 8 bytes
-                size: vec2<f32>,                  // Offset: 96, Size: 8 bytes
-                Projection: mat4x4<f32>           // Offset: 112, Size: 64 bytes
+                position: vec2<f32>,              // Offset: 8, Size: 8 bytes
+                size: vec2<f32>,                  // Offset: 16, Size: 8 bytes
+                Projection: mat4x4<f32>           // Offset: 32, Size: 64 bytes
             }
 
             @group(0) @binding(0) var<uniform> uniforms: Uniforms;
@@ -62,34 +113,15 @@ namespace WGPU::Pipeline {
         )";
 
         // WebGPU resources
-		WGPURenderPipeline pipeline_;
-		WGPUPipelineLayout layout_;
-		WGPUBindGroupLayout bindGroupLayout_;
-		WGPUBindGroup bindGroup_;
-		WGPUShaderModule shaderModule_;
-        WGPUVertexBufferLayout vertexBufferLayout_;
-        WGPUVertexAttribute positionAttrib_;
-		WGPUVertexAttribute uvAttrib_;
-        WGPUVertexAttribute attributes_[2];
+		PipelineCache::RenderPipelineRef pipeline_; // Shared by every Quad2DPipeline of the same configuration
+		BindGroupCache::BindGroupRef bindGroup_; // Shared through the BindGroupCache
+        uint64_t vertexStride_ = 0;
+        Buffer::VertexEncoding encoding_ = Buffer::VertexEncoding::Float32;
 
-        // WebGPU resources
-        WGPUBindGroupLayoutEntry bindingLayout_[3]{};
-        WGPURenderPipelineDescriptor pipelineDesc_{};
-        WGPUFragmentState fragmentState_{};
-        WGPUBlendState blendState_{};
-        WGPUColorTargetState colorTarget_{};
-        WGPUBindGroupLayoutDescriptor bindGroupLayoutDesc_{};
+        // WebGPU descriptors; the uniform binding is reused for every texture
         WGPUBindGroupEntry bindings_[3]{};
-        WGPUBindGroupDescriptor bindGroupDesc_{};
-        WGPUPipelineLayoutDescriptor layoutDesc_{};
-
-		void createBindingLayoutDefaults(size_t bufferSize);
-        void createShaderModule();
-		void createVertexPipeline();
-		void createFragmentPipeline();
-		void createBindGroupLayout();
+
+        void acquirePipeline(size_t bufferSize, bool dynamicOffset);
         void createBindGroup(WGPUBuffer uniformBuffer, size_t bufferSize, WGPUTextureView textureView, WGPUSampler sampler);
-		void createPipelineLayout();
-		void createRenderPipeline();
 	};
 }
\ No newline at end of file
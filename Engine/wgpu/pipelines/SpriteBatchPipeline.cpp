@@ -0,0 +1,144 @@
+#include "SpriteBatchPipeline.h"
+
+WGPU::Pipeline::SpriteBatchPipeline::SpriteBatchPipeline(
+	WGPUBuffer uniformBuffer,
+	size_t bufferSize,
+	WGPUTextureView textureView,
+	WGPUSampler sampler,
+	Buffer::VertexEncoding encoding,
+	InstanceFetch fetch,
+	SheetLayout sheet
+) :
+	encoding_(encoding),
+	fetch_(fetch),
+	sheet_(sheet)
+{
+	acquirePipeline(bufferSize); // Get the shared pipeline for this variant
+	createBindGroup(uniformBuffer, bufferSize, textureView, sampler); // Create the bind group
+}
+
+WGPU::Pipeline::SpriteBatchPipeline::~SpriteBatchPipeline()
+{
+	std::cout << "Releasing SpriteBatchPipeline..." << std::endl;
+	bindGroup_.reset(); // Stays cached for other users until evicted or invalidated
+	pipeline_.reset(); // The pipeline itself goes with its last user
+}
+
+WGPUBindGroup WGPU::Pipeline::SpriteBatchPipeline::CreateInstanceBindGroup(WGPUBuffer instanceBuffer, uint64_t size) const
+{
+	if (fetch_ != InstanceFetch::StorageBuffer) {
+		throw std::logic_error("SpriteBatchPipeline: instance bind groups only exist for storage buffer fetch.");
+	}
+
+	WGPUBindGroupEntry entry{};
+	entry.nextInChain = nullptr;
+	entry.binding = 0;
+	entry.buffer = instanceBuffer;
+	entry.offset = 0;
+	entry.size = size;
+
+	WGPUBindGroupDescriptor desc{};
+	desc.nextInChain = nullptr;
+	desc.label = "Sprite instance bind group";
+	desc.layout = pipeline_->GetBindGroupLayout(1);
+	desc.entryCount = 1;
+	desc.entries = &entry;
+	return wgpuDeviceCreateBindGroup(Core::Device(), &desc);
+}
+
+const char* WGPU::Pipeline::SpriteBatchPipeline::GetShaderSource(Buffer::VertexEncoding encoding, InstanceFetch fetch, SheetLayout sheet)
+{
+	// Assembled once per variant; the strings live for the program so reflection can cache them
+	static const std::string sources[2][2][2] = {
+		{
+			{
+				std::string(float32Attributes_) + attributeMain_ + sheet2D_ + shaderBody_,
+				std::string(float32Attributes_) + attributeMain_ + sheetArray_ + shaderBody_
+			},
+			{
+				std::string(float32Storage_) + storageMain_ + sheet2D_ + shaderBody_,
+				std::string(float32Storage_) + storageMain_ + sheetArray_ + shaderBody_
+			}
+		},
+		{
+			{
+				std::string(quantizedAttributes_) + attributeMain_ + sheet2D_ + shaderBody_,
+				std::string(quantizedAttributes_) + attributeMain_ + sheetArray_ + shaderBody_
+			},
+			{
+				std::string(quantizedStorage_) + storageMain_ + sheet2D_ + shaderBody_,
+				std::string(quantizedStorage_) + storageMain_ + sheetArray_ + shaderBody_
+			}
+		}
+	};
+	const size_t encodingIndex = encoding == Buffer::VertexEncoding::Quantized ? 1 : 0;
+	const size_t fetchIndex = fetch == InstanceFetch::StorageBuffer ? 1 : 0;
+	const size_t sheetIndex = sheet == SheetLayout::Texture2DArray ? 1 : 0;
+	return sources[encodingIndex][fetchIndex][sheetIndex].c_str();
+}
+
+/**
+ * Fetches the render pipeline from the PipelineCache, compiling it only if no pipeline
+ * of the same variant is alive.
+ * Buffer slot 0 steps per vertex through the unit quad, buffer slot 1 steps per instance
+ * through the SpriteInstance (or CompactSpriteInstance) array. Storage buffer fetch uses
+ * no vertex buffers. The uniform buffer is checked against the shader before any GPU
+ * object refers to it.
+ *
+ * @param bufferSize The size of the uniform buffer to bind.
+ */
+void WGPU::Pipeline::SpriteBatchPipeline::acquirePipeline(size_t bufferSize)
+{
+	const char* source = GetShaderSource(encoding_, fetch_, sheet_);
+	Shader::ShaderReflection::Reflect(source)->ValidateBindingSize(0, 0, bufferSize);
+
+	RenderPipelineState state;
+	state.label = "Sprite batch pipeline";
+	state.shaderSource = source;
+	state.targetFormat = Surface::Format();
+
+	if (fetch_ == InstanceFetch::VertexAttributes) {
+		if (encoding_ == Buffer::VertexEncoding::Quantized) {
+			state.vertexBuffers.push_back(VertexBufferState::FromLayout<CompactQuadLayout>());
+			state.vertexBuffers.push_back(VertexBufferState::FromLayout<CompactInstanceLayout>(CompactQuadLayout::AttributeCount, WGPUVertexStepMode_Instance));
+		}
+		else {
+			// Unit quad: locations 0-1, sprite instance: locations 2-6
+			state.vertexBuffers.push_back(VertexBufferState::FromLayout<QuadLayout>());
+			state.vertexBuffers.push_back(VertexBufferState::FromLayout<InstanceLayout>(QuadLayout::AttributeCount, WGPUVertexStepMode_Instance));
+		}
+	}
+
+	pipeline_ = PipelineCache::AcquireRenderPipeline(state);
+}
+
+/**
+ * Acquires the bind group shared by every sprite in the batch, and by every other batch
+ * drawing the same sheet with the same uniforms.
+ *
+ * @param uniformBuffer The uniform buffer holding the projection.
+ * @param bufferSize The size of the uniform buffer.
+ * @param textureView The sprite sheet texture view; a 2D array view for SheetLayout::Texture2DArray.
+ * @param sampler The sampler to bind.
+ */
+void WGPU::Pipeline::SpriteBatchPipeline::createBindGroup(WGPUBuffer uniformBuffer, size_t bufferSize, WGPUTextureView textureView, WGPUSampler sampler)
+{
+	// Uniform buffer
+	bindings_[0].nextInChain = nullptr;
+	bindings_[0].binding = 0;
+	bindings_[0].buffer = uniformBuffer;
+	bindings_[0].offset = 0;
+	bindings_[0].size = bufferSize;
+
+	// Texture
+	bindings_[1].nextInChain = nullptr;
+	bindings_[1].binding = 1;
+	bindings_[1].textureView = textureView;
+
+	// Sampler
+	bindings_[2].nextInChain = nullptr;
+	bindings_[2].binding = 2;
+	bindings_[2].sampler = sampler;
+
+	bindGroup_ = BindGroupCache::Acquire(pipeline_->GetBindGroupLayout(0), bindings_, "Sprite batch bind group");
+}
@@ -0,0 +1,318 @@
+#pragma once
+
+#include <webgpu/webgpu.h>
+#include <glm/glm.hpp>
+#include <array>
+#include <cstddef>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+
+#include <core/Core.h>
+#include <core/Surface.h>
+#include <wgpu/shader/ShaderReflection.h>
+#include <wgpu/buffer/SpriteInstance.h>
+#include <wgpu/buffer/VertexLayout.h>
+#include <wgpu/buffer/VertexPacking.h>
+
+#include "BindGroupCache.h"
+#include "PipelineCache.h"
+
+namespace WGPU::Pipeline {
+	/**
+	 * Instanced variant of the Quad2D pipeline.
+	 *
+	 * Slot 0 carries the shared unit quad (position + UV per vertex), slot 1 carries
+	 * one SpriteInstance per sprite. The uniform buffer only holds the projection. The
+	 * render pipeline comes from the PipelineCache, so batches of the same variant share it.
+	 *
+	 * With VertexEncoding::Quantized the slots carry CompactVertex2D and
+	 * CompactSpriteInstance instead (8 and 24 bytes rather than 16 and 64), and the
+	 * shader is built with the matching instance inputs.
+	 *
+	 * With InstanceFetch::StorageBuffer there are no vertex buffers at all: the quad
+	 * corners come from the vertex index and the instances are read from a storage
+	 * buffer bound at group 1 (see CreateInstanceBindGroup), six vertices per sprite.
+	 *
+	 * With SheetLayout::Texture2DArray the sheet is bound as a texture_2d_array and every
+	 * sprite samples the layer in its SpriteInstance::layer. Same-sized frames then share
+	 * one texture and one bind group, and switching frames only changes instance data.
+	 */
+	class SpriteBatchPipeline {
+	public:
+		/**
+		 * Where the vertex shader gets each sprite from.
+		 */
+		enum class InstanceFetch : uint8_t {
+			VertexAttributes, // Instanced vertex buffers, drawn with DrawIndexed over the unit quad
+			StorageBuffer     // Vertex pulling, drawn with Draw(6 * count)
+		};
+
+		/**
+		 * How the sprite sheet at group 0, binding 1 is bound.
+		 */
+		enum class SheetLayout : uint8_t {
+			Texture2D,     // One image; SpriteInstance::layer is ignored
+			Texture2DArray // Sampled at SpriteInstance::layer
+		};
+
+		static constexpr uint32_t VerticesPerSprite = 6;
+
+		// Unit quad: position, UV
+		using QuadLayout = Buffer::VertexLayout<glm::vec2, glm::vec2>;
+
+		// SpriteInstance: position, size, rotation and layer, padding, uvRect, tint. Rotation
+		// and layer are fetched as one Uint32x2 and the rotation is bitcast back to f32, which
+		// keeps the same locations as the quantized layout
+		using InstanceLayout = Buffer::VertexLayout<
+			glm::vec2,
+			glm::vec2,
+			Buffer::VertexAttr<WGPUVertexFormat_Uint32x2>,
+			Buffer::VertexPad<8>,
+			glm::vec4,
+			glm::vec4
+		>;
+
+		static_assert(InstanceLayout::Stride == sizeof(Buffer::SpriteInstance), "InstanceLayout does not match SpriteInstance.");
+		static_assert(InstanceLayout::Offsets[2] == offsetof(Buffer::SpriteInstance, rotation), "InstanceLayout does not match SpriteInstance.");
+		static_assert(InstanceLayout::Offsets[3] == offsetof(Buffer::SpriteInstance, uvRect), "InstanceLayout does not match SpriteInstance.");
+		static_assert(InstanceLayout::Offsets[4] == offsetof(Buffer::SpriteInstance, tint), "InstanceLayout does not match SpriteInstance.");
+
+		// Quantized variants: Snorm16 / Unorm16 quad, and CompactSpriteInstance
+		using CompactQuadLayout = Buffer::CompactVertex2DLayout;
+		using CompactInstanceLayout = Buffer::VertexLayout<
+			Buffer::VertexAttr<WGPUVertexFormat_Sint16x2>,  // position
+			Buffer::VertexAttr<WGPUVertexFormat_Float16x2>, // size
+			Buffer::VertexAttr<WGPUVertexFormat_Float16x2>, // rotation, layer
+			Buffer::VertexAttr<WGPUVertexFormat_Unorm16x4>, // uvRect
+			Buffer::VertexAttr<WGPUVertexFormat_Unorm8x4>   // tint
+		>;
+
+		static_assert(CompactInstanceLayout::Stride == sizeof(Buffer::CompactSpriteInstance), "CompactInstanceLayout does not match CompactSpriteInstance.");
+		static_assert(CompactInstanceLayout::Offsets[3] == offsetof(Buffer::CompactSpriteInstance, uvRect), "CompactInstanceLayout does not match CompactSpriteInstance.");
+		static_assert(CompactInstanceLayout::Offsets[4] == offsetof(Buffer::CompactSpriteInstance, tint), "CompactInstanceLayout does not match CompactSpriteInstance.");
+		static_assert(QuadLayout::AttributeCount == CompactQuadLayout::AttributeCount, "Both encodings must use the same locations.");
+		static_assert(InstanceLayout::AttributeCount == CompactInstanceLayout::AttributeCount, "Both encodings must use the same locations.");
+
+		SpriteBatchPipeline(
+			WGPUBuffer uniformBuffer,
+			size_t bufferSize,
+			WGPUTextureView textureView,
+			WGPUSampler sampler,
+			Buffer::VertexEncoding encoding = Buffer::VertexEncoding::Float32,
+			InstanceFetch fetch = InstanceFetch::VertexAttributes,
+			SheetLayout sheet = SheetLayout::Texture2D
+		);
+		~SpriteBatchPipeline();
+
+		WGPURenderPipeline GetPipeline() const { return pipeline_->handle; }
+		WGPUBindGroup GetBindGroup() const { return bindGroup_->handle; }
+		Buffer::VertexEncoding GetEncoding() const { return encoding_; }
+		InstanceFetch GetFetch() const { return fetch_; }
+		SheetLayout GetSheetLayout() const { return sheet_; }
+
+		/**
+		 * @brief Creates the group 1 bind group exposing an instance buffer to a
+		 * StorageBuffer pipeline. The caller owns the result.
+		 *
+		 * @param instanceBuffer A buffer created with Storage usage.
+		 * @param size Bytes to bind; at least one instance.
+		 */
+		WGPUBindGroup CreateInstanceBindGroup(WGPUBuffer instanceBuffer, uint64_t size) const;
+
+		/**
+		 * @brief The WGSL source for the given variant. All variants share the bindings of
+		 * group 0, up to the sheet's texture type, and differ only in how the vertex shader
+		 * obtains a sprite.
+		 */
+		static const char* GetShaderSource(
+			Buffer::VertexEncoding encoding = Buffer::VertexEncoding::Float32,
+			InstanceFetch fetch = InstanceFetch::VertexAttributes,
+			SheetLayout sheet = SheetLayout::Texture2D
+		);
+	private:
+		/*============================================================
+		* SHADER VARIANTS
+		=============================================================*/
+		// A variant is one instance source (attributes or storage, per encoding), its
+		// vs_main, a sheet binding, and the shared body. Each source supplies a load that
+		// turns its input into a Sprite for sprite_vertex(); each sheet supplies the
+		// sample_sheet() used by fs_main.
+
+		// Full precision attributes; decoding is the identity but for the rotation bits
+		static constexpr const char* float32Attributes_ = R"(
+			struct InstanceInput {
+				@location(2) position: vec2f,
+				@location(3) size: vec2f,
+				@location(4) rotation_layer: vec2<u32>,
+				@location(5) uv_rect: vec4f,
+				@location(6) tint: vec4f
+			};
+
+			fn load_instance(instance: InstanceInput) -> Sprite {
+				let rotation = bitcast<f32>(instance.rotation_layer.x);
+				return Sprite(instance.position, instance.size, rotation, instance.rotation_layer.y, instance.uv_rect, instance.tint);
+			}
+		)";
+
+		// CompactSpriteInstance: the vertex fetch already expands the normalized and half
+		// formats to f32, leaving only the integer position and the rotation / layer lane to decode
+		static constexpr const char* quantizedAttributes_ = R"(
+			struct InstanceInput {
+				@location(2) position: vec2<i32>,
+				@location(3) size: vec2f,
+				@location(4) rotation: vec2f,
+				@location(5) uv_rect: vec4f,
+				@location(6) tint: vec4f
+			};
+
+			fn load_instance(instance: InstanceInput) -> Sprite {
+				return Sprite(vec2f(instance.position), instance.size, instance.rotation.x, u32(instance.rotation.y), instance.uv_rect, instance.tint);
+			}
+		)";
+
+		static constexpr const char* attributeMain_ = R"(
+			@vertex
+			fn vs_main(
+				@location(0) in_vertex_position: vec2f,
+				@location(1) in_uv: vec2f,
+				instance: InstanceInput
+			) -> VertexOutput {
+				return sprite_vertex(in_vertex_position, in_uv, load_instance(instance));
+			}
+		)";
+
+		// SpriteInstance as laid out in host memory: WGSL pads layer up to the
+		// 16-byte aligned uv_rect exactly like the C++ struct does
+		static constexpr const char* float32Storage_ = R"(
+			struct SpriteData {
+				position: vec2f,
+				size: vec2f,
+				rotation: f32,
+				layer: u32,
+				uv_rect: vec4f,
+				tint: vec4f
+			};
+
+			@group(1) @binding(0) var<storage, read> sprites: array<SpriteData>;
+
+			fn load_sprite(index: u32) -> Sprite {
+				let data = sprites[index];
+				return Sprite(data.position, data.size, data.rotation, data.layer, data.uv_rect, data.tint);
+			}
+		)";
+
+		// CompactSpriteInstance as six words, unpacked by hand since storage buffers have
+		// no format conversion
+		static constexpr const char* quantizedStorage_ = R"(
+			struct SpriteData {
+				position: u32,
+				size: u32,
+				rotation: u32,
+				uv_min: u32,
+				uv_max: u32,
+				tint: u32
+			};
+
+			@group(1) @binding(0) var<storage, read> sprites: array<SpriteData>;
+
+			fn load_sprite(index: u32) -> Sprite {
+				let data = sprites[index];
+				// Sign-extend both 16-bit halves; x is the low half
+				let bits = bitcast<i32>(data.position);
+				let position = vec2f(f32((bits << 16u) >> 16u), f32(bits >> 16u));
+				let uv_rect = vec4f(unpack2x16unorm(data.uv_min), unpack2x16unorm(data.uv_max));
+				let rotation = unpack2x16float(data.rotation);
+				return Sprite(position, unpack2x16float(data.size), rotation.x, u32(rotation.y), uv_rect, unpack4x8unorm(data.tint));
+			}
+		)";
+
+		static constexpr const char* storageMain_ = R"(
+			@vertex
+			fn vs_main(@builtin(vertex_index) vertex_index: u32) -> VertexOutput {
+				// Two triangles over the centred unit quad, in the same order as the index
+				// buffer of Utilities::Quad::CreateCentered
+				var corners = array<vec2f, 6>(
+					vec2f(-0.5, -0.5), vec2f(0.5, -0.5), vec2f(-0.5, 0.5),
+					vec2f(-0.5, 0.5), vec2f(0.5, -0.5), vec2f(0.5, 0.5)
+				);
+				let corner = corners[vertex_index % 6u];
+				return sprite_vertex(corner, corner + vec2f(0.5), load_sprite(vertex_index / 6u));
+			}
+		)";
+
+		static constexpr const char* sheet2D_ = R"(
+			@group(0) @binding(1) var spriteTexture: texture_2d<f32>;
+
+			fn sample_sheet(uv: vec2f, layer: u32) -> vec4f {
+				return textureSample(spriteTexture, spriteSampler, uv);
+			}
+		)";
+
+		static constexpr const char* sheetArray_ = R"(
+			@group(0) @binding(1) var spriteTexture: texture_2d_array<f32>;
+
+			fn sample_sheet(uv: vec2f, layer: u32) -> vec4f {
+				return textureSample(spriteTexture, spriteSampler, uv, layer);
+			}
+		)";
+
+		static constexpr const char* shaderBody_ = R"(
+			struct Uniforms {
+				Projection: mat4x4<f32>           // Offset: 0, Size: 64 bytes
+			}
+
+			@group(0) @binding(0) var<uniform> uniforms: Uniforms;
+			@group(0) @binding(2) var spriteSampler: sampler;
+
+			struct Sprite {
+				position: vec2f,
+				size: vec2f,
+				rotation: f32,
+				layer: u32,
+				uv_rect: vec4f,
+				tint: vec4f
+			};
+
+			struct VertexOutput {
+				@builtin(position) position: vec4f,
+				@location(0) uv: vec2f,
+				@location(1) tint: vec4f,
+				@location(2) @interpolate(flat) layer: u32
+			};
+
+			fn sprite_vertex(corner: vec2f, uv: vec2f, sprite: Sprite) -> VertexOutput {
+				// Scale the unit quad, rotate it around its centre, then move it into place
+				let scaled = corner * sprite.size;
+				let c = cos(sprite.rotation);
+				let s = sin(sprite.rotation);
+				let rotated = vec2f(scaled.x * c - scaled.y * s, scaled.x * s + scaled.y * c);
+
+				var output: VertexOutput;
+				output.position = uniforms.Projection * vec4f(rotated + sprite.position, 0.0, 1.0);
+				output.uv = mix(sprite.uv_rect.xy, sprite.uv_rect.zw, uv);
+				output.tint = sprite.tint;
+				output.layer = sprite.layer;
+				return output;
+			}
+
+			@fragment
+			fn fs_main(in: VertexOutput) -> @location(0) vec4f {
+				return sample_sheet(in.uv, in.layer) * in.tint;
+			}
+		)";
+
+		// WebGPU resources
+		PipelineCache::RenderPipelineRef pipeline_; // Shared by every SpriteBatchPipeline of the same variant
+		BindGroupCache::BindGroupRef bindGroup_; // Shared through the BindGroupCache
+		Buffer::VertexEncoding encoding_ = Buffer::VertexEncoding::Float32;
+		InstanceFetch fetch_ = InstanceFetch::VertexAttributes;
+		SheetLayout sheet_ = SheetLayout::Texture2D;
+
+		// WebGPU descriptors
+		WGPUBindGroupEntry bindings_[3]{};
+
+		void acquirePipeline(size_t bufferSize);
+		void createBindGroup(WGPUBuffer uniformBuffer, size_t bufferSize, WGPUTextureView textureView, WGPUSampler sampler);
+	};
+}
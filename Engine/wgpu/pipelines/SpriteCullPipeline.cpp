@@ -0,0 +1,121 @@
+#include "SpriteCullPipeline.h"
+
+WGPU::Pipeline::SpriteCullPipeline::SpriteCullPipeline()
+{
+	createShaderModule(); // Load and create the shader module
+	createPipeline(); // Bind group layout from the shader, pipeline layout and compute pipeline
+
+	wgpuShaderModuleRelease(shaderModule_); // Release the shader module after pipeline creation
+	shaderModule_ = nullptr;
+}
+
+WGPU::Pipeline::SpriteCullPipeline::~SpriteCullPipeline()
+{
+	std::cout << "Releasing SpriteCullPipeline..." << std::endl;
+	if (pipeline_) {
+		wgpuComputePipelineRelease(pipeline_);
+		pipeline_ = nullptr;
+	}
+	if (layout_) {
+		wgpuPipelineLayoutRelease(layout_);
+		layout_ = nullptr;
+	}
+	if (bindGroupLayout_) {
+		wgpuBindGroupLayoutRelease(bindGroupLayout_);
+		bindGroupLayout_ = nullptr;
+	}
+}
+
+WGPUBindGroup WGPU::Pipeline::SpriteCullPipeline::CreateBindGroup(
+	WGPUBuffer uniformBuffer,
+	size_t uniformSize,
+	WGPUBuffer instances,
+	WGPUBuffer visible,
+	WGPUBuffer indirectArgs,
+	uint64_t instanceBytes
+) const
+{
+	Shader::ShaderReflection::Reflect(shaderSource_)->ValidateBindingSize(0, 0, uniformSize);
+
+	WGPUBindGroupEntry entries[4] = {};
+
+	// Cull uniforms
+	entries[0].nextInChain = nullptr;
+	entries[0].binding = 0;
+	entries[0].buffer = uniformBuffer;
+	entries[0].offset = 0;
+	entries[0].size = uniformSize;
+
+	// Every sprite of the layer
+	entries[1].nextInChain = nullptr;
+	entries[1].binding = 1;
+	entries[1].buffer = instances;
+	entries[1].offset = 0;
+	entries[1].size = instanceBytes;
+
+	// Survivors, read as instance vertex data by the draw
+	entries[2].nextInChain = nullptr;
+	entries[2].binding = 2;
+	entries[2].buffer = visible;
+	entries[2].offset = 0;
+	entries[2].size = instanceBytes;
+
+	// Indirect draw arguments
+	entries[3].nextInChain = nullptr;
+	entries[3].binding = 3;
+	entries[3].buffer = indirectArgs;
+	entries[3].offset = 0;
+	entries[3].size = IndirectArgsSize;
+
+	WGPUBindGroupDescriptor desc{};
+	desc.nextInChain = nullptr;
+	desc.label = "Sprite cull bind group";
+	desc.layout = bindGroupLayout_;
+	desc.entryCount = 4;
+	desc.entries = entries;
+	return wgpuDeviceCreateBindGroup(Core::Device(), &desc);
+}
+
+/**
+ * Loads and creates the shader module used for the pipeline.
+ */
+void WGPU::Pipeline::SpriteCullPipeline::createShaderModule()
+{
+	WGPUShaderModuleDescriptor shaderDesc{};
+
+	WGPUShaderModuleWGSLDescriptor shaderCodeDesc{};
+	shaderCodeDesc.chain.next = nullptr;
+	shaderCodeDesc.chain.sType = WGPUSType_ShaderModuleWGSLDescriptor;
+	shaderDesc.nextInChain = &shaderCodeDesc.chain;
+	shaderCodeDesc.code = shaderSource_;
+
+	shaderModule_ = wgpuDeviceCreateShaderModule(Core::Device(), &shaderDesc);
+}
+
+/**
+ * Creates the bind group layout from the reflected shader, the pipeline layout and the
+ * compute pipeline.
+ */
+void WGPU::Pipeline::SpriteCullPipeline::createPipeline()
+{
+	bindGroupLayout_ = Shader::ShaderReflection::Reflect(shaderSource_)->CreateBindGroupLayout(0);
+
+	WGPUPipelineLayoutDescriptor layoutDesc{};
+	layoutDesc.nextInChain = nullptr;
+	layoutDesc.bindGroupLayoutCount = 1;
+	layoutDesc.bindGroupLayouts = &bindGroupLayout_;
+	layout_ = wgpuDeviceCreatePipelineLayout(Core::Device(), &layoutDesc);
+
+	WGPUComputePipelineDescriptor pipelineDesc{};
+	pipelineDesc.nextInChain = nullptr;
+	pipelineDesc.label = "Sprite cull pipeline";
+	pipelineDesc.layout = layout_;
+	pipelineDesc.compute.module = shaderModule_;
+	pipelineDesc.compute.entryPoint = "cs_main";
+	pipelineDesc.compute.constantCount = 0;
+	pipelineDesc.compute.constants = nullptr;
+	pipeline_ = wgpuDeviceCreateComputePipeline(Core::Device(), &pipelineDesc);
+	if (!pipeline_) {
+		throw std::runtime_error("Failed to create sprite cull pipeline.");
+	}
+}
@@ -0,0 +1,125 @@
+#pragma once
+
+#include <webgpu/webgpu.h>
+#include <iostream>
+#include <stdexcept>
+
+#include <core/Core.h>
+#include <wgpu/shader/ShaderReflection.h>
+
+namespace WGPU::Pipeline {
+	/**
+	 * Compute pipeline that culls SpriteInstances against a view rectangle.
+	 *
+	 * One invocation per sprite tests the sprite's bounds (the circle through its corners
+	 * when rotated) against the rectangle. Survivors are appended to an output array with
+	 * an atomicAdd on the instanceCount of a DrawIndexedIndirect argument block, which the
+	 * render pass then draws with wgpuRenderPassEncoderDrawIndexedIndirect.
+	 *
+	 * The output is compacted, not ordered: survivors from different workgroups land in
+	 * whatever order the atomics resolve. Cull layers whose sprites do not depend on
+	 * painter's order among themselves.
+	 */
+	class SpriteCullPipeline {
+	public:
+		static constexpr uint32_t WorkgroupSize = 64;
+
+		// DrawIndexedIndirect arguments: indexCount, instanceCount, firstIndex, baseVertex, firstInstance
+		static constexpr uint64_t IndirectArgsSize = 5 * sizeof(uint32_t);
+		static constexpr uint64_t InstanceCountOffset = sizeof(uint32_t);
+
+		SpriteCullPipeline();
+		~SpriteCullPipeline();
+
+		SpriteCullPipeline(const SpriteCullPipeline&) = delete;
+		SpriteCullPipeline& operator=(const SpriteCullPipeline&) = delete;
+
+		WGPUComputePipeline GetPipeline() const { return pipeline_; }
+
+		/**
+		 * @brief Creates the bind group for one set of buffers. The caller owns the result.
+		 *
+		 * @param uniformBuffer Buffer holding the cull uniforms.
+		 * @param uniformSize Size of the cull uniforms.
+		 * @param instances Storage buffer with the SpriteInstances to test.
+		 * @param visible Storage buffer the survivors are written to, as large as instances.
+		 * @param indirectArgs Storage | Indirect buffer with the draw arguments.
+		 * @param instanceBytes Bytes to bind of instances and visible; at least one instance.
+		 */
+		WGPUBindGroup CreateBindGroup(
+			WGPUBuffer uniformBuffer,
+			size_t uniformSize,
+			WGPUBuffer instances,
+			WGPUBuffer visible,
+			WGPUBuffer indirectArgs,
+			uint64_t instanceBytes
+		) const;
+
+		static const char* GetShaderSource() { return shaderSource_; }
+	private:
+		// SpriteData is SpriteInstance as laid out in host memory, as in SpriteBatchPipeline
+		static constexpr const char* shaderSource_ = R"(
+			struct SpriteData {
+				position: vec2f,
+				size: vec2f,
+				rotation: f32,
+				layer: u32,
+				uv_rect: vec4f,
+				tint: vec4f
+			};
+
+			struct CullUniforms {
+				viewMin: vec2f,
+				viewMax: vec2f,
+				count: u32,
+				margin: f32
+			};
+
+			struct DrawArgs {
+				indexCount: u32,
+				instanceCount: atomic<u32>,
+				firstIndex: u32,
+				baseVertex: i32,
+				firstInstance: u32
+			};
+
+			@group(0) @binding(0) var<uniform> cull: CullUniforms;
+			@group(0) @binding(1) var<storage, read> sprites: array<SpriteData>;
+			@group(0) @binding(2) var<storage, read_write> visible: array<SpriteData>;
+			@group(0) @binding(3) var<storage, read_write> args: DrawArgs;
+
+			@compute @workgroup_size(64)
+			fn cs_main(@builtin(global_invocation_id) id: vec3<u32>) {
+				let index = id.x;
+				if (index >= cull.count) {
+					return;
+				}
+
+				// The quad is centred on position; rotated, it stays inside the circle through its corners
+				let sprite = sprites[index];
+				var extent = abs(sprite.size) * 0.5;
+				if (sprite.rotation != 0.0) {
+					extent = vec2f(length(extent));
+				}
+
+				let low = sprite.position - extent;
+				let high = sprite.position + extent;
+				if (any(high < cull.viewMin - vec2f(cull.margin)) || any(low > cull.viewMax + vec2f(cull.margin))) {
+					return;
+				}
+
+				let slot = atomicAdd(&args.instanceCount, 1u);
+				visible[slot] = sprite;
+			}
+		)";
+
+		// WebGPU resources
+		WGPUComputePipeline pipeline_ = nullptr;
+		WGPUPipelineLayout layout_ = nullptr;
+		WGPUBindGroupLayout bindGroupLayout_ = nullptr;
+		WGPUShaderModule shaderModule_ = nullptr;
+
+		void createShaderModule();
+		void createPipeline();
+	};
+}
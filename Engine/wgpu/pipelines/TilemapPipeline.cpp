@@ -0,0 +1,179 @@
+#include "TilemapPipeline.h"
+
+WGPU::Pipeline::TilemapPipeline::TilemapPipeline(
+	WGPUBuffer uniformBuffer,
+	size_t bufferSize,
+	WGPUTextureView tileIndexView,
+	WGPUTextureView tilesetView
+)
+{
+	pipelineDesc_.nextInChain = nullptr;
+
+	createShaderModule(); // Load and create the shader module
+	createVertexPipeline(); // No vertex buffers, the triangle comes from the vertex index
+	createFragmentPipeline(); // Configure the fragment pipeline
+	createBindGroupLayout(bufferSize); // Create the bind group layout from the shader
+	createBindGroup(uniformBuffer, bufferSize, tileIndexView, tilesetView); // Create the bind group
+	createPipelineLayout(); // Create the pipeline layout
+	createRenderPipeline(); // Create the render pipeline
+
+	wgpuShaderModuleRelease(shaderModule_); // Release the shader module after pipeline creation
+	shaderModule_ = nullptr;
+}
+
+WGPU::Pipeline::TilemapPipeline::~TilemapPipeline()
+{
+	std::cout << "Releasing TilemapPipeline..." << std::endl;
+	if (pipeline_) {
+		wgpuRenderPipelineRelease(pipeline_);
+		pipeline_ = nullptr;
+	}
+	if (layout_) {
+		wgpuPipelineLayoutRelease(layout_);
+		layout_ = nullptr;
+	}
+	if (bindGroupLayout_) {
+		wgpuBindGroupLayoutRelease(bindGroupLayout_);
+		bindGroupLayout_ = nullptr;
+	}
+	if (bindGroup_) {
+		wgpuBindGroupRelease(bindGroup_);
+		bindGroup_ = nullptr;
+	}
+}
+
+/**
+ * Loads and creates the shader module used for the pipeline.
+ */
+void WGPU::Pipeline::TilemapPipeline::createShaderModule()
+{
+	WGPUShaderModuleDescriptor shaderDesc{};
+
+	WGPUShaderModuleWGSLDescriptor shaderCodeDesc{};
+	shaderCodeDesc.chain.next = nullptr;
+	shaderCodeDesc.chain.sType = WGPUSType_ShaderModuleWGSLDescriptor;
+	shaderDesc.nextInChain = &shaderCodeDesc.chain;
+	shaderCodeDesc.code = shaderSource_;
+
+	shaderModule_ = wgpuDeviceCreateShaderModule(Core::Device(), &shaderDesc);
+}
+
+/**
+ * Configures the vertex pipeline. Nothing goes through input assembly.
+ */
+void WGPU::Pipeline::TilemapPipeline::createVertexPipeline()
+{
+	pipelineDesc_.vertex.bufferCount = 0;
+	pipelineDesc_.vertex.buffers = nullptr;
+	pipelineDesc_.vertex.module = shaderModule_;
+	pipelineDesc_.vertex.entryPoint = "vs_main";
+	pipelineDesc_.vertex.constantCount = 0;
+	pipelineDesc_.vertex.constants = nullptr;
+
+	pipelineDesc_.primitive.topology = WGPUPrimitiveTopology_TriangleList;
+	pipelineDesc_.primitive.stripIndexFormat = WGPUIndexFormat_Undefined;
+	pipelineDesc_.primitive.frontFace = WGPUFrontFace_CCW;
+	pipelineDesc_.primitive.cullMode = WGPUCullMode_None;
+}
+
+/**
+ * Configures the fragment pipeline.
+ * Layers blend over each other and over whatever was drawn before them.
+ */
+void WGPU::Pipeline::TilemapPipeline::createFragmentPipeline()
+{
+	fragmentState_.module = shaderModule_;
+	fragmentState_.entryPoint = "fs_main";
+	fragmentState_.constantCount = 0;
+	fragmentState_.constants = nullptr;
+
+	blendState_.color.srcFactor = WGPUBlendFactor_SrcAlpha;
+	blendState_.color.dstFactor = WGPUBlendFactor_OneMinusSrcAlpha;
+	blendState_.color.operation = WGPUBlendOperation_Add;
+	blendState_.alpha.srcFactor = WGPUBlendFactor_Zero;
+	blendState_.alpha.dstFactor = WGPUBlendFactor_One;
+	blendState_.alpha.operation = WGPUBlendOperation_Add;
+
+	colorTarget_.format = Surface::Format();
+	colorTarget_.blend = &blendState_;
+	colorTarget_.writeMask = WGPUColorWriteMask_All;
+
+	fragmentState_.targetCount = 1;
+	fragmentState_.targets = &colorTarget_;
+	pipelineDesc_.fragment = &fragmentState_;
+}
+
+/**
+ * Creates the bind group layout for the pipeline from the reflected shader.
+ * The uniform buffer is checked against the shader before any GPU object refers to it.
+ *
+ * @param bufferSize The size of the uniform buffer to bind.
+ */
+void WGPU::Pipeline::TilemapPipeline::createBindGroupLayout(size_t bufferSize)
+{
+	const auto reflection = Shader::ShaderReflection::Reflect(shaderSource_);
+	reflection->ValidateBindingSize(0, 0, bufferSize);
+	bindGroupLayout_ = reflection->CreateBindGroupLayout(0);
+}
+
+/**
+ * Creates the bind group shared by every layer.
+ *
+ * @param uniformBuffer The uniform buffer holding camera, tile and map sizes.
+ * @param bufferSize The size of the uniform buffer.
+ * @param tileIndexView 2D array view of the R16Uint tile index texture.
+ * @param tilesetView The tileset texture view.
+ */
+void WGPU::Pipeline::TilemapPipeline::createBindGroup(WGPUBuffer uniformBuffer, size_t bufferSize, WGPUTextureView tileIndexView, WGPUTextureView tilesetView)
+{
+	// Uniform buffer
+	bindings_[0].nextInChain = nullptr;
+	bindings_[0].binding = 0;
+	bindings_[0].buffer = uniformBuffer;
+	bindings_[0].offset = 0;
+	bindings_[0].size = bufferSize;
+
+	// Tile indices
+	bindings_[1].nextInChain = nullptr;
+	bindings_[1].binding = 1;
+	bindings_[1].textureView = tileIndexView;
+
+	// Tileset
+	bindings_[2].nextInChain = nullptr;
+	bindings_[2].binding = 2;
+	bindings_[2].textureView = tilesetView;
+
+	bindGroupDesc_.nextInChain = nullptr;
+	bindGroupDesc_.label = "Tilemap bind group";
+	bindGroupDesc_.layout = bindGroupLayout_;
+	bindGroupDesc_.entryCount = 3;
+	bindGroupDesc_.entries = bindings_;
+	bindGroup_ = wgpuDeviceCreateBindGroup(Core::Device(), &bindGroupDesc_);
+}
+
+/**
+ * Creates the pipeline layout for the pipeline.
+ */
+void WGPU::Pipeline::TilemapPipeline::createPipelineLayout()
+{
+	layoutDesc_.nextInChain = nullptr;
+	layoutDesc_.bindGroupLayoutCount = 1;
+	layoutDesc_.bindGroupLayouts = &bindGroupLayout_;
+	layout_ = wgpuDeviceCreatePipelineLayout(Core::Device(), &layoutDesc_);
+}
+
+/**
+ * Creates the render pipeline.
+ */
+void WGPU::Pipeline::TilemapPipeline::createRenderPipeline()
+{
+	pipelineDesc_.depthStencil = nullptr;
+	pipelineDesc_.multisample.count = 1;
+	pipelineDesc_.multisample.mask = ~0u;
+	pipelineDesc_.multisample.alphaToCoverageEnabled = false;
+	pipelineDesc_.layout = layout_;
+	pipeline_ = wgpuDeviceCreateRenderPipeline(Core::Device(), &pipelineDesc_);
+	if (!pipeline_) {
+		throw std::runtime_error("Failed to create tilemap pipeline.");
+	}
+}
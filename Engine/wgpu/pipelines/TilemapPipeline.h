@@ -0,0 +1,119 @@
+#pragma once
+
+#include <webgpu/webgpu.h>
+#include <iostream>
+#include <stdexcept>
+
+#include <core/Core.h>
+#include <core/Surface.h>
+#include <wgpu/shader/ShaderReflection.h>
+
+namespace WGPU::Pipeline {
+	/**
+	 * Draws a tile map as one triangle covering the whole target, per layer.
+	 *
+	 * The map lives in an R16Uint 2D array texture, one array layer per map layer, one
+	 * texel per tile. The fragment shader finds the tile under each pixel, reads its index
+	 * and copies the matching texel from the tileset with textureLoad, so no filtering or
+	 * UV rounding ever reaches across a tile edge. Index 0 is an empty tile; index n is
+	 * the (n - 1)th tile of the tileset, row-major.
+	 *
+	 * The layer comes from the instance index: Draw(3, 1, 0, layer) draws one layer, and
+	 * Draw(3, layerCount, 0, 0) draws all of them bottom to top.
+	 */
+	class TilemapPipeline {
+	public:
+		TilemapPipeline(
+			WGPUBuffer uniformBuffer,
+			size_t bufferSize,
+			WGPUTextureView tileIndexView,
+			WGPUTextureView tilesetView
+		);
+		~TilemapPipeline();
+
+		TilemapPipeline(const TilemapPipeline&) = delete;
+		TilemapPipeline& operator=(const TilemapPipeline&) = delete;
+
+		WGPURenderPipeline GetPipeline() const { return pipeline_; }
+		WGPUBindGroup GetBindGroup() const { return bindGroup_; }
+
+		static const char* GetShaderSource() { return shaderSource_; }
+	private:
+		static constexpr const char* shaderSource_ = R"(
+			struct Uniforms {
+				camera: vec2f,
+				tileSize: vec2f,
+				mapSize: vec2f,
+				atlasSize: vec2f
+			};
+
+			@group(0) @binding(0) var<uniform> uniforms: Uniforms;
+			@group(0) @binding(1) var tileIndices: texture_2d_array<u32>;
+			@group(0) @binding(2) var tileset: texture_2d<f32>;
+
+			struct VertexOutput {
+				@builtin(position) position: vec4f,
+				@location(0) @interpolate(flat) layer: u32
+			};
+
+			@vertex
+			fn vs_main(@builtin(vertex_index) vertex_index: u32, @builtin(instance_index) layer: u32) -> VertexOutput {
+				// Triangle with corners (-1,-1), (3,-1), (-1,3): covers the target in one draw
+				let corner = vec2f(f32((vertex_index << 1u) & 2u), f32(vertex_index & 2u));
+
+				var output: VertexOutput;
+				output.position = vec4f(corner * 2.0 - 1.0, 0.0, 1.0);
+				output.layer = layer;
+				return output;
+			}
+
+			@fragment
+			fn fs_main(in: VertexOutput) -> @location(0) vec4f {
+				// Map pixel under this fragment; position.xy is the pixel centre in the target
+				let pixel = floor(in.position.xy) + uniforms.camera;
+				let tile = floor(pixel / uniforms.tileSize);
+				if (any(tile < vec2f(0.0)) || any(tile >= uniforms.mapSize)) {
+					discard;
+				}
+
+				let index = textureLoad(tileIndices, vec2<i32>(tile), i32(in.layer), 0).r;
+				if (index == 0u) {
+					discard;
+				}
+
+				let columns = u32(uniforms.atlasSize.x);
+				let cell = vec2f(f32((index - 1u) % columns), f32((index - 1u) / columns));
+				let texel = cell * uniforms.tileSize + (pixel - tile * uniforms.tileSize);
+				let color = textureLoad(tileset, vec2<i32>(texel), 0);
+				if (color.a == 0.0) {
+					discard;
+				}
+				return color;
+			}
+		)";
+
+		// WebGPU resources
+		WGPURenderPipeline pipeline_ = nullptr;
+		WGPUPipelineLayout layout_ = nullptr;
+		WGPUBindGroupLayout bindGroupLayout_ = nullptr;
+		WGPUBindGroup bindGroup_ = nullptr;
+		WGPUShaderModule shaderModule_ = nullptr;
+
+		// WebGPU descriptors
+		WGPURenderPipelineDescriptor pipelineDesc_{};
+		WGPUFragmentState fragmentState_{};
+		WGPUBlendState blendState_{};
+		WGPUColorTargetState colorTarget_{};
+		WGPUBindGroupEntry bindings_[3]{};
+		WGPUBindGroupDescriptor bindGroupDesc_{};
+		WGPUPipelineLayoutDescriptor layoutDesc_{};
+
+		void createShaderModule();
+		void createVertexPipeline();
+		void createFragmentPipeline();
+		void createBindGroupLayout(size_t bufferSize);
+		void createBindGroup(WGPUBuffer uniformBuffer, size_t bufferSize, WGPUTextureView tileIndexView, WGPUTextureView tilesetView);
+		void createPipelineLayout();
+		void createRenderPipeline();
+	};
+}
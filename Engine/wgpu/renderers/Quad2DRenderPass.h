@@ -1,6 +1,12 @@
 #pragma once
 
 #include <webgpu/webgpu.h>
+#include <core/Surface.h>
+#include <span>
+
+#include "RenderQueue.h"
+#include "StaticLayer.h"
+#include "TrackedRenderPass.h"
 
 namespace WGPU::Renderer {
 	class Quad2DRenderPass {
@@ -14,7 +20,9 @@ namespace WGPU::Renderer {
 			WGPUBuffer vertexBuffer,
 			WGPUBuffer indexBuffer,
 			uint32_t indexCount,
-			WGPUBindGroup bindGroup
+			WGPUBindGroup bindGroup,
+			uint32_t firstIndex = 0,
+			int32_t baseVertex = 0
 		) {
 
 			// Create a command encoder for the draw call
@@ -41,45 +49,179 @@ namespace WGPU::Renderer {
 			renderPassDesc.depthStencilAttachment = nullptr;
 			renderPassDesc.timestampWrites = nullptr;
 
-			// Create the render pass and end it immediately (we only clear the screen but do not draw anything)
 			WGPURenderPassEncoder renderPass = wgpuCommandEncoderBeginRenderPass(encoder, &renderPassDesc);
-			// Select which render pipeline to use
-			wgpuRenderPassEncoderSetPipeline(renderPass, pipeline);
-
-			// Set vertex buffer while encoding the render pass
-			wgpuRenderPassEncoderSetVertexBuffer(renderPass, 0, vertexBuffer, 0, wgpuBufferGetSize(vertexBuffer));
+			TrackedRenderPass trackedPass(renderPass);
+			trackedPass.SetPipeline(pipeline);
+			trackedPass.SetVertexBuffer(0, vertexBuffer, 0, wgpuBufferGetSize(vertexBuffer));
 
-			// The second argument must correspond to the choice of uint16_t or uint32_t
+			// The format must correspond to the choice of uint16_t or uint32_t
 			// we've done when creating the index buffer.
-			wgpuRenderPassEncoderSetIndexBuffer(renderPass, indexBuffer, WGPUIndexFormat_Uint16, 0, wgpuBufferGetSize(indexBuffer));
+			trackedPass.SetIndexBuffer(indexBuffer, WGPUIndexFormat_Uint16, 0, wgpuBufferGetSize(indexBuffer));
+			trackedPass.SetBindGroup(0, bindGroup);
+
+			trackedPass.DrawIndexed(indexCount, 1, firstIndex, baseVertex, 0);
+			lastPassStats_ = trackedPass.GetStats();
+			wgpuRenderPassEncoderEnd(renderPass);
+			wgpuRenderPassEncoderRelease(renderPass);
+
+			// Scale the native-resolution scene onto the window
+			bool presentable = Surface::EncodePresent(encoder);
+
+			// Finally encode and submit the render pass
+			WGPUCommandBufferDescriptor cmdBufferDescriptor = {};
+			cmdBufferDescriptor.nextInChain = nullptr;
+			cmdBufferDescriptor.label = "Command buffer";
+			WGPUCommandBuffer command = wgpuCommandEncoderFinish(encoder, &cmdBufferDescriptor);
+			wgpuCommandEncoderRelease(encoder);
+
+			wgpuQueueSubmit(queue, 1, &command);
+			wgpuCommandBufferRelease(command);
+
+			if (presentable) {
+				wgpuSurfacePresent(surface);
+				Surface::Pacer().MarkPresent();
+			}
+		};
+
+		/**
+		 * Draws the same quad once per dynamic offset, binding the bind group a single time
+		 * per draw with the offset of that draw's UniformRing slice. The pipeline has to be
+		 * created with a dynamic-offset uniform binding.
+		 */
+		static void Present(
+			WGPUTextureView targetView,
+			WGPUSurface surface,
+			WGPUDevice device,
+			WGPUQueue queue,
+			WGPURenderPipeline pipeline,
+			WGPUBuffer vertexBuffer,
+			WGPUBuffer indexBuffer,
+			uint32_t indexCount,
+			WGPUBindGroup bindGroup,
+			std::span<const uint32_t> dynamicOffsets
+		) {
+			WGPUCommandEncoderDescriptor encoderDesc = {};
+			encoderDesc.nextInChain = nullptr;
+			encoderDesc.label = "Quad2D dynamic offset encoder";
+			WGPUCommandEncoder encoder = wgpuDeviceCreateCommandEncoder(device, &encoderDesc);
 
-			wgpuRenderPassEncoderSetBindGroup(renderPass, 0, bindGroup, 0, nullptr);
+			WGPURenderPassDescriptor renderPassDesc = {};
+			renderPassDesc.nextInChain = nullptr;
 
-			wgpuRenderPassEncoderDrawIndexed(renderPass, indexCount, 1, 0, 0, 0);
+			WGPURenderPassColorAttachment renderPassColorAttachment = {};
+			renderPassColorAttachment.view = targetView;
+			renderPassColorAttachment.resolveTarget = nullptr;
+			renderPassColorAttachment.loadOp = WGPULoadOp_Clear;
+			renderPassColorAttachment.storeOp = WGPUStoreOp_Store;
+			renderPassColorAttachment.clearValue = WGPUColor{ 0.9, 0.1, 0.2, 1.0 };
+			renderPassColorAttachment.depthSlice = WGPU_DEPTH_SLICE_UNDEFINED;
 
-			// Replace `draw()` with `drawIndexed()` and `vertexCount` with `indexCount`
-			// The extra argument is an offset within the index buffer.
-			wgpuRenderPassEncoderDrawIndexed(renderPass, indexCount, 1, 0, 0, 0);
+			renderPassDesc.colorAttachmentCount = 1;
+			renderPassDesc.colorAttachments = &renderPassColorAttachment;
+			renderPassDesc.depthStencilAttachment = nullptr;
+			renderPassDesc.timestampWrites = nullptr;
+
+			WGPURenderPassEncoder renderPass = wgpuCommandEncoderBeginRenderPass(encoder, &renderPassDesc);
+			TrackedRenderPass trackedPass(renderPass);
+			trackedPass.SetPipeline(pipeline);
+			trackedPass.SetVertexBuffer(0, vertexBuffer, 0, wgpuBufferGetSize(vertexBuffer));
+			trackedPass.SetIndexBuffer(indexBuffer, WGPUIndexFormat_Uint16, 0, wgpuBufferGetSize(indexBuffer));
+
+			// Same bind group for every draw, only the uniform slice changes
+			for (const uint32_t& offset : dynamicOffsets) {
+				trackedPass.SetBindGroup(0, bindGroup, std::span<const uint32_t>(&offset, 1));
+				trackedPass.DrawIndexed(indexCount);
+			}
+			lastPassStats_ = trackedPass.GetStats();
 
-			// Draw 1 instance of a 3-vertices shape
-			//wgpuRenderPassEncoderDraw(renderPass, 3, 1, 0, 0);
 			wgpuRenderPassEncoderEnd(renderPass);
 			wgpuRenderPassEncoderRelease(renderPass);
 
-			// Finally encode and submit the render pass
+			// Scale the native-resolution scene onto the window
+			bool presentable = Surface::EncodePresent(encoder);
+
 			WGPUCommandBufferDescriptor cmdBufferDescriptor = {};
 			cmdBufferDescriptor.nextInChain = nullptr;
-			cmdBufferDescriptor.label = "Command buffer";
+			cmdBufferDescriptor.label = "Quad2D dynamic offset command buffer";
 			WGPUCommandBuffer command = wgpuCommandEncoderFinish(encoder, &cmdBufferDescriptor);
 			wgpuCommandEncoderRelease(encoder);
 
 			wgpuQueueSubmit(queue, 1, &command);
 			wgpuCommandBufferRelease(command);
 
-			wgpuSurfacePresent(surface);
+			if (presentable) {
+				wgpuSurfacePresent(surface);
+				Surface::Pacer().MarkPresent();
+			}
+		};
 
-			wgpuDeviceTick(device);
+		/**
+		 * Encodes a whole RenderQueue in key order into one pass over the target, then
+		 * clears the queue for the next frame. Static layers are replayed first, as the
+		 * background the queued draws go on top of.
+		 */
+		static void Present(
+			WGPUTextureView targetView,
+			WGPUSurface surface,
+			WGPUDevice device,
+			WGPUQueue queue,
+			RenderQueue& renderQueue,
+			std::span<StaticLayer* const> staticLayers = {}
+		) {
+			WGPUCommandEncoderDescriptor encoderDesc = {};
+			encoderDesc.nextInChain = nullptr;
+			encoderDesc.label = "Render queue encoder";
+			WGPUCommandEncoder encoder = wgpuDeviceCreateCommandEncoder(device, &encoderDesc);
+
+			WGPURenderPassDescriptor renderPassDesc = {};
+			renderPassDesc.nextInChain = nullptr;
+
+			WGPURenderPassColorAttachment renderPassColorAttachment = {};
+			renderPassColorAttachment.view = targetView;
+			renderPassColorAttachment.resolveTarget = nullptr;
+			renderPassColorAttachment.loadOp = WGPULoadOp_Clear;
+			renderPassColorAttachment.storeOp = WGPUStoreOp_Store;
+			renderPassColorAttachment.clearValue = WGPUColor{ 0.9, 0.1, 0.2, 1.0 };
+			renderPassColorAttachment.depthSlice = WGPU_DEPTH_SLICE_UNDEFINED;
+
+			renderPassDesc.colorAttachmentCount = 1;
+			renderPassDesc.colorAttachments = &renderPassColorAttachment;
+			renderPassDesc.depthStencilAttachment = nullptr;
+			renderPassDesc.timestampWrites = nullptr;
+
+			WGPURenderPassEncoder renderPass = wgpuCommandEncoderBeginRenderPass(encoder, &renderPassDesc);
+			for (StaticLayer* layer : staticLayers) {
+				layer->Execute(renderPass);
+			}
+			renderQueue.Record(renderPass);
+			renderQueue.Clear();
+			wgpuRenderPassEncoderEnd(renderPass);
+			wgpuRenderPassEncoderRelease(renderPass);
+
+			// Scale the native-resolution scene onto the window
+			bool presentable = Surface::EncodePresent(encoder);
+
+			WGPUCommandBufferDescriptor cmdBufferDescriptor = {};
+			cmdBufferDescriptor.nextInChain = nullptr;
+			cmdBufferDescriptor.label = "Render queue command buffer";
+			WGPUCommandBuffer command = wgpuCommandEncoderFinish(encoder, &cmdBufferDescriptor);
+			wgpuCommandEncoderRelease(encoder);
+
+			wgpuQueueSubmit(queue, 1, &command);
+			wgpuCommandBufferRelease(command);
+
+			if (presentable) {
+				wgpuSurfacePresent(surface);
+				Surface::Pacer().MarkPresent();
+			}
 		};
+
+		/**
+		 * @brief Counters of the last pass encoded by the quad overloads of Present(). The
+		 * RenderQueue overload reports through RenderQueue::GetStats() instead.
+		 */
+		static const TrackedRenderPassStats& GetLastPassStats() { return lastPassStats_; }
 	private:
+		static inline TrackedRenderPassStats lastPassStats_;
 	};
 }
\ No newline at end of file
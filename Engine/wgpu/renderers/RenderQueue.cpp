@@ -0,0 +1,389 @@
+#include "RenderQueue.h"
+
+#include <algorithm>
+#include <bit>
+#include <chrono>
+#include <cmath>
+#include <numeric>
+
+namespace {
+	// The same commands exist on passes and bundles under different names; these let
+	// one recording loop serve both
+	inline void setPipeline(WGPURenderPassEncoder encoder, WGPURenderPipeline pipeline) { wgpuRenderPassEncoderSetPipeline(encoder, pipeline); }
+	inline void setPipeline(WGPURenderBundleEncoder encoder, WGPURenderPipeline pipeline) { wgpuRenderBundleEncoderSetPipeline(encoder, pipeline); }
+
+	inline void setBindGroup(WGPURenderPassEncoder encoder, uint32_t group, WGPUBindGroup bindGroup) { wgpuRenderPassEncoderSetBindGroup(encoder, group, bindGroup, 0, nullptr); }
+	inline void setBindGroup(WGPURenderBundleEncoder encoder, uint32_t group, WGPUBindGroup bindGroup) { wgpuRenderBundleEncoderSetBindGroup(encoder, group, bindGroup, 0, nullptr); }
+
+	inline void setVertexBuffer(WGPURenderPassEncoder encoder, uint32_t slot, WGPUBuffer buffer, uint64_t offset) { wgpuRenderPassEncoderSetVertexBuffer(encoder, slot, buffer, offset, WGPU_WHOLE_SIZE); }
+	inline void setVertexBuffer(WGPURenderBundleEncoder encoder, uint32_t slot, WGPUBuffer buffer, uint64_t offset) { wgpuRenderBundleEncoderSetVertexBuffer(encoder, slot, buffer, offset, WGPU_WHOLE_SIZE); }
+
+	inline void setIndexBuffer(WGPURenderPassEncoder encoder, WGPUBuffer buffer, WGPUIndexFormat format) { wgpuRenderPassEncoderSetIndexBuffer(encoder, buffer, format, 0, WGPU_WHOLE_SIZE); }
+	inline void setIndexBuffer(WGPURenderBundleEncoder encoder, WGPUBuffer buffer, WGPUIndexFormat format) { wgpuRenderBundleEncoderSetIndexBuffer(encoder, buffer, format, 0, WGPU_WHOLE_SIZE); }
+
+	inline void draw(WGPURenderPassEncoder encoder, const WGPU::Renderer::DrawCommand& d) { wgpuRenderPassEncoderDraw(encoder, d.count, d.instanceCount, d.first, d.firstInstance); }
+	inline void draw(WGPURenderBundleEncoder encoder, const WGPU::Renderer::DrawCommand& d) { wgpuRenderBundleEncoderDraw(encoder, d.count, d.instanceCount, d.first, d.firstInstance); }
+
+	inline void drawIndexed(WGPURenderPassEncoder encoder, const WGPU::Renderer::DrawCommand& d) { wgpuRenderPassEncoderDrawIndexed(encoder, d.count, d.instanceCount, d.first, d.baseVertex, d.firstInstance); }
+	inline void drawIndexed(WGPURenderBundleEncoder encoder, const WGPU::Renderer::DrawCommand& d) { wgpuRenderBundleEncoderDrawIndexed(encoder, d.count, d.instanceCount, d.first, d.baseVertex, d.firstInstance); }
+
+	bool sameState(const WGPU::Renderer::DrawCommand& a, const WGPU::Renderer::DrawCommand& b)
+	{
+		return a.pipeline == b.pipeline
+			&& a.bindGroupCount == b.bindGroupCount && a.bindGroups == b.bindGroups
+			&& a.vertexBufferCount == b.vertexBufferCount && a.vertexBuffers == b.vertexBuffers && a.vertexOffsets == b.vertexOffsets
+			&& a.indexBuffer == b.indexBuffer && a.indexFormat == b.indexFormat;
+	}
+
+	/**
+	 * Folds next into merged when the two draws are one draw split in two: either the
+	 * same geometry over consecutive instances, or consecutive ranges of one instance set.
+	 */
+	bool tryMerge(WGPU::Renderer::DrawCommand& merged, const WGPU::Renderer::DrawCommand& next)
+	{
+		if (!sameState(merged, next) || merged.baseVertex != next.baseVertex) {
+			return false;
+		}
+		if (merged.count == next.count && merged.first == next.first
+			&& merged.firstInstance + merged.instanceCount == next.firstInstance) {
+			merged.instanceCount += next.instanceCount;
+			return true;
+		}
+		if (merged.instanceCount == next.instanceCount && merged.firstInstance == next.firstInstance
+			&& merged.first + merged.count == next.first) {
+			merged.count += next.count;
+			return true;
+		}
+		return false;
+	}
+}
+
+WGPU::Renderer::RenderQueue::RenderQueue(size_t initialCapacity)
+{
+	draws_.reserve(initialCapacity);
+	keys_.reserve(initialCapacity);
+	order_.reserve(initialCapacity);
+	words_.reserve(initialCapacity);
+	scratch_.reserve(initialCapacity);
+	layerOrders_.fill(LayerOrder::BackToFront);
+}
+
+void WGPU::Renderer::RenderQueue::Submit(uint8_t layer, float depth, const DrawCommand& draw)
+{
+	Submit(MakeKey(layer, depth, draw.pipeline, draw.bindGroups[0]), draw);
+}
+
+void WGPU::Renderer::RenderQueue::Submit(uint64_t key, const DrawCommand& draw)
+{
+	if (!keys_.empty()) {
+		varyingBits_ |= key ^ keys_.front();
+	}
+	keys_.push_back(key);
+	draws_.push_back(draw);
+	sorted_ = false;
+}
+
+uint64_t WGPU::Renderer::RenderQueue::MakeKey(uint8_t layer, float depth, WGPURenderPipeline pipeline, WGPUBindGroup bindGroup)
+{
+	const uint64_t pipelineId = internId(pipelineIds_, pipeline, PipelineBits);
+	const uint64_t bindGroupId = internId(bindGroupIds_, bindGroup, BindGroupBits);
+	const uint64_t state = (pipelineId << BindGroupBits) | bindGroupId;
+	const uint64_t depthBits = QuantizeDepth(depth);
+
+	uint64_t key = static_cast<uint64_t>(layer) << (64 - LayerBits);
+	if (layerOrders_[layer] == LayerOrder::State) {
+		key |= (state << DepthBits) | depthBits;
+	}
+	else {
+		key |= (depthBits << (PipelineBits + BindGroupBits)) | state;
+	}
+	return key;
+}
+
+uint32_t WGPU::Renderer::RenderQueue::QuantizeDepth(float depth)
+{
+	// 4 fractional bits, biased so negative depths sort below positive ones
+	constexpr int64_t bias = int64_t{ 1 } << (DepthBits - 1);
+	constexpr int64_t maximum = (int64_t{ 1 } << DepthBits) - 1;
+	if (std::isnan(depth)) {
+		return static_cast<uint32_t>(bias);
+	}
+	const double fixed = std::floor(static_cast<double>(depth) * 16.0) + static_cast<double>(bias);
+	return static_cast<uint32_t>(std::clamp(fixed, 0.0, static_cast<double>(maximum)));
+}
+
+void WGPU::Renderer::RenderQueue::Sort()
+{
+	if (sorted_) {
+		return;
+	}
+	const auto start = std::chrono::steady_clock::now();
+	radixSort();
+	stats_.sortMilliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+	sorted_ = true;
+}
+
+void WGPU::Renderer::RenderQueue::Record(WGPURenderPassEncoder renderPass)
+{
+	record(renderPass);
+}
+
+void WGPU::Renderer::RenderQueue::Record(WGPURenderBundleEncoder bundleEncoder)
+{
+	record(bundleEncoder);
+}
+
+void WGPU::Renderer::RenderQueue::Clear()
+{
+	draws_.clear();
+	keys_.clear();
+	order_.clear();
+	varyingBits_ = 0;
+	sorted_ = true;
+}
+
+uint32_t WGPU::Renderer::RenderQueue::internId(IdTable& table, const void* handle, uint32_t bits)
+{
+	if (auto it = table.ids.find(handle); it != table.ids.end()) {
+		return it->second;
+	}
+
+	uint32_t id = 0;
+	if (!table.freeIds.empty()) {
+		id = table.freeIds.back();
+		table.freeIds.pop_back();
+	}
+	else {
+		// Only reached when the field is full of live handles that were never forgotten
+		if (table.next >= (uint32_t{ 1 } << bits)) {
+			table.ids.clear();
+			table.next = 0;
+		}
+		id = table.next++;
+	}
+	table.ids.emplace(handle, id);
+	return id;
+}
+
+void WGPU::Renderer::RenderQueue::forgetId(IdTable& table, const void* handle)
+{
+	if (auto it = table.ids.find(handle); it != table.ids.end()) {
+		table.freeIds.push_back(it->second);
+		table.ids.erase(it);
+	}
+}
+
+/**
+ * LSD radix sort of the keys into order_. Only key bits that differ between draws are
+ * sorted on: a frame usually has a few layers, a few pipelines and a screen's worth of
+ * depths, so of the 64 bits about two dozen vary. Those bits are packed above the draw index
+ * into 8-byte words, which are sorted in digits of up to 11 bits; the last pass writes
+ * the draw indices straight into order_.
+ *
+ * When the varying bits do not all fit beside the index (arbitrary 64-bit keys), the
+ * words hold the highest ones and draws that tie on them are sorted by the whole key.
+ */
+void WGPU::Renderer::RenderQueue::radixSort()
+{
+	constexpr uint32_t MaxDigitBits = 11;
+	constexpr uint32_t MaxPasses = (64 + MaxDigitBits - 1) / MaxDigitBits;
+
+	const size_t count = keys_.size();
+	order_.resize(count);
+	uint64_t varying = varyingBits_;
+	if (varying == 0) {
+		std::iota(order_.begin(), order_.end(), uint32_t{ 0 });
+		return;
+	}
+
+	// Contiguous runs of varying bits, each moved down next to the one below it. A fixed
+	// number keeps packing cheap; past that the narrowest gaps between runs are packed
+	// along with them, which only costs a few constant bits.
+	constexpr uint32_t MaxRuns = 4;
+	auto countRuns = [](uint64_t bits) { return std::popcount(bits & ~(bits << 1)); };
+	while (countRuns(varying) > static_cast<int>(MaxRuns)) {
+		const uint64_t inside = (~uint64_t{ 0 } << std::countr_zero(varying)) & (~uint64_t{ 0 } >> std::countl_zero(varying));
+		uint64_t narrowest = 0;
+		uint32_t narrowestLength = 64;
+		for (uint64_t gaps = ~varying & inside; gaps != 0;) {
+			const uint32_t shift = static_cast<uint32_t>(std::countr_zero(gaps));
+			const uint32_t length = static_cast<uint32_t>(std::countr_one(gaps >> shift));
+			const uint64_t gap = ((uint64_t{ 1 } << length) - 1) << shift;
+			if (length < narrowestLength) {
+				narrowest = gap;
+				narrowestLength = length;
+			}
+			gaps &= ~gap;
+		}
+		varying |= narrowest;
+	}
+
+	struct Run {
+		uint32_t shift = 0;
+		uint32_t destination = 0;
+		uint64_t mask = 0;
+	};
+	std::array<Run, MaxRuns> runs{};
+	uint32_t keyBits = 0;
+	uint32_t runIndex = 0;
+	for (uint64_t rest = varying; rest != 0; ++runIndex) {
+		const uint32_t shift = static_cast<uint32_t>(std::countr_zero(rest));
+		const uint32_t length = static_cast<uint32_t>(std::countr_one(rest >> shift));
+		const uint64_t mask = length == 64 ? ~uint64_t{ 0 } : (uint64_t{ 1 } << length) - 1;
+		runs[runIndex] = { shift, keyBits, mask };
+		keyBits += length;
+		rest &= ~(mask << shift);
+	}
+	auto compact = [&](uint64_t key) {
+		uint64_t packed = 0;
+		for (const Run& run : runs) {
+			packed |= ((key >> run.shift) & run.mask) << run.destination;
+		}
+		return packed;
+	};
+
+	// Bits below low do not fit beside the index and only break ties afterwards
+	const uint32_t indexBits = static_cast<uint32_t>(std::bit_width(count - 1));
+	const uint64_t indexMask = (uint64_t{ 1 } << indexBits) - 1;
+	const uint32_t sortBits = std::min(keyBits, 64 - indexBits);
+	const uint32_t low = keyBits - sortBits;
+
+	const uint32_t passes = (sortBits + MaxDigitBits - 1) / MaxDigitBits;
+	const uint32_t digitBits = (sortBits + passes - 1) / passes;
+	const uint64_t digitMask = (uint64_t{ 1 } << digitBits) - 1;
+
+	words_.resize(count);
+	scratch_.resize(count);
+	for (size_t i = 0; i < count; ++i) {
+		words_[i] = ((compact(keys_[i]) >> low) << indexBits) | i;
+	}
+
+	std::array<std::array<uint32_t, size_t{ 1 } << MaxDigitBits>, MaxPasses> histograms;
+	for (uint32_t pass = 0; pass < passes; ++pass) {
+		std::fill_n(histograms[pass].begin(), digitMask + 1, 0u);
+	}
+	for (const uint64_t word : words_) {
+		const uint64_t bits = word >> indexBits;
+		for (uint32_t pass = 0; pass < passes; ++pass) {
+			++histograms[pass][(bits >> (pass * digitBits)) & digitMask];
+		}
+	}
+
+	uint64_t* source = words_.data();
+	uint64_t* destination = scratch_.data();
+	for (uint32_t pass = 0; pass < passes; ++pass) {
+		// Counts to starting offsets
+		std::array<uint32_t, size_t{ 1 } << MaxDigitBits>& histogram = histograms[pass];
+		uint32_t offset = 0;
+		for (uint64_t digit = 0; digit <= digitMask; ++digit) {
+			const uint32_t size = histogram[digit];
+			histogram[digit] = offset;
+			offset += size;
+		}
+
+		const uint32_t shift = indexBits + pass * digitBits;
+		if (pass + 1 < passes) {
+			for (size_t i = 0; i < count; ++i) {
+				const uint64_t word = source[i];
+				destination[histogram[(word >> shift) & digitMask]++] = word;
+			}
+			std::swap(source, destination);
+		}
+		else {
+			for (size_t i = 0; i < count; ++i) {
+				const uint64_t word = source[i];
+				order_[histogram[(word >> shift) & digitMask]++] = static_cast<uint32_t>(word & indexMask);
+			}
+		}
+	}
+
+	if (low == 0) {
+		return;
+	}
+	// Runs that tie on the sorted bits are still in submission order; sorting each by the
+	// whole key keeps that for equal keys. With 50k draws this only happens for keys
+	// with more than 48 varying bits, where ties are rare and short.
+	auto byKey = [this](uint32_t a, uint32_t b) { return keys_[a] < keys_[b]; };
+	for (size_t begin = 0; begin < count;) {
+		const uint64_t high = compact(keys_[order_[begin]]) >> low;
+		size_t end = begin + 1;
+		while (end < count && compact(keys_[order_[end]]) >> low == high) {
+			++end;
+		}
+		if (end - begin > 1) {
+			std::stable_sort(order_.begin() + begin, order_.begin() + end, byKey);
+		}
+		begin = end;
+	}
+}
+
+template <typename Encoder>
+void WGPU::Renderer::RenderQueue::record(Encoder encoder)
+{
+	Sort();
+
+	stats_.submitted = static_cast<uint32_t>(draws_.size());
+	stats_.drawCalls = 0;
+	stats_.pipelineChanges = 0;
+	stats_.bindGroupChanges = 0;
+	stats_.bufferChanges = 0;
+
+	// State currently bound on the encoder, so unchanged state is not set again
+	WGPURenderPipeline boundPipeline = nullptr;
+	std::array<WGPUBindGroup, DrawCommand::MaxBindGroups> boundGroups{};
+	std::array<WGPUBuffer, DrawCommand::MaxVertexBuffers> boundVertexBuffers{};
+	std::array<uint64_t, DrawCommand::MaxVertexBuffers> boundVertexOffsets{};
+	WGPUBuffer boundIndexBuffer = nullptr;
+	WGPUIndexFormat boundIndexFormat = WGPUIndexFormat_Undefined;
+
+	auto emit = [&](const DrawCommand& command) {
+		if (command.pipeline != boundPipeline) {
+			setPipeline(encoder, command.pipeline);
+			boundPipeline = command.pipeline;
+			++stats_.pipelineChanges;
+		}
+		for (uint32_t group = 0; group < command.bindGroupCount; ++group) {
+			if (command.bindGroups[group] != boundGroups[group]) {
+				setBindGroup(encoder, group, command.bindGroups[group]);
+				boundGroups[group] = command.bindGroups[group];
+				++stats_.bindGroupChanges;
+			}
+		}
+		for (uint32_t slot = 0; slot < command.vertexBufferCount; ++slot) {
+			if (command.vertexBuffers[slot] != boundVertexBuffers[slot] || command.vertexOffsets[slot] != boundVertexOffsets[slot]) {
+				setVertexBuffer(encoder, slot, command.vertexBuffers[slot], command.vertexOffsets[slot]);
+				boundVertexBuffers[slot] = command.vertexBuffers[slot];
+				boundVertexOffsets[slot] = command.vertexOffsets[slot];
+				++stats_.bufferChanges;
+			}
+		}
+
+		if (command.indexBuffer) {
+			if (command.indexBuffer != boundIndexBuffer || command.indexFormat != boundIndexFormat) {
+				setIndexBuffer(encoder, command.indexBuffer, command.indexFormat);
+				boundIndexBuffer = command.indexBuffer;
+				boundIndexFormat = command.indexFormat;
+				++stats_.bufferChanges;
+			}
+			drawIndexed(encoder, command);
+		}
+		else {
+			draw(encoder, command);
+		}
+		++stats_.drawCalls;
+	};
+
+	if (order_.empty()) {
+		return;
+	}
+
+	DrawCommand merged = draws_[order_[0]];
+	for (size_t i = 1; i < order_.size(); ++i) {
+		const DrawCommand& next = draws_[order_[i]];
+		if (!tryMerge(merged, next)) {
+			emit(merged);
+			merged = next;
+		}
+	}
+	emit(merged);
+}
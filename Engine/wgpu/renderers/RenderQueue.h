@@ -0,0 +1,192 @@
+#pragma once
+
+#include <webgpu/webgpu.h>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+namespace WGPU::Renderer {
+
+	/**
+	 * @struct DrawCommand
+	 * @brief Everything needed to encode one draw, by handle. Nothing is owned; every
+	 * handle has to stay alive until the queue is recorded.
+	 *
+	 * With an index buffer, count / first are indices and firstIndex; without one they
+	 * are vertices and firstVertex.
+	 */
+	struct DrawCommand {
+		static constexpr uint32_t MaxVertexBuffers = 2;
+		static constexpr uint32_t MaxBindGroups = 2;
+
+		WGPURenderPipeline pipeline = nullptr;
+
+		// Group 0 is the material (usually the texture) and feeds the sort key
+		std::array<WGPUBindGroup, MaxBindGroups> bindGroups{};
+		uint32_t bindGroupCount = 1;
+
+		std::array<WGPUBuffer, MaxVertexBuffers> vertexBuffers{};
+		std::array<uint64_t, MaxVertexBuffers> vertexOffsets{};
+		uint32_t vertexBufferCount = 0;
+
+		WGPUBuffer indexBuffer = nullptr;
+		WGPUIndexFormat indexFormat = WGPUIndexFormat_Uint16;
+
+		uint32_t count = 0;
+		uint32_t instanceCount = 1;
+		uint32_t first = 0;
+		int32_t baseVertex = 0;
+		uint32_t firstInstance = 0;
+	};
+
+	/**
+	 * @struct RenderQueueStats
+	 * @brief What the last Record() did.
+	 */
+	struct RenderQueueStats {
+		uint32_t submitted = 0;
+		uint32_t drawCalls = 0;
+		uint32_t pipelineChanges = 0;
+		uint32_t bindGroupChanges = 0;
+		uint32_t bufferChanges = 0;
+		double sortMilliseconds = 0.0;
+	};
+
+	/**
+	 * @class RenderQueue
+	 * @brief Collects draws from any number of systems and encodes them in sort-key order.
+	 *
+	 * Every submission carries a 64-bit key; the queue radix sorts the keys (LSD, stable
+	 * so equal keys keep submission order) and then walks them once, merging neighbours
+	 * that differ only in a contiguous instance or index range and skipping state that is
+	 * already bound. Only key bits that differ between draws are sorted on, packed with
+	 * the draw index into 8-byte words; Benchmarks/RenderQueueSort.cpp times it.
+	 *
+	 * Key layout, most significant first:
+	 *
+	 *   layer (8) | depth (24) | pipeline (12) | bind group (20)   LayerOrder::BackToFront
+	 *   layer (8) | pipeline (12) | bind group (20) | depth (24)   LayerOrder::State
+	 *
+	 * BackToFront is painter's order for overlapping sprites (the Y-sorted world of a
+	 * top-down RPG); State groups by pipeline and texture first and suits layers whose
+	 * draws never overlap, like the ground.
+	 *
+	 * @code
+	 * queue.SetLayerOrder(0, RenderQueue::LayerOrder::State);
+	 * queue.Submit(0, tile.y, groundDraw);
+	 * queue.Submit(1, hero.feetY, heroDraw);
+	 * queue.Record(renderPass);
+	 * queue.Clear();
+	 * @endcode
+	 */
+	class RenderQueue {
+	public:
+		enum class LayerOrder : uint8_t {
+			BackToFront,
+			State
+		};
+
+		static constexpr uint32_t LayerBits = 8;
+		static constexpr uint32_t DepthBits = 24;
+		static constexpr uint32_t PipelineBits = 12;
+		static constexpr uint32_t BindGroupBits = 20;
+		static_assert(LayerBits + DepthBits + PipelineBits + BindGroupBits == 64, "Sort key fields must fill 64 bits.");
+
+		explicit RenderQueue(size_t initialCapacity = 4096);
+
+		/*============================================================
+		* PUBLIC
+		=============================================================*/
+
+		/**
+		 * @brief Chooses how draws within a layer are ordered. Applies to later submissions.
+		 */
+		void SetLayerOrder(uint8_t layer, LayerOrder order) { layerOrders_[layer] = order; }
+
+		/**
+		 * @brief Queues a draw keyed by layer, depth and its pipeline and group 0.
+		 *
+		 * @param depth Smaller values draw first. Quantized to 1/16 unit over roughly
+		 * +-500k, so pixel Y coordinates sort with sub-pixel precision.
+		 */
+		void Submit(uint8_t layer, float depth, const DrawCommand& draw);
+
+		/**
+		 * @brief Queues a draw with a caller-built key.
+		 */
+		void Submit(uint64_t key, const DrawCommand& draw);
+
+		/**
+		 * @brief Builds the key Submit(layer, depth, draw) would use.
+		 */
+		uint64_t MakeKey(uint8_t layer, float depth, WGPURenderPipeline pipeline, WGPUBindGroup bindGroup);
+
+		/**
+		 * @brief Sorts the queued draws. Record() sorts on its own if this was not called.
+		 */
+		void Sort();
+
+		/**
+		 * @brief Encodes every queued draw into the pass in key order.
+		 */
+		void Record(WGPURenderPassEncoder renderPass);
+
+		/**
+		 * @brief Same as Record(pass) into a render bundle, for draws recorded once and
+		 * replayed (see StaticLayer).
+		 */
+		void Record(WGPURenderBundleEncoder bundleEncoder);
+
+		/**
+		 * @brief Drops the queued draws, keeping the allocations for the next frame.
+		 */
+		void Clear();
+
+		/**
+		 * @brief Frees the key id of a handle that is about to be released, so a new
+		 * handle at the same address is not ordered as the old one and the id can be
+		 * reused. Draws already queued with it keep their keys.
+		 */
+		void Forget(WGPURenderPipeline pipeline) { forgetId(pipelineIds_, pipeline); }
+		void Forget(WGPUBindGroup bindGroup) { forgetId(bindGroupIds_, bindGroup); }
+
+		size_t GetSize() const { return draws_.size(); }
+		const RenderQueueStats& GetStats() const { return stats_; }
+
+		static uint32_t QuantizeDepth(float depth);
+	private:
+		struct IdTable {
+			std::unordered_map<const void*, uint32_t> ids;
+			std::vector<uint32_t> freeIds;
+			uint32_t next = 0;
+		};
+
+		// keys_ runs parallel to draws_; order_ holds draw indices in key order once sorted
+		std::vector<DrawCommand> draws_;
+		std::vector<uint64_t> keys_;
+		std::vector<uint32_t> order_;
+		std::vector<uint64_t> words_;
+		std::vector<uint64_t> scratch_;
+		uint64_t varyingBits_ = 0; // Key bits that differ from the first key
+		bool sorted_ = true;
+
+		std::array<LayerOrder, 256> layerOrders_{};
+
+		// Handles are interned into dense ids so they fit their key fields. Ids are only
+		// for ordering; merging compares the handles themselves, so a reused or wrapped id
+		// costs at most a missed merge.
+		IdTable pipelineIds_;
+		IdTable bindGroupIds_;
+
+		RenderQueueStats stats_;
+
+		uint32_t internId(IdTable& table, const void* handle, uint32_t bits);
+		void forgetId(IdTable& table, const void* handle);
+		void radixSort();
+
+		template <typename Encoder>
+		void record(Encoder encoder);
+	};
+}
@@ -0,0 +1,223 @@
+#include "SpriteBatch.h"
+
+WGPU::Renderer::SpriteBatch::SpriteBatch(
+	WGPUTextureView textureView,
+	WGPUSampler sampler,
+	const glm::mat4& projection,
+	size_t initialCapacity,
+	Buffer::VertexEncoding encoding,
+	Pipeline::SpriteBatchPipeline::InstanceFetch fetch,
+	Pipeline::SpriteBatchPipeline::SheetLayout sheet
+) :
+	encoding_(encoding),
+	instanceStride_(encoding == Buffer::VertexEncoding::Quantized ? sizeof(Buffer::CompactSpriteInstance) : sizeof(Buffer::SpriteInstance))
+{
+	// Fail here rather than at draw time if the host struct drifts from the shader
+	Shader::ShaderReflection::Reflect(Pipeline::SpriteBatchPipeline::GetShaderSource(encoding_, fetch, sheet))->Validate<SpriteBatchUniforms>(0, 0);
+
+	uniforms_ = std::make_unique<Buffer::UniformBlock<SpriteBatchUniforms>>(SpriteBatchUniforms{ projection });
+	uniforms_->Write();
+
+	// Vertex pulling builds the corners in the shader and needs no quad
+	if (fetch == Pipeline::SpriteBatchPipeline::InstanceFetch::VertexAttributes) {
+		Utilities::QuadStruct quad = Utilities::Quad().CreateCentered();
+		if (encoding_ == Buffer::VertexEncoding::Quantized) {
+			std::vector<Buffer::CompactVertex2D> packed(quad.VertexCount);
+			Buffer::PackVertices2D(quad.Vertices, packed);
+			quadVertices_ = Buffer::VertexBuffer::Create<Pipeline::SpriteBatchPipeline::CompactQuadLayout>(packed, Core::Device(), Core::Queue());
+		}
+		else {
+			quadVertices_ = Buffer::VertexBuffer::Create<Pipeline::SpriteBatchPipeline::QuadLayout>(quad.Vertices, Core::Device(), Core::Queue());
+		}
+		quadIndices_ = std::make_unique<Buffer::IndexBuffer>(quad.Indices, quad.IndexCount, Core::Device(), Core::Queue());
+	}
+
+	pipeline_ = std::make_unique<Pipeline::SpriteBatchPipeline>(
+		uniforms_->Get(),
+		uniforms_->GetSize(),
+		textureView,
+		sampler,
+		encoding_,
+		fetch,
+		sheet
+	);
+
+	instances_.reserve(initialCapacity);
+	if (fetch == Pipeline::SpriteBatchPipeline::InstanceFetch::StorageBuffer) {
+		instanceBuffer_ = std::make_unique<Buffer::DynamicVertexBuffer>(initialCapacity * instanceStride_, 3, WGPUBufferUsage_Storage);
+		instanceBindings_.resize(instanceBuffer_->GetFramesInFlight());
+	}
+	else {
+		instanceBuffer_ = std::make_unique<Buffer::DynamicVertexBuffer>(initialCapacity * instanceStride_);
+	}
+}
+
+WGPU::Renderer::SpriteBatch::~SpriteBatch()
+{
+	for (InstanceBinding& binding : instanceBindings_) {
+		if (binding.bindGroup) {
+			wgpuBindGroupRelease(binding.bindGroup);
+			binding.bindGroup = nullptr;
+		}
+	}
+}
+
+/**
+ * Starts a new batch, discarding the sprites of the previous frame.
+ */
+void WGPU::Renderer::SpriteBatch::Begin()
+{
+	instances_.clear();
+}
+
+/**
+ * Queues one sprite for drawing.
+ *
+ * @param sprite The instance data to append to the batch.
+ */
+void WGPU::Renderer::SpriteBatch::Draw(const Buffer::SpriteInstance& sprite)
+{
+	instances_.push_back(sprite);
+}
+
+/**
+ * Queues one sprite for drawing.
+ *
+ * @param position Centre of the sprite in pixels.
+ * @param size Width and height in pixels.
+ * @param rotation Rotation in radians around the centre.
+ * @param uvRect Sub-rectangle of the texture as (u0, v0, u1, v1).
+ * @param tint Colour multiplied with the sampled texel.
+ * @param layer Array layer to sample; only used by Texture2DArray batches.
+ */
+void WGPU::Renderer::SpriteBatch::Draw(
+	const glm::vec2& position,
+	const glm::vec2& size,
+	float rotation,
+	const glm::vec4& uvRect,
+	const glm::vec4& tint,
+	uint32_t layer
+)
+{
+	Buffer::SpriteInstance& sprite = instances_.emplace_back();
+	sprite.position = position;
+	sprite.size = size;
+	sprite.rotation = rotation;
+	sprite.layer = layer;
+	sprite.uvRect = uvRect;
+	sprite.tint = tint;
+}
+
+/**
+ * Uploads every queued sprite to this frame's instance buffer with a single queue write,
+ * packing them first when the batch is quantized.
+ */
+void WGPU::Renderer::SpriteBatch::End()
+{
+	uploadedCount_ = static_cast<uint32_t>(instances_.size());
+	if (uploadedCount_ == 0) {
+		return;
+	}
+
+	instanceBuffer_->BeginFrame();
+	if (encoding_ == Buffer::VertexEncoding::Quantized) {
+		packedInstances_.resize(instances_.size());
+		Buffer::PackSpriteInstances(instances_, packedInstances_);
+		instanceBuffer_->Update(0, packedInstances_);
+	}
+	else {
+		instanceBuffer_->Update(0, instances_);
+	}
+	instanceBuffer_->Flush();
+
+	if (pipeline_->GetFetch() == Pipeline::SpriteBatchPipeline::InstanceFetch::StorageBuffer) {
+		updateInstanceBindGroup();
+	}
+}
+
+/**
+ * Encodes the whole batch into an active render pass as one instanced draw.
+ *
+ * @param renderPass The render pass encoder to record into.
+ */
+void WGPU::Renderer::SpriteBatch::Record(WGPURenderPassEncoder renderPass) const
+{
+	if (uploadedCount_ == 0) {
+		return;
+	}
+
+	wgpuRenderPassEncoderSetPipeline(renderPass, pipeline_->GetPipeline());
+	wgpuRenderPassEncoderSetBindGroup(renderPass, 0, pipeline_->GetBindGroup(), 0, nullptr);
+
+	if (pipeline_->GetFetch() == Pipeline::SpriteBatchPipeline::InstanceFetch::StorageBuffer) {
+		// No input assembly: the vertex shader reads sprite vertexIndex / 6 itself
+		wgpuRenderPassEncoderSetBindGroup(renderPass, 1, currentInstanceBindGroup_, 0, nullptr);
+		wgpuRenderPassEncoderDraw(renderPass, Pipeline::SpriteBatchPipeline::VerticesPerSprite * uploadedCount_, 1, 0, 0);
+		return;
+	}
+
+	wgpuRenderPassEncoderSetVertexBuffer(renderPass, 0, quadVertices_->GetBuffer(), 0, wgpuBufferGetSize(quadVertices_->GetBuffer()));
+	wgpuRenderPassEncoderSetVertexBuffer(renderPass, 1, instanceBuffer_->GetBuffer(), 0, uploadedCount_ * instanceStride_);
+	wgpuRenderPassEncoderSetIndexBuffer(renderPass, quadIndices_->GetBuffer(), WGPUIndexFormat_Uint16, 0, wgpuBufferGetSize(quadIndices_->GetBuffer()));
+	wgpuRenderPassEncoderDrawIndexed(renderPass, quadIndices_->GetIndexCount(), uploadedCount_, 0, 0, 0);
+}
+
+/**
+ * Describes the batch as a single draw for a RenderQueue.
+ *
+ * @return The draw command; count is zero when the batch is empty.
+ */
+WGPU::Renderer::DrawCommand WGPU::Renderer::SpriteBatch::GetDrawCommand() const
+{
+	DrawCommand draw;
+	draw.pipeline = pipeline_->GetPipeline();
+	draw.bindGroups[0] = pipeline_->GetBindGroup();
+
+	if (pipeline_->GetFetch() == Pipeline::SpriteBatchPipeline::InstanceFetch::StorageBuffer) {
+		draw.bindGroups[1] = currentInstanceBindGroup_;
+		draw.bindGroupCount = 2;
+		draw.count = Pipeline::SpriteBatchPipeline::VerticesPerSprite * uploadedCount_;
+		return draw;
+	}
+
+	draw.vertexBuffers = { quadVertices_->GetBuffer(), instanceBuffer_->GetBuffer() };
+	draw.vertexBufferCount = 2;
+	draw.indexBuffer = quadIndices_->GetBuffer();
+	draw.indexFormat = WGPUIndexFormat_Uint16;
+	draw.count = quadIndices_->GetIndexCount();
+	draw.instanceCount = uploadedCount_;
+	return draw;
+}
+
+/**
+ * Replaces the projection used by every sprite in the batch.
+ *
+ * @param projection The new projection matrix.
+ * @param stagingBelt Optional belt to batch the upload with others.
+ */
+void WGPU::Renderer::SpriteBatch::SetProjection(const glm::mat4& projection, Buffer::StagingBelt* stagingBelt)
+{
+	uniforms_->Set<&SpriteBatchUniforms::Projection>(projection);
+	uniforms_->Write(stagingBelt);
+}
+
+/**
+ * Points the instance bind group at the buffer the instances were just flushed to. The
+ * buffer rotation reuses its buffers, so a bind group is only rebuilt when its buffer
+ * was reallocated to grow. Comparing handles is safe: the old bind group still holds a
+ * reference to the old buffer, so a new buffer cannot reuse its address.
+ */
+void WGPU::Renderer::SpriteBatch::updateInstanceBindGroup()
+{
+	InstanceBinding& binding = instanceBindings_[instanceBuffer_->GetFrameIndex()];
+	WGPUBuffer buffer = instanceBuffer_->GetBuffer();
+	if (binding.buffer != buffer || !binding.bindGroup) {
+		if (binding.bindGroup) {
+			wgpuBindGroupRelease(binding.bindGroup);
+		}
+		// Bind the whole allocation so the group stays valid as the batch size changes
+		binding.bindGroup = pipeline_->CreateInstanceBindGroup(buffer, wgpuBufferGetSize(buffer));
+		binding.buffer = buffer;
+	}
+	currentInstanceBindGroup_ = binding.bindGroup;
+}
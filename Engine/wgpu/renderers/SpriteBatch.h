@@ -0,0 +1,112 @@
+#pragma once
+
+#include <webgpu/webgpu.h>
+#include <glm/glm.hpp>
+#include <memory>
+#include <vector>
+
+#include <core/Core.h>
+#include <utilities/Quad.h>
+#include <wgpu/buffer/SpriteInstance.h>
+#include <wgpu/buffer/StagingBelt.h>
+#include <wgpu/buffer/UniformBlock.h>
+#include <wgpu/buffer/VertexBuffer.h>
+#include <wgpu/buffer/IndexBuffer.h>
+#include <wgpu/buffer/DynamicVertexBuffer.h>
+#include <wgpu/buffer/VertexPacking.h>
+#include <wgpu/pipelines/SpriteBatchPipeline.h>
+
+#include "RenderQueue.h"
+
+namespace WGPU::Renderer {
+	struct SpriteBatchUniforms {
+		glm::mat4 Projection;
+
+		static constexpr std::array<size_t, 1> MemberOffsets() { return { offsetof(SpriteBatchUniforms, Projection) }; }
+	};
+
+	/**
+	 * Collects sprites for one texture and draws all of them with a single
+	 * instanced DrawIndexed over the unit quad from Utilities::Quad::CreateCentered.
+	 *
+	 * Usage per frame: Begin(), Draw() for every sprite, End() to upload, then
+	 * Record() inside a render pass.
+	 *
+	 * A Quantized batch packs the sprites into CompactSpriteInstance at End(), uploading
+	 * 24 bytes per sprite instead of 64. Positions snap to whole pixels.
+	 *
+	 * With InstanceFetch::StorageBuffer the batch owns no quad buffers; the instances
+	 * are a storage buffer and the whole batch is one non-indexed Draw(6 * count).
+	 *
+	 * With SheetLayout::Texture2DArray the view is a 2D array (e.g. from
+	 * Utilities::TextureArray) and each sprite picks its frame with a layer, so a whole
+	 * roster of animated sprites draws from one bind group.
+	 */
+	class SpriteBatch {
+	public:
+		SpriteBatch(
+			WGPUTextureView textureView,
+			WGPUSampler sampler,
+			const glm::mat4& projection,
+			size_t initialCapacity = 1024,
+			Buffer::VertexEncoding encoding = Buffer::VertexEncoding::Float32,
+			Pipeline::SpriteBatchPipeline::InstanceFetch fetch = Pipeline::SpriteBatchPipeline::InstanceFetch::VertexAttributes,
+			Pipeline::SpriteBatchPipeline::SheetLayout sheet = Pipeline::SpriteBatchPipeline::SheetLayout::Texture2D
+		);
+		~SpriteBatch();
+
+		SpriteBatch(const SpriteBatch&) = delete;
+		SpriteBatch& operator=(const SpriteBatch&) = delete;
+
+		void Begin();
+		void Draw(const Buffer::SpriteInstance& sprite);
+		void Draw(
+			const glm::vec2& position,
+			const glm::vec2& size,
+			float rotation = 0.0f,
+			const glm::vec4& uvRect = glm::vec4(0.0f, 0.0f, 1.0f, 1.0f),
+			const glm::vec4& tint = glm::vec4(1.0f, 1.0f, 1.0f, 1.0f),
+			uint32_t layer = 0
+		);
+		void End();
+
+		void Record(WGPURenderPassEncoder renderPass) const;
+
+		/**
+		 * The draw Record() would encode, for submitting the batch to a RenderQueue.
+		 * Only valid after End() until the next End().
+		 */
+		DrawCommand GetDrawCommand() const;
+
+		/**
+		 * @param stagingBelt Optional belt to batch the uniform upload with the frame's others.
+		 */
+		void SetProjection(const glm::mat4& projection, Buffer::StagingBelt* stagingBelt = nullptr);
+
+		uint32_t GetInstanceCount() const { return static_cast<uint32_t>(instances_.size()); }
+		size_t GetCapacity() const { return instanceBuffer_->GetCapacity() / instanceStride_; }
+	private:
+		std::unique_ptr<Buffer::UniformBlock<SpriteBatchUniforms>> uniforms_;
+		std::unique_ptr<Buffer::VertexBuffer> quadVertices_;
+		std::unique_ptr<Buffer::IndexBuffer> quadIndices_;
+		std::unique_ptr<Pipeline::SpriteBatchPipeline> pipeline_;
+
+		std::vector<Buffer::SpriteInstance> instances_;
+		std::vector<Buffer::CompactSpriteInstance> packedInstances_;
+		Buffer::VertexEncoding encoding_;
+		uint64_t instanceStride_;
+
+		// Storage buffer fetch: one bind group per buffer in the instance rotation, rebuilt
+		// when that buffer is reallocated
+		struct InstanceBinding {
+			WGPUBuffer buffer = nullptr;
+			WGPUBindGroup bindGroup = nullptr;
+		};
+		std::vector<InstanceBinding> instanceBindings_;
+		WGPUBindGroup currentInstanceBindGroup_ = nullptr;
+
+		void updateInstanceBindGroup();
+		std::unique_ptr<Buffer::DynamicVertexBuffer> instanceBuffer_;
+		uint32_t uploadedCount_ = 0;
+	};
+}
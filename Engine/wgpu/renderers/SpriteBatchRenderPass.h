@@ -0,0 +1,124 @@
+#pragma once
+
+#include <webgpu/webgpu.h>
+#include <core/Surface.h>
+
+#include "SpriteBatch.h"
+#include "SpriteCuller.h"
+
+namespace WGPU::Renderer {
+	class SpriteBatchRenderPass {
+	public:
+		static void Present(
+			WGPUTextureView targetView,
+			WGPUSurface surface,
+			WGPUDevice device,
+			WGPUQueue queue,
+			const SpriteBatch& batch
+		) {
+			// Create a command encoder for the whole batch
+			WGPUCommandEncoderDescriptor encoderDesc = {};
+			encoderDesc.nextInChain = nullptr;
+			encoderDesc.label = "Sprite batch command encoder";
+			WGPUCommandEncoder encoder = wgpuDeviceCreateCommandEncoder(device, &encoderDesc);
+
+			WGPURenderPassDescriptor renderPassDesc = {};
+			renderPassDesc.nextInChain = nullptr;
+
+			WGPURenderPassColorAttachment renderPassColorAttachment = {};
+			renderPassColorAttachment.view = targetView;
+			renderPassColorAttachment.resolveTarget = nullptr;
+			renderPassColorAttachment.loadOp = WGPULoadOp_Clear;
+			renderPassColorAttachment.storeOp = WGPUStoreOp_Store;
+			renderPassColorAttachment.clearValue = WGPUColor{ 0.9, 0.1, 0.2, 1.0 };
+			renderPassColorAttachment.depthSlice = WGPU_DEPTH_SLICE_UNDEFINED;
+
+			renderPassDesc.colorAttachmentCount = 1;
+			renderPassDesc.colorAttachments = &renderPassColorAttachment;
+			renderPassDesc.depthStencilAttachment = nullptr;
+			renderPassDesc.timestampWrites = nullptr;
+
+			// Every sprite in the batch goes out as a single instanced draw
+			WGPURenderPassEncoder renderPass = wgpuCommandEncoderBeginRenderPass(encoder, &renderPassDesc);
+			batch.Record(renderPass);
+			wgpuRenderPassEncoderEnd(renderPass);
+			wgpuRenderPassEncoderRelease(renderPass);
+
+			// Scale the native-resolution scene onto the window
+			bool presentable = Surface::EncodePresent(encoder);
+
+			WGPUCommandBufferDescriptor cmdBufferDescriptor = {};
+			cmdBufferDescriptor.nextInChain = nullptr;
+			cmdBufferDescriptor.label = "Sprite batch command buffer";
+			WGPUCommandBuffer command = wgpuCommandEncoderFinish(encoder, &cmdBufferDescriptor);
+			wgpuCommandEncoderRelease(encoder);
+
+			wgpuQueueSubmit(queue, 1, &command);
+			wgpuCommandBufferRelease(command);
+
+			if (presentable) {
+				wgpuSurfacePresent(surface);
+				Surface::Pacer().MarkPresent();
+			}
+		};
+
+		/**
+		 * Culls the sprites on the GPU in a compute pass, then draws the survivors with
+		 * one indirect draw, all in a single submit.
+		 */
+		static void Present(
+			WGPUTextureView targetView,
+			WGPUSurface surface,
+			WGPUDevice device,
+			WGPUQueue queue,
+			const SpriteCuller& culler
+		) {
+			WGPUCommandEncoderDescriptor encoderDesc = {};
+			encoderDesc.nextInChain = nullptr;
+			encoderDesc.label = "Culled sprite command encoder";
+			WGPUCommandEncoder encoder = wgpuDeviceCreateCommandEncoder(device, &encoderDesc);
+
+			// Compute pass first; the render pass reads its output as instances and arguments
+			culler.Cull(encoder);
+
+			WGPURenderPassDescriptor renderPassDesc = {};
+			renderPassDesc.nextInChain = nullptr;
+
+			WGPURenderPassColorAttachment renderPassColorAttachment = {};
+			renderPassColorAttachment.view = targetView;
+			renderPassColorAttachment.resolveTarget = nullptr;
+			renderPassColorAttachment.loadOp = WGPULoadOp_Clear;
+			renderPassColorAttachment.storeOp = WGPUStoreOp_Store;
+			renderPassColorAttachment.clearValue = WGPUColor{ 0.9, 0.1, 0.2, 1.0 };
+			renderPassColorAttachment.depthSlice = WGPU_DEPTH_SLICE_UNDEFINED;
+
+			renderPassDesc.colorAttachmentCount = 1;
+			renderPassDesc.colorAttachments = &renderPassColorAttachment;
+			renderPassDesc.depthStencilAttachment = nullptr;
+			renderPassDesc.timestampWrites = nullptr;
+
+			WGPURenderPassEncoder renderPass = wgpuCommandEncoderBeginRenderPass(encoder, &renderPassDesc);
+			culler.Record(renderPass);
+			wgpuRenderPassEncoderEnd(renderPass);
+			wgpuRenderPassEncoderRelease(renderPass);
+
+			// Scale the native-resolution scene onto the window
+			bool presentable = Surface::EncodePresent(encoder);
+
+			WGPUCommandBufferDescriptor cmdBufferDescriptor = {};
+			cmdBufferDescriptor.nextInChain = nullptr;
+			cmdBufferDescriptor.label = "Culled sprite command buffer";
+			WGPUCommandBuffer command = wgpuCommandEncoderFinish(encoder, &cmdBufferDescriptor);
+			wgpuCommandEncoderRelease(encoder);
+
+			wgpuQueueSubmit(queue, 1, &command);
+			wgpuCommandBufferRelease(command);
+
+			if (presentable) {
+				wgpuSurfacePresent(surface);
+				Surface::Pacer().MarkPresent();
+			}
+		};
+	private:
+	};
+}
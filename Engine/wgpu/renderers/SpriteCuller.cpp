@@ -0,0 +1,234 @@
+#include "SpriteCuller.h"
+
+#include <cstring>
+
+WGPU::Renderer::SpriteCuller::SpriteCuller(
+	WGPUTextureView textureView,
+	WGPUSampler sampler,
+	const glm::mat4& projection,
+	size_t initialCapacity,
+	Pipeline::SpriteBatchPipeline::SheetLayout sheet
+)
+{
+	// Fail here rather than at draw time if the host structs drift from the shaders
+	Shader::ShaderReflection::Reflect(Pipeline::SpriteBatchPipeline::GetShaderSource(Buffer::VertexEncoding::Float32, Pipeline::SpriteBatchPipeline::InstanceFetch::VertexAttributes, sheet))->Validate<SpriteBatchUniforms>(0, 0);
+	Shader::ShaderReflection::Reflect(Pipeline::SpriteCullPipeline::GetShaderSource())->Validate<SpriteCullUniforms>(0, 0);
+
+	uniforms_ = std::make_unique<Buffer::UniformBlock<SpriteBatchUniforms>>(SpriteBatchUniforms{ projection });
+	uniforms_->Write();
+	cullUniforms_ = std::make_unique<Buffer::UniformBlock<SpriteCullUniforms>>(SpriteCullUniforms{ glm::vec2(0.0f), glm::vec2(0.0f), 0, 0.0f });
+	cullUniforms_->Write();
+
+	Utilities::QuadStruct quad = Utilities::Quad().CreateCentered();
+	quadVertices_ = Buffer::VertexBuffer::Create<Pipeline::SpriteBatchPipeline::QuadLayout>(quad.Vertices, Core::Device(), Core::Queue());
+	quadIndices_ = std::make_unique<Buffer::IndexBuffer>(quad.Indices, quad.IndexCount, Core::Device(), Core::Queue());
+
+	// The survivors are plain SpriteInstances, so the regular instanced pipeline draws them
+	pipeline_ = std::make_unique<Pipeline::SpriteBatchPipeline>(
+		uniforms_->Get(),
+		uniforms_->GetSize(),
+		textureView,
+		sampler,
+		Buffer::VertexEncoding::Float32,
+		Pipeline::SpriteBatchPipeline::InstanceFetch::VertexAttributes,
+		sheet
+	);
+	cullPipeline_ = std::make_unique<Pipeline::SpriteCullPipeline>();
+
+	createIndirectArgs();
+	allocate(initialCapacity > 0 ? initialCapacity : 1);
+}
+
+WGPU::Renderer::SpriteCuller::~SpriteCuller()
+{
+	std::cout << "WGPU::Renderer::SpriteCuller::~SpriteCuller - Releasing cull buffers..." << std::endl;
+	releaseInstanceBuffers();
+	if (indirectArgs_) {
+		wgpuBufferDestroy(indirectArgs_);
+		wgpuBufferRelease(indirectArgs_);
+		indirectArgs_ = nullptr;
+	}
+}
+
+/**
+ * Replaces every sprite. The buffers only grow, to the next power of two that fits.
+ *
+ * @param instances The sprites to cull from now on.
+ * @param stagingBelt Optional belt to batch the upload with others.
+ */
+void WGPU::Renderer::SpriteCuller::SetInstances(std::span<const Buffer::SpriteInstance> instances, Buffer::StagingBelt* stagingBelt)
+{
+	if (instances.size() > UINT32_MAX) {
+		throw std::length_error("SpriteCuller: too many sprites.");
+	}
+	if (instances.size() > capacity_) {
+		size_t capacity = capacity_;
+		while (capacity < instances.size()) {
+			capacity *= 2;
+		}
+		allocate(capacity);
+	}
+
+	instanceCount_ = static_cast<uint32_t>(instances.size());
+	upload(0, instances, stagingBelt);
+	cullUniforms_->Set<&SpriteCullUniforms::count>(instanceCount_);
+	cullUniforms_->Write(stagingBelt);
+}
+
+/**
+ * Overwrites sprites [first, first + instances.size()) in place.
+ *
+ * @param first Index of the first sprite to replace.
+ * @param instances The new data.
+ * @param stagingBelt Optional belt to batch the upload with others.
+ */
+void WGPU::Renderer::SpriteCuller::UpdateInstances(uint32_t first, std::span<const Buffer::SpriteInstance> instances, Buffer::StagingBelt* stagingBelt)
+{
+	if (first > instanceCount_ || instances.size() > instanceCount_ - first) {
+		throw std::out_of_range("SpriteCuller: update outside the current sprites.");
+	}
+	upload(static_cast<uint64_t>(first) * sizeof(Buffer::SpriteInstance), instances, stagingBelt);
+}
+
+void WGPU::Renderer::SpriteCuller::SetView(const glm::vec2& viewMin, const glm::vec2& viewMax, float margin, Buffer::StagingBelt* stagingBelt)
+{
+	cullUniforms_->Set<&SpriteCullUniforms::viewMin>(viewMin);
+	cullUniforms_->Set<&SpriteCullUniforms::viewMax>(viewMax);
+	cullUniforms_->Set<&SpriteCullUniforms::margin>(margin);
+	cullUniforms_->Write(stagingBelt);
+}
+
+void WGPU::Renderer::SpriteCuller::SetProjection(const glm::mat4& projection, Buffer::StagingBelt* stagingBelt)
+{
+	uniforms_->Set<&SpriteBatchUniforms::Projection>(projection);
+	uniforms_->Write(stagingBelt);
+}
+
+void WGPU::Renderer::SpriteCuller::Cull(WGPUCommandEncoder encoder) const
+{
+	// Only the instance count is reset; the other arguments never change
+	wgpuCommandEncoderClearBuffer(encoder, indirectArgs_, Pipeline::SpriteCullPipeline::InstanceCountOffset, sizeof(uint32_t));
+	if (instanceCount_ == 0) {
+		return;
+	}
+
+	WGPUComputePassDescriptor passDesc = {};
+	passDesc.nextInChain = nullptr;
+	passDesc.label = "Sprite cull pass";
+	passDesc.timestampWrites = nullptr;
+
+	WGPUComputePassEncoder computePass = wgpuCommandEncoderBeginComputePass(encoder, &passDesc);
+	wgpuComputePassEncoderSetPipeline(computePass, cullPipeline_->GetPipeline());
+	wgpuComputePassEncoderSetBindGroup(computePass, 0, cullBindGroup_, 0, nullptr);
+	const uint32_t workgroups = (instanceCount_ + Pipeline::SpriteCullPipeline::WorkgroupSize - 1) / Pipeline::SpriteCullPipeline::WorkgroupSize;
+	wgpuComputePassEncoderDispatchWorkgroups(computePass, workgroups, 1, 1);
+	wgpuComputePassEncoderEnd(computePass);
+	wgpuComputePassEncoderRelease(computePass);
+}
+
+void WGPU::Renderer::SpriteCuller::Record(WGPURenderPassEncoder renderPass) const
+{
+	if (instanceCount_ == 0) {
+		return;
+	}
+
+	wgpuRenderPassEncoderSetPipeline(renderPass, pipeline_->GetPipeline());
+	wgpuRenderPassEncoderSetBindGroup(renderPass, 0, pipeline_->GetBindGroup(), 0, nullptr);
+	wgpuRenderPassEncoderSetVertexBuffer(renderPass, 0, quadVertices_->GetBuffer(), 0, wgpuBufferGetSize(quadVertices_->GetBuffer()));
+	wgpuRenderPassEncoderSetVertexBuffer(renderPass, 1, visible_, 0, static_cast<uint64_t>(instanceCount_) * sizeof(Buffer::SpriteInstance));
+	wgpuRenderPassEncoderSetIndexBuffer(renderPass, quadIndices_->GetBuffer(), WGPUIndexFormat_Uint16, 0, wgpuBufferGetSize(quadIndices_->GetBuffer()));
+
+	// The instance count comes from the cull, never from the CPU
+	wgpuRenderPassEncoderDrawIndexedIndirect(renderPass, indirectArgs_, 0);
+}
+
+/**
+ * Creates the sprite and survivor buffers for the given capacity, with their bind group.
+ * Existing sprites are not carried over; SetInstances() uploads them again.
+ */
+void WGPU::Renderer::SpriteCuller::allocate(size_t capacity)
+{
+	releaseInstanceBuffers();
+
+	const uint64_t size = static_cast<uint64_t>(capacity) * sizeof(Buffer::SpriteInstance);
+
+	WGPUBufferDescriptor bufferDesc = {};
+	bufferDesc.nextInChain = nullptr;
+	bufferDesc.label = "Cull input sprites";
+	bufferDesc.usage = WGPUBufferUsage_Storage | WGPUBufferUsage_CopyDst;
+	bufferDesc.size = size;
+	bufferDesc.mappedAtCreation = false;
+	instances_ = wgpuDeviceCreateBuffer(Core::Device(), &bufferDesc);
+
+	bufferDesc.label = "Cull visible sprites";
+	bufferDesc.usage = WGPUBufferUsage_Storage | WGPUBufferUsage_Vertex;
+	visible_ = wgpuDeviceCreateBuffer(Core::Device(), &bufferDesc);
+
+	if (!instances_ || !visible_) {
+		throw std::runtime_error("Failed to create sprite cull buffers.");
+	}
+
+	cullBindGroup_ = cullPipeline_->CreateBindGroup(
+		cullUniforms_->Get(),
+		cullUniforms_->GetSize(),
+		instances_,
+		visible_,
+		indirectArgs_,
+		size
+	);
+	capacity_ = capacity;
+	instanceCount_ = 0;
+}
+
+void WGPU::Renderer::SpriteCuller::releaseInstanceBuffers()
+{
+	if (cullBindGroup_) {
+		wgpuBindGroupRelease(cullBindGroup_);
+		cullBindGroup_ = nullptr;
+	}
+	if (instances_) {
+		wgpuBufferDestroy(instances_);
+		wgpuBufferRelease(instances_);
+		instances_ = nullptr;
+	}
+	if (visible_) {
+		wgpuBufferDestroy(visible_);
+		wgpuBufferRelease(visible_);
+		visible_ = nullptr;
+	}
+}
+
+/**
+ * Creates the indirect argument block with the unit quad's index count filled in.
+ */
+void WGPU::Renderer::SpriteCuller::createIndirectArgs()
+{
+	WGPUBufferDescriptor bufferDesc = {};
+	bufferDesc.nextInChain = nullptr;
+	bufferDesc.label = "Cull indirect arguments";
+	bufferDesc.usage = WGPUBufferUsage_Storage | WGPUBufferUsage_Indirect | WGPUBufferUsage_CopyDst;
+	bufferDesc.size = Pipeline::SpriteCullPipeline::IndirectArgsSize;
+	bufferDesc.mappedAtCreation = true;
+	indirectArgs_ = wgpuDeviceCreateBuffer(Core::Device(), &bufferDesc);
+	if (!indirectArgs_) {
+		throw std::runtime_error("Failed to create sprite cull indirect buffer.");
+	}
+
+	// indexCount, instanceCount, firstIndex, baseVertex, firstInstance
+	const uint32_t args[5] = { static_cast<uint32_t>(quadIndices_->GetIndexCount()), 0, 0, 0, 0 };
+	std::memcpy(wgpuBufferGetMappedRange(indirectArgs_, 0, sizeof(args)), args, sizeof(args));
+	wgpuBufferUnmap(indirectArgs_);
+}
+
+void WGPU::Renderer::SpriteCuller::upload(uint64_t offset, std::span<const Buffer::SpriteInstance> instances, Buffer::StagingBelt* stagingBelt)
+{
+	if (instances.empty()) {
+		return;
+	}
+	if (stagingBelt) {
+		stagingBelt->WriteBuffer(instances_, offset, instances.data(), instances.size_bytes());
+	}
+	else {
+		wgpuQueueWriteBuffer(Core::Queue(), instances_, offset, instances.data(), instances.size_bytes());
+	}
+}
@@ -0,0 +1,122 @@
+#pragma once
+
+#include <webgpu/webgpu.h>
+#include <glm/glm.hpp>
+#include <memory>
+#include <span>
+#include <stdexcept>
+
+#include <core/Core.h>
+#include <utilities/Quad.h>
+#include <wgpu/buffer/SpriteInstance.h>
+#include <wgpu/buffer/StagingBelt.h>
+#include <wgpu/buffer/UniformBlock.h>
+#include <wgpu/buffer/VertexBuffer.h>
+#include <wgpu/buffer/IndexBuffer.h>
+#include <wgpu/pipelines/SpriteBatchPipeline.h>
+#include <wgpu/pipelines/SpriteCullPipeline.h>
+
+#include "SpriteBatch.h"
+
+namespace WGPU::Renderer {
+	struct SpriteCullUniforms {
+		glm::vec2 viewMin;
+		glm::vec2 viewMax;
+		uint32_t count;
+		float margin;
+
+		static constexpr std::array<size_t, 4> MemberOffsets() {
+			return { offsetof(SpriteCullUniforms, viewMin), offsetof(SpriteCullUniforms, viewMax),
+			         offsetof(SpriteCullUniforms, count), offsetof(SpriteCullUniforms, margin) };
+		}
+	};
+
+	/**
+	 * A large, mostly static set of sprites that the GPU culls against the view every frame.
+	 *
+	 * The sprites stay resident in a storage buffer; the CPU only uploads them when they
+	 * change. Cull() encodes a compute pass that compacts the sprites overlapping the view
+	 * into a second buffer and counts them into a DrawIndexedIndirect argument block.
+	 * Record() then draws that buffer as instances of the unit quad with one indirect draw.
+	 * No per-sprite visibility work happens on the CPU.
+	 *
+	 * Survivors are not kept in submission order (see SpriteCullPipeline), so this suits
+	 * layers like props and foliage rather than Y-sorted characters.
+	 *
+	 * @code
+	 * WGPU::Renderer::SpriteCuller props(texture->GetView(), texture->GetSampler(), projection);
+	 * props.SetInstances(overworldProps, &stagingBelt);
+	 * // every frame:
+	 * props.SetView(camera, camera + glm::vec2(CONFIG::NATIVE_SCREEN_WIDTH, CONFIG::NATIVE_SCREEN_HEIGHT));
+	 * WGPU::Renderer::SpriteBatchRenderPass::Present(view, Surface::Get(), Core::Device(), Core::Queue(), props);
+	 * @endcode
+	 */
+	class SpriteCuller {
+	public:
+		SpriteCuller(
+			WGPUTextureView textureView,
+			WGPUSampler sampler,
+			const glm::mat4& projection,
+			size_t initialCapacity = 16384,
+			Pipeline::SpriteBatchPipeline::SheetLayout sheet = Pipeline::SpriteBatchPipeline::SheetLayout::Texture2D
+		);
+		~SpriteCuller();
+
+		SpriteCuller(const SpriteCuller&) = delete;
+		SpriteCuller& operator=(const SpriteCuller&) = delete;
+
+		/**
+		 * @brief Replaces every sprite, growing the buffers if needed.
+		 */
+		void SetInstances(std::span<const Buffer::SpriteInstance> instances, Buffer::StagingBelt* stagingBelt = nullptr);
+
+		/**
+		 * @brief Overwrites a range of the current sprites in place.
+		 */
+		void UpdateInstances(uint32_t first, std::span<const Buffer::SpriteInstance> instances, Buffer::StagingBelt* stagingBelt = nullptr);
+
+		/**
+		 * @brief Sets the rectangle sprites are kept in, in the same space as their
+		 * positions. margin grows it on every side.
+		 */
+		void SetView(const glm::vec2& viewMin, const glm::vec2& viewMax, float margin = 0.0f, Buffer::StagingBelt* stagingBelt = nullptr);
+
+		void SetProjection(const glm::mat4& projection, Buffer::StagingBelt* stagingBelt = nullptr);
+
+		/**
+		 * @brief Encodes the cull as a compute pass. Must come before the render pass that
+		 * calls Record(), on the same or an earlier submitted encoder.
+		 */
+		void Cull(WGPUCommandEncoder encoder) const;
+
+		/**
+		 * @brief Draws whatever the last Cull() kept with one DrawIndexedIndirect.
+		 */
+		void Record(WGPURenderPassEncoder renderPass) const;
+
+		uint32_t GetInstanceCount() const { return instanceCount_; }
+		size_t GetCapacity() const { return capacity_; }
+		WGPUBuffer GetIndirectBuffer() const { return indirectArgs_; }
+	private:
+		std::unique_ptr<Buffer::UniformBlock<SpriteBatchUniforms>> uniforms_;
+		std::unique_ptr<Buffer::UniformBlock<SpriteCullUniforms>> cullUniforms_;
+		std::unique_ptr<Buffer::VertexBuffer> quadVertices_;
+		std::unique_ptr<Buffer::IndexBuffer> quadIndices_;
+		std::unique_ptr<Pipeline::SpriteBatchPipeline> pipeline_;
+		std::unique_ptr<Pipeline::SpriteCullPipeline> cullPipeline_;
+
+		// All sprites, the survivors of the last cull, and the draw arguments
+		WGPUBuffer instances_ = nullptr;
+		WGPUBuffer visible_ = nullptr;
+		WGPUBuffer indirectArgs_ = nullptr;
+		WGPUBindGroup cullBindGroup_ = nullptr;
+
+		size_t capacity_ = 0;
+		uint32_t instanceCount_ = 0;
+
+		void allocate(size_t capacity);
+		void releaseInstanceBuffers();
+		void createIndirectArgs();
+		void upload(uint64_t offset, std::span<const Buffer::SpriteInstance> instances, Buffer::StagingBelt* stagingBelt);
+	};
+}
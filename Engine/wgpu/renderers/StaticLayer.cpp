@@ -0,0 +1,87 @@
+#include "StaticLayer.h"
+
+WGPU::Renderer::StaticLayer::StaticLayer(WGPUTextureFormat colorFormat, std::string label) :
+	queue_(256),
+	colorFormat_(colorFormat),
+	label_(std::move(label))
+{
+	if (!Core::Device()) {
+		throw std::runtime_error("WebGPU device not initialized.");
+	}
+}
+
+WGPU::Renderer::StaticLayer::~StaticLayer()
+{
+	std::cout << "WGPU::Renderer::StaticLayer::~StaticLayer - Releasing " << label_ << "..." << std::endl;
+	releaseBundle();
+}
+
+void WGPU::Renderer::StaticLayer::Submit(uint8_t layer, float depth, const DrawCommand& draw)
+{
+	queue_.Submit(layer, depth, draw);
+	dirty_ = true;
+}
+
+void WGPU::Renderer::StaticLayer::Clear()
+{
+	queue_.Clear();
+	dirty_ = true;
+}
+
+void WGPU::Renderer::StaticLayer::Invalidate()
+{
+	dirty_ = true;
+}
+
+void WGPU::Renderer::StaticLayer::Execute(WGPURenderPassEncoder renderPass)
+{
+	if (dirty_) {
+		record();
+	}
+	if (bundle_) {
+		wgpuRenderPassEncoderExecuteBundles(renderPass, 1, &bundle_);
+	}
+}
+
+/**
+ * Records the sorted draws into a fresh bundle, replacing the previous one.
+ */
+void WGPU::Renderer::StaticLayer::record()
+{
+	releaseBundle();
+	dirty_ = false;
+	if (queue_.GetSize() == 0) {
+		return;
+	}
+
+	WGPURenderBundleEncoderDescriptor encoderDesc = {};
+	encoderDesc.nextInChain = nullptr;
+	encoderDesc.label = label_.c_str();
+	encoderDesc.colorFormatCount = 1;
+	encoderDesc.colorFormats = &colorFormat_;
+	encoderDesc.depthStencilFormat = WGPUTextureFormat_Undefined;
+	encoderDesc.sampleCount = 1;
+	encoderDesc.depthReadOnly = false;
+	encoderDesc.stencilReadOnly = false;
+	WGPURenderBundleEncoder encoder = wgpuDeviceCreateRenderBundleEncoder(Core::Device(), &encoderDesc);
+	if (!encoder) {
+		throw std::runtime_error("Failed to create render bundle encoder.");
+	}
+
+	queue_.Record(encoder);
+
+	WGPURenderBundleDescriptor bundleDesc = {};
+	bundleDesc.nextInChain = nullptr;
+	bundleDesc.label = label_.c_str();
+	bundle_ = wgpuRenderBundleEncoderFinish(encoder, &bundleDesc);
+	wgpuRenderBundleEncoderRelease(encoder);
+	++recordCount_;
+}
+
+void WGPU::Renderer::StaticLayer::releaseBundle()
+{
+	if (bundle_) {
+		wgpuRenderBundleRelease(bundle_);
+		bundle_ = nullptr;
+	}
+}
@@ -0,0 +1,92 @@
+#pragma once
+
+#include <webgpu/webgpu.h>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+#include <core/Core.h>
+
+#include "RenderQueue.h"
+
+namespace WGPU::Renderer {
+
+	/**
+	 * @class StaticLayer
+	 * @brief Draws that rarely change, recorded once into a render bundle and replayed.
+	 *
+	 * Submitted draws are kept (not cleared per frame) and sorted like a RenderQueue. The
+	 * first Execute() after a change records them into a WGPURenderBundle; every other
+	 * frame only costs one wgpuRenderPassEncoderExecuteBundles call.
+	 *
+	 * A bundle captures handles and offsets, not contents: buffers and textures it uses can
+	 * be rewritten freely, but anything that replaces a handle (a recreated bind group, a
+	 * rotating DynamicVertexBuffer, a grown MeshPool) needs Invalidate().
+	 *
+	 * @code
+	 * WGPU::Renderer::StaticLayer ground(Surface::Format());
+	 * for (const Tile& tile : map) ground.Submit(0, tile.y, tile.draw);
+	 * // every frame, inside the pass:
+	 * ground.Execute(renderPass);
+	 * @endcode
+	 */
+	class StaticLayer {
+	public:
+		/**
+		 * @param colorFormat Format of the pass attachment the bundle will run in.
+		 * @param label Debug label of the recorded bundle.
+		 */
+		explicit StaticLayer(WGPUTextureFormat colorFormat, std::string label = "Static layer");
+		~StaticLayer();
+
+		StaticLayer(const StaticLayer&) = delete;
+		StaticLayer& operator=(const StaticLayer&) = delete;
+
+		/*============================================================
+		* PUBLIC
+		=============================================================*/
+
+		/**
+		 * @brief Adds a draw to the layer, ordered like RenderQueue::Submit.
+		 */
+		void Submit(uint8_t layer, float depth, const DrawCommand& draw);
+
+		/**
+		 * @brief Removes every draw from the layer.
+		 */
+		void Clear();
+
+		/**
+		 * @brief Forces the bundle to be recorded again on the next Execute().
+		 */
+		void Invalidate();
+
+		/**
+		 * @brief Replays the layer into the pass, re-recording it first if it changed.
+		 */
+		void Execute(WGPURenderPassEncoder renderPass);
+
+		void SetLayerOrder(uint8_t layer, RenderQueue::LayerOrder order) { queue_.SetLayerOrder(layer, order); }
+
+		/**
+		 * @brief See RenderQueue::Forget. Call before releasing a handle the layer was given.
+		 */
+		void Forget(WGPURenderPipeline pipeline) { queue_.Forget(pipeline); }
+		void Forget(WGPUBindGroup bindGroup) { queue_.Forget(bindGroup); }
+
+		size_t GetDrawCount() const { return queue_.GetSize(); }
+		uint32_t GetRecordCount() const { return recordCount_; }
+		const RenderQueueStats& GetStats() const { return queue_.GetStats(); }
+	private:
+		RenderQueue queue_;
+		WGPURenderBundle bundle_ = nullptr;
+		WGPUTextureFormat colorFormat_;
+		std::string label_;
+		bool dirty_ = true;
+		uint32_t recordCount_ = 0;
+
+		void record();
+		void releaseBundle();
+	};
+}
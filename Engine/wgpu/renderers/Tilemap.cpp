@@ -0,0 +1,263 @@
+#include "Tilemap.h"
+
+#include <algorithm>
+#include <cmath>
+
+WGPU::Renderer::Tilemap::Tilemap(
+	uint32_t width,
+	uint32_t height,
+	uint32_t layerCount,
+	const Utilities::TextureImage& tileset,
+	const glm::vec2& tileSize
+) :
+	width_(width),
+	height_(height),
+	layerCount_(layerCount)
+{
+	if (width_ == 0 || height_ == 0 || layerCount_ == 0) {
+		throw std::invalid_argument("Tilemap: the map needs at least one tile and one layer.");
+	}
+	if (tileSize.x < 1.0f || tileSize.y < 1.0f) {
+		throw std::invalid_argument("Tilemap: tiles must be at least one pixel.");
+	}
+
+	// Whole tiles in the tileset; a partial row or column at the edge is ignored
+	const glm::vec2 atlasSize(
+		std::floor(static_cast<float>(wgpuTextureGetWidth(tileset.GetTexture())) / tileSize.x),
+		std::floor(static_cast<float>(wgpuTextureGetHeight(tileset.GetTexture())) / tileSize.y)
+	);
+	if (atlasSize.x < 1.0f || atlasSize.y < 1.0f) {
+		throw std::invalid_argument("Tilemap: the tileset is smaller than one tile.");
+	}
+
+	// Fail here rather than at draw time if the host struct drifts from the shader
+	Shader::ShaderReflection::Reflect(Pipeline::TilemapPipeline::GetShaderSource())->Validate<TilemapUniforms>(0, 0);
+
+	uniforms_ = std::make_unique<Buffer::UniformBlock<TilemapUniforms>>(TilemapUniforms{
+		glm::vec2(0.0f),
+		tileSize,
+		glm::vec2(static_cast<float>(width_), static_cast<float>(height_)),
+		atlasSize
+	});
+	uniforms_->Write();
+
+	tiles_.assign(static_cast<size_t>(width_) * height_ * layerCount_, 0);
+	dirty_.resize(layerCount_);
+	createIndexTexture();
+
+	pipeline_ = std::make_unique<Pipeline::TilemapPipeline>(
+		uniforms_->Get(),
+		uniforms_->GetSize(),
+		indexView_,
+		tileset.GetView()
+	);
+}
+
+WGPU::Renderer::Tilemap::~Tilemap()
+{
+	std::cout << "WGPU::Renderer::Tilemap::~Tilemap - Releasing tile index texture..." << std::endl;
+	pipeline_.reset();
+	if (indexView_) {
+		wgpuTextureViewRelease(indexView_);
+		indexView_ = nullptr;
+	}
+	if (indexTexture_) {
+		wgpuTextureDestroy(indexTexture_);
+		wgpuTextureRelease(indexTexture_);
+		indexTexture_ = nullptr;
+	}
+}
+
+void WGPU::Renderer::Tilemap::SetTile(uint32_t layer, uint32_t x, uint32_t y, uint16_t tile)
+{
+	checkLayer(layer);
+	if (x >= width_ || y >= height_) {
+		throw std::out_of_range("Tilemap: tile outside the map.");
+	}
+	tiles_[indexOf(layer, x, y)] = tile;
+	markDirty(layer, x, y, 1, 1);
+}
+
+void WGPU::Renderer::Tilemap::SetTiles(uint32_t layer, uint32_t x, uint32_t y, uint32_t width, uint32_t height, std::span<const uint16_t> tiles)
+{
+	checkLayer(layer);
+	if (x > width_ || y > height_ || width > width_ - x || height > height_ - y) {
+		throw std::out_of_range("Tilemap: rect outside the map.");
+	}
+	if (tiles.size() < static_cast<size_t>(width) * height) {
+		throw std::invalid_argument("Tilemap: fewer tiles than the rect holds.");
+	}
+	if (width == 0 || height == 0) {
+		return;
+	}
+
+	for (uint32_t row = 0; row < height; ++row) {
+		std::copy_n(tiles.data() + static_cast<size_t>(row) * width, width, tiles_.data() + indexOf(layer, x, y + row));
+	}
+	markDirty(layer, x, y, width, height);
+}
+
+void WGPU::Renderer::Tilemap::Fill(uint32_t layer, uint16_t tile)
+{
+	checkLayer(layer);
+	const size_t layerSize = static_cast<size_t>(width_) * height_;
+	std::fill_n(tiles_.data() + layer * layerSize, layerSize, tile);
+	markDirty(layer, 0, 0, width_, height_);
+}
+
+uint16_t WGPU::Renderer::Tilemap::GetTile(uint32_t layer, uint32_t x, uint32_t y) const
+{
+	checkLayer(layer);
+	if (x >= width_ || y >= height_) {
+		throw std::out_of_range("Tilemap: tile outside the map.");
+	}
+	return tiles_[indexOf(layer, x, y)];
+}
+
+/**
+ * Writes every dirty rect as a sub-rect texture copy and resets the rects.
+ *
+ * @param stagingBelt Optional belt the copies are recorded on.
+ */
+void WGPU::Renderer::Tilemap::Upload(Buffer::StagingBelt* stagingBelt)
+{
+	for (uint32_t layer = 0; layer < layerCount_; ++layer) {
+		DirtyRect& rect = dirty_[layer];
+		if (rect.IsEmpty()) {
+			continue;
+		}
+
+		WGPUImageCopyTexture destination = {};
+		destination.nextInChain = nullptr;
+		destination.texture = indexTexture_;
+		destination.mipLevel = 0;
+		destination.origin = { rect.minX, rect.minY, layer };
+		destination.aspect = WGPUTextureAspect_All;
+
+		const WGPUExtent3D copySize = { rect.maxX - rect.minX, rect.maxY - rect.minY, 1 };
+		const uint32_t rowBytes = copySize.width * static_cast<uint32_t>(sizeof(uint16_t));
+
+		if (stagingBelt) {
+			// The belt copies whole source rows, so the rect is packed first
+			scratch_.resize(static_cast<size_t>(copySize.width) * copySize.height);
+			for (uint32_t row = 0; row < copySize.height; ++row) {
+				std::copy_n(tiles_.data() + indexOf(layer, rect.minX, rect.minY + row), copySize.width, scratch_.data() + static_cast<size_t>(row) * copySize.width);
+			}
+			stagingBelt->WriteTexture(destination, scratch_.data(), rowBytes, copySize);
+		}
+		else {
+			// writeTexture reads the rect straight out of the host copy
+			WGPUTextureDataLayout source = {};
+			source.nextInChain = nullptr;
+			source.offset = indexOf(layer, rect.minX, rect.minY) * sizeof(uint16_t);
+			source.bytesPerRow = width_ * static_cast<uint32_t>(sizeof(uint16_t));
+			source.rowsPerImage = height_;
+
+			wgpuQueueWriteTexture(Core::Queue(), &destination, tiles_.data(), tiles_.size() * sizeof(uint16_t), &source, &copySize);
+		}
+
+		rect = DirtyRect{};
+	}
+}
+
+void WGPU::Renderer::Tilemap::SetCamera(const glm::vec2& camera, Buffer::StagingBelt* stagingBelt)
+{
+	uniforms_->Set<&TilemapUniforms::camera>(camera);
+	uniforms_->Write(stagingBelt);
+}
+
+void WGPU::Renderer::Tilemap::Record(WGPURenderPassEncoder renderPass) const
+{
+	wgpuRenderPassEncoderSetPipeline(renderPass, pipeline_->GetPipeline());
+	wgpuRenderPassEncoderSetBindGroup(renderPass, 0, pipeline_->GetBindGroup(), 0, nullptr);
+	wgpuRenderPassEncoderDraw(renderPass, 3, layerCount_, 0, 0);
+}
+
+void WGPU::Renderer::Tilemap::RecordLayer(WGPURenderPassEncoder renderPass, uint32_t layer) const
+{
+	checkLayer(layer);
+	wgpuRenderPassEncoderSetPipeline(renderPass, pipeline_->GetPipeline());
+	wgpuRenderPassEncoderSetBindGroup(renderPass, 0, pipeline_->GetBindGroup(), 0, nullptr);
+	wgpuRenderPassEncoderDraw(renderPass, 3, 1, 0, layer);
+}
+
+/**
+ * Describes one layer as a single draw for a RenderQueue. Consecutive layers merge
+ * into one instanced draw there.
+ *
+ * @param layer The map layer to draw.
+ */
+WGPU::Renderer::DrawCommand WGPU::Renderer::Tilemap::GetDrawCommand(uint32_t layer) const
+{
+	checkLayer(layer);
+	DrawCommand draw;
+	draw.pipeline = pipeline_->GetPipeline();
+	draw.bindGroups[0] = pipeline_->GetBindGroup();
+	draw.count = 3;
+	draw.firstInstance = layer;
+	return draw;
+}
+
+bool WGPU::Renderer::Tilemap::HasPendingEdits() const
+{
+	return std::any_of(dirty_.begin(), dirty_.end(), [](const DirtyRect& rect) { return !rect.IsEmpty(); });
+}
+
+/**
+ * Creates the R16Uint index texture, one array layer per map layer.
+ */
+void WGPU::Renderer::Tilemap::createIndexTexture()
+{
+	WGPUTextureDescriptor textureDesc = {};
+	textureDesc.nextInChain = nullptr;
+	textureDesc.label = "Tile index texture";
+	textureDesc.dimension = WGPUTextureDimension_2D;
+	textureDesc.size = { width_, height_, layerCount_ };
+	textureDesc.format = WGPUTextureFormat_R16Uint;
+	textureDesc.usage = WGPUTextureUsage_TextureBinding | WGPUTextureUsage_CopyDst;
+	textureDesc.mipLevelCount = 1;
+	textureDesc.sampleCount = 1;
+	textureDesc.viewFormatCount = 0;
+	textureDesc.viewFormats = nullptr;
+	indexTexture_ = wgpuDeviceCreateTexture(Core::Device(), &textureDesc);
+	if (!indexTexture_) {
+		throw std::runtime_error("Failed to create tile index texture.");
+	}
+
+	// Always an array view, even for a single layer, to match texture_2d_array
+	WGPUTextureViewDescriptor viewDesc = {};
+	viewDesc.nextInChain = nullptr;
+	viewDesc.label = "Tile index view";
+	viewDesc.format = WGPUTextureFormat_R16Uint;
+	viewDesc.dimension = WGPUTextureViewDimension_2DArray;
+	viewDesc.baseMipLevel = 0;
+	viewDesc.mipLevelCount = 1;
+	viewDesc.baseArrayLayer = 0;
+	viewDesc.arrayLayerCount = layerCount_;
+	viewDesc.aspect = WGPUTextureAspect_All;
+	indexView_ = wgpuTextureCreateView(indexTexture_, &viewDesc);
+	if (!indexView_) {
+		throw std::runtime_error("Failed to create tile index view.");
+	}
+}
+
+void WGPU::Renderer::Tilemap::markDirty(uint32_t layer, uint32_t x, uint32_t y, uint32_t width, uint32_t height)
+{
+	DirtyRect& rect = dirty_[layer];
+	rect.minX = std::min(rect.minX, x);
+	rect.minY = std::min(rect.minY, y);
+	rect.maxX = std::max(rect.maxX, x + width);
+	rect.maxY = std::max(rect.maxY, y + height);
+}
+
+void WGPU::Renderer::Tilemap::checkLayer(uint32_t layer) const
+{
+	if (layer >= layerCount_) {
+		throw std::out_of_range("Tilemap: layer out of range.");
+	}
+}
+
+size_t WGPU::Renderer::Tilemap::indexOf(uint32_t layer, uint32_t x, uint32_t y) const
+{
+	return (static_cast<size_t>(layer) * height_ + y) * width_ + x;
+}
@@ -0,0 +1,153 @@
+#pragma once
+
+#include <webgpu/webgpu.h>
+#include <glm/glm.hpp>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <stdexcept>
+#include <vector>
+
+#include <core/Core.h>
+#include <utilities/TextureImage.h>
+#include <wgpu/buffer/StagingBelt.h>
+#include <wgpu/buffer/UniformBlock.h>
+#include <wgpu/pipelines/TilemapPipeline.h>
+
+#include "RenderQueue.h"
+
+namespace WGPU::Renderer {
+	struct TilemapUniforms {
+		glm::vec2 camera;     // Map pixel drawn at the top-left of the target
+		glm::vec2 tileSize;   // Pixels per tile
+		glm::vec2 mapSize;    // Tiles per row and column
+		glm::vec2 atlasSize;  // Tiles per row and column of the tileset
+
+		static constexpr std::array<size_t, 4> MemberOffsets() {
+			return { offsetof(TilemapUniforms, camera), offsetof(TilemapUniforms, tileSize),
+			         offsetof(TilemapUniforms, mapSize), offsetof(TilemapUniforms, atlasSize) };
+		}
+	};
+
+	/**
+	 * A layered tile map drawn with one full-target triangle per layer.
+	 *
+	 * The tile indices live in an R16Uint 2D array texture (one texel per tile, one array
+	 * layer per map layer) with a host copy next to it. SetTile() / SetTiles() edit the
+	 * host copy and grow a dirty rect per layer; Upload() writes only those rects. The
+	 * fragment shader resolves every pixel to a tileset texel itself, so the cost follows
+	 * the number of pixels on screen, not the size of the map.
+	 *
+	 * Index 0 is an empty tile; index n is the (n - 1)th tile of the tileset, row-major.
+	 *
+	 * @code
+	 * WGPU::Renderer::Tilemap map(256, 256, 2, *tileset, glm::vec2(16.0f));
+	 * map.SetTiles(0, 0, 0, 256, 256, groundTiles);
+	 * map.Upload(&stagingBelt);
+	 * // every frame:
+	 * map.SetCamera(camera);
+	 * map.Record(renderPass);
+	 * @endcode
+	 */
+	class Tilemap {
+	public:
+		/**
+		 * @param width Map width in tiles.
+		 * @param height Map height in tiles.
+		 * @param layerCount Number of layers, drawn from 0 upwards.
+		 * @param tileset Texture holding the tiles in a grid without spacing.
+		 * @param tileSize Size of one tile in pixels.
+		 */
+		Tilemap(
+			uint32_t width,
+			uint32_t height,
+			uint32_t layerCount,
+			const Utilities::TextureImage& tileset,
+			const glm::vec2& tileSize
+		);
+		~Tilemap();
+
+		Tilemap(const Tilemap&) = delete;
+		Tilemap& operator=(const Tilemap&) = delete;
+
+		/*============================================================
+		* EDITING
+		=============================================================*/
+
+		void SetTile(uint32_t layer, uint32_t x, uint32_t y, uint16_t tile);
+
+		/**
+		 * @brief Copies a rect of tiles, row-major and tightly packed, into a layer.
+		 */
+		void SetTiles(uint32_t layer, uint32_t x, uint32_t y, uint32_t width, uint32_t height, std::span<const uint16_t> tiles);
+
+		void Fill(uint32_t layer, uint16_t tile);
+
+		uint16_t GetTile(uint32_t layer, uint32_t x, uint32_t y) const;
+
+		/**
+		 * @brief Writes the dirty rect of every layer to the index texture.
+		 *
+		 * @param stagingBelt Optional belt to batch the copies with other uploads;
+		 *        otherwise each rect is one queue write.
+		 */
+		void Upload(Buffer::StagingBelt* stagingBelt = nullptr);
+
+		/*============================================================
+		* DRAWING
+		=============================================================*/
+
+		/**
+		 * @brief Sets the map pixel drawn at the top-left of the target. Whole pixels keep
+		 * the map pixel perfect. With a staging belt the uniform goes up with its next submit.
+		 */
+		void SetCamera(const glm::vec2& camera, Buffer::StagingBelt* stagingBelt = nullptr);
+
+		/**
+		 * @brief Draws every layer, bottom to top, with one draw call.
+		 */
+		void Record(WGPURenderPassEncoder renderPass) const;
+
+		/**
+		 * @brief Draws a single layer, to put other draws between layers.
+		 */
+		void RecordLayer(WGPURenderPassEncoder renderPass, uint32_t layer) const;
+
+		/**
+		 * The draw RecordLayer() would encode, for submitting a layer to a RenderQueue.
+		 */
+		DrawCommand GetDrawCommand(uint32_t layer) const;
+
+		uint32_t GetWidth() const { return width_; }
+		uint32_t GetHeight() const { return height_; }
+		uint32_t GetLayerCount() const { return layerCount_; }
+		bool HasPendingEdits() const;
+	private:
+		// Tiles changed since the last Upload(), as a half-open rect
+		struct DirtyRect {
+			uint32_t minX = UINT32_MAX;
+			uint32_t minY = UINT32_MAX;
+			uint32_t maxX = 0;
+			uint32_t maxY = 0;
+
+			bool IsEmpty() const { return minX >= maxX || minY >= maxY; }
+		};
+
+		std::unique_ptr<Buffer::UniformBlock<TilemapUniforms>> uniforms_;
+		std::unique_ptr<Pipeline::TilemapPipeline> pipeline_;
+		WGPUTexture indexTexture_ = nullptr;
+		WGPUTextureView indexView_ = nullptr;
+
+		uint32_t width_;
+		uint32_t height_;
+		uint32_t layerCount_;
+		std::vector<uint16_t> tiles_;
+		std::vector<DirtyRect> dirty_;
+		std::vector<uint16_t> scratch_;
+
+		void createIndexTexture();
+		void markDirty(uint32_t layer, uint32_t x, uint32_t y, uint32_t width, uint32_t height);
+		void checkLayer(uint32_t layer) const;
+		size_t indexOf(uint32_t layer, uint32_t x, uint32_t y) const;
+	};
+}
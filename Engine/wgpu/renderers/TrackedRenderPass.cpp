@@ -0,0 +1,158 @@
+#include "TrackedRenderPass.h"
+
+#include <algorithm>
+#include <iostream>
+#include <stdexcept>
+
+WGPU::Renderer::TrackedRenderPass::TrackedRenderPass(WGPURenderPassEncoder renderPass) :
+	renderPass_(renderPass)
+{
+	if (!renderPass_) {
+		throw std::invalid_argument("TrackedRenderPass: render pass encoder is null.");
+	}
+}
+
+void WGPU::Renderer::TrackedRenderPass::SetPipeline(WGPURenderPipeline pipeline, WGPUPrimitiveTopology topology)
+{
+	topology_ = topology;
+	if (pipeline == pipeline_) {
+		++stats_.redundantSkipped;
+		return;
+	}
+
+	wgpuRenderPassEncoderSetPipeline(renderPass_, pipeline);
+	pipeline_ = pipeline;
+	++stats_.pipelineChanges;
+	stateChanged();
+}
+
+void WGPU::Renderer::TrackedRenderPass::SetBindGroup(uint32_t group, WGPUBindGroup bindGroup, std::span<const uint32_t> dynamicOffsets)
+{
+	if (group >= MaxBindGroups) {
+		throw std::out_of_range("TrackedRenderPass: bind group index out of range.");
+	}
+
+	BoundBindGroup& bound = bindGroups_[group];
+	if (bindGroup == bound.bindGroup && std::ranges::equal(dynamicOffsets, bound.dynamicOffsets)) {
+		++stats_.redundantSkipped;
+		return;
+	}
+
+	wgpuRenderPassEncoderSetBindGroup(renderPass_, group, bindGroup, dynamicOffsets.size(), dynamicOffsets.data());
+	bound.bindGroup = bindGroup;
+	bound.dynamicOffsets.assign(dynamicOffsets.begin(), dynamicOffsets.end());
+	++stats_.bindGroupChanges;
+	stateChanged();
+}
+
+void WGPU::Renderer::TrackedRenderPass::SetVertexBuffer(uint32_t slot, WGPUBuffer buffer, uint64_t offset, uint64_t size)
+{
+	if (slot >= MaxVertexBuffers) {
+		throw std::out_of_range("TrackedRenderPass: vertex buffer slot out of range.");
+	}
+
+	BoundBuffer& bound = vertexBuffers_[slot];
+	if (buffer == bound.buffer && offset == bound.offset && size == bound.size) {
+		++stats_.redundantSkipped;
+		return;
+	}
+
+	wgpuRenderPassEncoderSetVertexBuffer(renderPass_, slot, buffer, offset, size);
+	bound = { buffer, offset, size };
+	++stats_.bufferChanges;
+	stateChanged();
+}
+
+void WGPU::Renderer::TrackedRenderPass::SetIndexBuffer(WGPUBuffer buffer, WGPUIndexFormat format, uint64_t offset, uint64_t size)
+{
+	if (buffer == indexBuffer_.buffer && format == indexFormat_ && offset == indexBuffer_.offset && size == indexBuffer_.size) {
+		++stats_.redundantSkipped;
+		return;
+	}
+
+	wgpuRenderPassEncoderSetIndexBuffer(renderPass_, buffer, format, offset, size);
+	indexBuffer_ = { buffer, offset, size };
+	indexFormat_ = format;
+	++stats_.bufferChanges;
+	stateChanged();
+}
+
+void WGPU::Renderer::TrackedRenderPass::Draw(uint32_t vertexCount, uint32_t instanceCount, uint32_t firstVertex, uint32_t firstInstance)
+{
+	wgpuRenderPassEncoderDraw(renderPass_, vertexCount, instanceCount, firstVertex, firstInstance);
+	countDraw(false, vertexCount, instanceCount, firstVertex, 0, firstInstance);
+}
+
+void WGPU::Renderer::TrackedRenderPass::DrawIndexed(uint32_t indexCount, uint32_t instanceCount, uint32_t firstIndex, int32_t baseVertex, uint32_t firstInstance)
+{
+	wgpuRenderPassEncoderDrawIndexed(renderPass_, indexCount, instanceCount, firstIndex, baseVertex, firstInstance);
+	countDraw(true, indexCount, instanceCount, firstIndex, baseVertex, firstInstance);
+}
+
+void WGPU::Renderer::TrackedRenderPass::DrawIndirect(WGPUBuffer indirectBuffer, uint64_t indirectOffset)
+{
+	wgpuRenderPassEncoderDrawIndirect(renderPass_, indirectBuffer, indirectOffset);
+	++stats_.draws;
+	++stats_.indirectDraws;
+}
+
+void WGPU::Renderer::TrackedRenderPass::DrawIndexedIndirect(WGPUBuffer indirectBuffer, uint64_t indirectOffset)
+{
+	wgpuRenderPassEncoderDrawIndexedIndirect(renderPass_, indirectBuffer, indirectOffset);
+	++stats_.draws;
+	++stats_.indirectDraws;
+}
+
+void WGPU::Renderer::TrackedRenderPass::Reset()
+{
+	pipeline_ = nullptr;
+	for (BoundBindGroup& bound : bindGroups_) {
+		bound.bindGroup = nullptr;
+		bound.dynamicOffsets.clear();
+	}
+	vertexBuffers_.fill({});
+	indexBuffer_ = {};
+	indexFormat_ = WGPUIndexFormat_Undefined;
+	stateChanged(); // Whatever was encoded directly may have changed it
+}
+
+void WGPU::Renderer::TrackedRenderPass::stateChanged()
+{
+#ifndef NDEBUG
+	++stateVersion_;
+#endif
+}
+
+void WGPU::Renderer::TrackedRenderPass::countDraw(bool indexed, uint32_t count, uint32_t instanceCount, uint32_t first, int32_t baseVertex, uint32_t firstInstance)
+{
+	++stats_.draws;
+	stats_.instances += instanceCount;
+	stats_.triangles += trianglesPerInstance(count) * instanceCount;
+
+#ifndef NDEBUG
+	const DrawSignature draw{ stateVersion_, indexed, count, instanceCount, first, baseVertex, firstInstance };
+	if (draw == lastDraw_) {
+		++stats_.duplicateDraws;
+		if (!reportedDuplicate_) {
+			std::cerr << "WGPU::Renderer::TrackedRenderPass - Duplicate " << (indexed ? "DrawIndexed" : "Draw")
+				<< " (count " << count << ", " << instanceCount << " instances) with nothing bound in between." << std::endl;
+			reportedDuplicate_ = true;
+		}
+	}
+	lastDraw_ = draw;
+#else
+	(void)indexed; (void)first; (void)baseVertex; (void)firstInstance;
+#endif
+}
+
+uint64_t WGPU::Renderer::TrackedRenderPass::trianglesPerInstance(uint32_t count) const
+{
+	switch (topology_) {
+	case WGPUPrimitiveTopology_TriangleList:
+		return count / 3;
+	case WGPUPrimitiveTopology_TriangleStrip:
+		return count > 2 ? count - 2 : 0;
+	default:
+		return 0; // Points and lines
+	}
+}
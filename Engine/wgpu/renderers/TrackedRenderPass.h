@@ -0,0 +1,148 @@
+#pragma once
+
+#include <webgpu/webgpu.h>
+#include <array>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace WGPU::Renderer {
+
+	/**
+	 * @struct TrackedRenderPassStats
+	 * @brief What has been encoded through a TrackedRenderPass so far.
+	 */
+	struct TrackedRenderPassStats {
+		uint32_t draws = 0;             // Direct and indirect
+		uint32_t indirectDraws = 0;     // Their instances and triangles are not known on the CPU
+		uint64_t instances = 0;
+		uint64_t triangles = 0;
+		uint32_t pipelineChanges = 0;
+		uint32_t bindGroupChanges = 0;
+		uint32_t bufferChanges = 0;
+		uint32_t redundantSkipped = 0;  // Binds dropped because the state was already bound
+		uint32_t duplicateDraws = 0;    // Debug builds only: same draw twice with nothing bound in between
+	};
+
+	/**
+	 * @class TrackedRenderPass
+	 * @brief Thin wrapper over a WGPURenderPassEncoder that remembers what is bound and
+	 * drops binds that would not change anything.
+	 *
+	 * Setting the pipeline, a bind group (with the same dynamic offsets), a vertex or the
+	 * index buffer to what is already bound is not forwarded to the encoder. Every draw
+	 * and every state change that does go through is counted; triangles are counted for
+	 * the topology given with the pipeline.
+	 *
+	 * In debug builds a draw identical to the previous one with no state change in
+	 * between is counted in duplicateDraws and reported once per pass, since it draws the
+	 * same pixels twice.
+	 *
+	 * The encoder is not owned: begin, end and release it as before. After encoding
+	 * through Get() directly, call Reset() so nothing is skipped on stale state.
+	 *
+	 * @code
+	 * TrackedRenderPass pass(wgpuCommandEncoderBeginRenderPass(encoder, &renderPassDesc));
+	 * pass.SetPipeline(pipeline);
+	 * pass.SetVertexBuffer(0, vertexBuffer);
+	 * pass.SetIndexBuffer(indexBuffer, WGPUIndexFormat_Uint16);
+	 * for (const Sprite& sprite : sprites) {
+	 *     pass.SetBindGroup(0, sprite.bindGroup); // skipped while the texture stays the same
+	 *     pass.DrawIndexed(6);
+	 * }
+	 * wgpuRenderPassEncoderEnd(pass.Get());
+	 * wgpuRenderPassEncoderRelease(pass.Get());
+	 * @endcode
+	 */
+	class TrackedRenderPass {
+	public:
+		// WebGPU default limits for maxBindGroups and maxVertexBuffers
+		static constexpr uint32_t MaxBindGroups = 4;
+		static constexpr uint32_t MaxVertexBuffers = 8;
+
+		explicit TrackedRenderPass(WGPURenderPassEncoder renderPass);
+
+		TrackedRenderPass(const TrackedRenderPass&) = delete;
+		TrackedRenderPass& operator=(const TrackedRenderPass&) = delete;
+
+		/*============================================================
+		* PUBLIC
+		=============================================================*/
+
+		/**
+		 * @param topology Primitive topology the pipeline was created with, for the triangle count.
+		 */
+		void SetPipeline(WGPURenderPipeline pipeline, WGPUPrimitiveTopology topology = WGPUPrimitiveTopology_TriangleList);
+
+		/**
+		 * @throws std::out_of_range If group is not below MaxBindGroups.
+		 */
+		void SetBindGroup(uint32_t group, WGPUBindGroup bindGroup, std::span<const uint32_t> dynamicOffsets = {});
+
+		/**
+		 * @throws std::out_of_range If slot is not below MaxVertexBuffers.
+		 */
+		void SetVertexBuffer(uint32_t slot, WGPUBuffer buffer, uint64_t offset = 0, uint64_t size = WGPU_WHOLE_SIZE);
+
+		void SetIndexBuffer(WGPUBuffer buffer, WGPUIndexFormat format, uint64_t offset = 0, uint64_t size = WGPU_WHOLE_SIZE);
+
+		void Draw(uint32_t vertexCount, uint32_t instanceCount = 1, uint32_t firstVertex = 0, uint32_t firstInstance = 0);
+		void DrawIndexed(uint32_t indexCount, uint32_t instanceCount = 1, uint32_t firstIndex = 0, int32_t baseVertex = 0, uint32_t firstInstance = 0);
+		void DrawIndirect(WGPUBuffer indirectBuffer, uint64_t indirectOffset);
+		void DrawIndexedIndirect(WGPUBuffer indirectBuffer, uint64_t indirectOffset);
+
+		/**
+		 * @brief Forgets the bound state, so the next bind of anything goes through.
+		 */
+		void Reset();
+
+		WGPURenderPassEncoder Get() const { return renderPass_; }
+		const TrackedRenderPassStats& GetStats() const { return stats_; }
+	private:
+		struct BoundBindGroup {
+			WGPUBindGroup bindGroup = nullptr;
+			std::vector<uint32_t> dynamicOffsets;
+		};
+
+		struct BoundBuffer {
+			WGPUBuffer buffer = nullptr;
+			uint64_t offset = 0;
+			uint64_t size = 0;
+		};
+
+		WGPURenderPassEncoder renderPass_ = nullptr;
+
+		WGPURenderPipeline pipeline_ = nullptr;
+		WGPUPrimitiveTopology topology_ = WGPUPrimitiveTopology_TriangleList;
+		std::array<BoundBindGroup, MaxBindGroups> bindGroups_{};
+		std::array<BoundBuffer, MaxVertexBuffers> vertexBuffers_{};
+		BoundBuffer indexBuffer_;
+		WGPUIndexFormat indexFormat_ = WGPUIndexFormat_Undefined;
+
+		TrackedRenderPassStats stats_;
+
+#ifndef NDEBUG
+		// Bumped on every state change that reaches the encoder; equal draws under the
+		// same version drew exactly the same thing
+		struct DrawSignature {
+			uint64_t stateVersion = 0;
+			bool indexed = false;
+			uint32_t count = 0;
+			uint32_t instanceCount = 0;
+			uint32_t first = 0;
+			int32_t baseVertex = 0;
+			uint32_t firstInstance = 0;
+
+			bool operator==(const DrawSignature&) const = default;
+		};
+
+		uint64_t stateVersion_ = 1;
+		DrawSignature lastDraw_;
+		bool reportedDuplicate_ = false;
+#endif
+
+		void stateChanged();
+		void countDraw(bool indexed, uint32_t count, uint32_t instanceCount, uint32_t first, int32_t baseVertex, uint32_t firstInstance);
+		uint64_t trianglesPerInstance(uint32_t count) const;
+	};
+}
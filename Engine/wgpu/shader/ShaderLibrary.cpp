@@ -0,0 +1,239 @@
+#include "ShaderLibrary.h"
+
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <system_error>
+#include <utility>
+
+WGPU::Shader::ShaderModule::~ShaderModule()
+{
+	if (handle) {
+		wgpuShaderModuleRelease(handle);
+		handle = nullptr;
+	}
+}
+
+WGPU::Shader::ShaderLibrary::~ShaderLibrary()
+{
+	stopWatcher();
+}
+
+WGPU::Shader::ShaderRef WGPU::Shader::ShaderLibrary::Load(const std::string& name, const std::filesystem::path& path, std::string_view fallback)
+{
+	ShaderLibrary& library = retrieveInstance();
+	{
+		std::lock_guard<std::mutex> lock(library.mutex_);
+		auto entry = library.shaders_.find(name);
+		if (entry != library.shaders_.end()) {
+			return entry->second.current;
+		}
+	}
+
+	auto program = std::make_shared<ShaderProgram>();
+	program->name = name;
+	program->path = path;
+
+	std::error_code error;
+	const auto lastWrite = std::filesystem::last_write_time(path, error);
+	if (!readFile(path, program->source)) {
+		if (fallback.empty()) {
+			throw std::runtime_error("ShaderLibrary: cannot read shader '" + name + "' from " + path.string());
+		}
+		std::cout << "ShaderLibrary: " << path.string() << " not found, using the built-in '" << name << "' shader." << std::endl;
+		program->source = fallback;
+	}
+	program->hash = std::hash<std::string_view>{}(program->source);
+
+	std::lock_guard<std::mutex> lock(library.mutex_);
+	auto [entry, inserted] = library.shaders_.try_emplace(name);
+	if (inserted) {
+		entry->second.current = program;
+		entry->second.lastWrite = error ? std::filesystem::file_time_type{} : lastWrite;
+		entry->second.lastSeenHash = program->hash;
+	}
+	return entry->second.current; // Another thread may have loaded it meanwhile
+}
+
+WGPU::Shader::ShaderRef WGPU::Shader::ShaderLibrary::Get(const std::string& name)
+{
+	ShaderLibrary& library = retrieveInstance();
+	std::lock_guard<std::mutex> lock(library.mutex_);
+	auto entry = library.shaders_.find(name);
+	return entry != library.shaders_.end() ? entry->second.current : nullptr;
+}
+
+WGPU::Shader::ShaderModuleRef WGPU::Shader::ShaderLibrary::AcquireModule(std::string_view source)
+{
+	ShaderLibrary& library = retrieveInstance();
+	const size_t hash = std::hash<std::string_view>{}(source);
+
+	std::lock_guard<std::mutex> lock(library.mutex_);
+	std::weak_ptr<const ShaderModule>& slot = library.modules_[hash];
+	if (ShaderModuleRef module = slot.lock(); module && module->source == source) {
+		return module;
+	}
+
+	auto module = std::make_shared<ShaderModule>();
+	module->source = source;
+
+	WGPUShaderModuleWGSLDescriptor shaderCodeDesc{};
+	shaderCodeDesc.chain.next = nullptr;
+	shaderCodeDesc.chain.sType = WGPUSType_ShaderModuleWGSLDescriptor;
+	shaderCodeDesc.code = module->source.c_str();
+
+	WGPUShaderModuleDescriptor shaderDesc{};
+	shaderDesc.nextInChain = &shaderCodeDesc.chain;
+	module->handle = wgpuDeviceCreateShaderModule(Core::Device(), &shaderDesc);
+	if (!module->handle) {
+		throw std::runtime_error("ShaderLibrary: failed to create shader module.");
+	}
+
+	// A hash collision just takes over the slot; the other module lives on with its users
+	slot = module;
+	return module;
+}
+
+void WGPU::Shader::ShaderLibrary::EnableHotReload(std::chrono::milliseconds interval)
+{
+	ShaderLibrary& library = retrieveInstance();
+	if (library.watching_.exchange(true)) {
+		return;
+	}
+	{
+		std::lock_guard<std::mutex> lock(library.watcherMutex_);
+		library.watcherStop_ = false;
+	}
+	library.watcher_ = std::thread(&ShaderLibrary::watch, &library, interval);
+}
+
+void WGPU::Shader::ShaderLibrary::DisableHotReload()
+{
+	retrieveInstance().stopWatcher();
+}
+
+bool WGPU::Shader::ShaderLibrary::IsHotReloadEnabled()
+{
+	return retrieveInstance().watching_;
+}
+
+std::vector<WGPU::Shader::ShaderRef> WGPU::Shader::ShaderLibrary::TakeReloads()
+{
+	ShaderLibrary& library = retrieveInstance();
+	std::lock_guard<std::mutex> lock(library.mutex_);
+	return std::exchange(library.reloads_, {});
+}
+
+void WGPU::Shader::ShaderLibrary::Commit(const ShaderRef& program)
+{
+	ShaderLibrary& library = retrieveInstance();
+	std::lock_guard<std::mutex> lock(library.mutex_);
+	auto entry = library.shaders_.find(program->name);
+	if (entry != library.shaders_.end() && entry->second.current->version < program->version) {
+		entry->second.current = program;
+	}
+}
+
+void WGPU::Shader::ShaderLibrary::stopWatcher()
+{
+	if (!watching_.exchange(false)) {
+		return;
+	}
+	{
+		std::lock_guard<std::mutex> lock(watcherMutex_);
+		watcherStop_ = true;
+	}
+	watcherWake_.notify_all();
+	if (watcher_.joinable()) {
+		watcher_.join();
+	}
+}
+
+void WGPU::Shader::ShaderLibrary::watch(std::chrono::milliseconds interval)
+{
+	std::unique_lock<std::mutex> lock(watcherMutex_);
+	while (!watcherStop_) {
+		lock.unlock();
+		poll();
+		lock.lock();
+		watcherWake_.wait_for(lock, interval, [this] { return watcherStop_; });
+	}
+}
+
+/**
+ * Runs on the watcher thread. File access and parsing happen without the library lock,
+ * so Get() and Load() on the main thread never wait on the disk.
+ */
+void WGPU::Shader::ShaderLibrary::poll()
+{
+	struct Watched {
+		std::string name;
+		std::filesystem::path path;
+		std::filesystem::file_time_type lastWrite;
+	};
+
+	std::vector<Watched> watched;
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		for (const auto& [name, entry] : shaders_) {
+			watched.push_back(Watched{ name, entry.current->path, entry.lastWrite });
+		}
+	}
+
+	for (const Watched& file : watched) {
+		std::error_code error;
+		const auto lastWrite = std::filesystem::last_write_time(file.path, error);
+		if (error || lastWrite == file.lastWrite) {
+			continue;
+		}
+
+		std::string source;
+		if (!readFile(file.path, source)) {
+			continue; // Mid-save; the next poll sees it again
+		}
+		const size_t hash = std::hash<std::string_view>{}(source);
+
+		std::unique_lock<std::mutex> lock(mutex_);
+		Entry& entry = shaders_.at(file.name);
+		entry.lastWrite = lastWrite;
+		if (hash == entry.lastSeenHash) {
+			continue; // Touched, not changed
+		}
+		entry.lastSeenHash = hash;
+		const uint32_t version = entry.nextVersion++;
+		lock.unlock();
+
+		// Parse here rather than on the main thread; a broken edit never reaches the GPU
+		try {
+			ShaderReflection::Reflect(source);
+		}
+		catch (const std::exception& e) {
+			std::cerr << "ShaderLibrary: '" << file.name << "' failed to parse, keeping the previous version: " << e.what() << std::endl;
+			continue;
+		}
+
+		auto program = std::make_shared<ShaderProgram>();
+		program->name = file.name;
+		program->path = file.path;
+		program->source = std::move(source);
+		program->hash = hash;
+		program->version = version;
+
+		lock.lock();
+		std::erase_if(reloads_, [&](const ShaderRef& queued) { return queued->name == program->name; });
+		reloads_.push_back(std::move(program));
+	}
+}
+
+bool WGPU::Shader::ShaderLibrary::readFile(const std::filesystem::path& path, std::string& contents)
+{
+	std::ifstream file(path, std::ios::binary);
+	if (!file) {
+		return false;
+	}
+	std::ostringstream buffer;
+	buffer << file.rdbuf();
+	contents = buffer.str();
+	return !contents.empty();
+}
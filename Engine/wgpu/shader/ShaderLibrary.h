@@ -0,0 +1,151 @@
+#pragma once
+
+#include <webgpu/webgpu.h>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <filesystem>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include <core/Core.h>
+
+#include "ShaderReflection.h"
+
+namespace WGPU::Shader {
+	/**
+	 * @struct ShaderProgram
+	 * @brief One version of a named WGSL shader. Immutable; a reload makes a new one.
+	 */
+	struct ShaderProgram {
+		std::string name;
+		std::filesystem::path path;
+		std::string source;
+		size_t hash = 0;
+		uint32_t version = 0; // 0 for the first load, +1 per reload
+	};
+
+	/**
+	 * @struct ShaderModule
+	 * @brief A compiled WGPUShaderModule, shared by every pipeline built from the same source.
+	 */
+	struct ShaderModule {
+		WGPUShaderModule handle = nullptr;
+		std::string source;
+		~ShaderModule();
+	};
+
+	using ShaderRef = std::shared_ptr<const ShaderProgram>;
+	using ShaderModuleRef = std::shared_ptr<const ShaderModule>;
+
+	/**
+	 * @class ShaderLibrary
+	 * @brief Named WGSL shaders loaded from files, with a content-hashed module cache and
+	 * optional hot reload.
+	 *
+	 * Load() reads a shader from disk, falling back to a source embedded in the binary when
+	 * the file cannot be read, so builds shipped without the shader folder still run.
+	 * AcquireModule() compiles a source once and shares the module by content hash.
+	 *
+	 * With EnableHotReload() a background thread watches the loaded files. A changed file is
+	 * read and parsed with ShaderReflection on that thread, so a broken edit is reported
+	 * without touching the GPU, and the new version is queued. Nothing switches over by
+	 * itself: PipelineCache::Update() takes the queue at a frame boundary, recompiles the
+	 * dependent pipelines asynchronously and, once all of them are ready, swaps them and
+	 * Commit()s the version, so Get() only returns a version its pipelines already run.
+	 *
+	 * @code
+	 * WGPU::Shader::ShaderLibrary::EnableHotReload();
+	 * while (running) {
+	 *     WGPU::Pipeline::PipelineCache::Update(); // applies finished reloads
+	 *     ...
+	 * }
+	 * @endcode
+	 */
+	class ShaderLibrary {
+	public:
+		/*============================================================
+		* PUBLIC
+		=============================================================*/
+
+		/**
+		 * @brief Registers a shader under name and returns its current version. Later calls
+		 * with the same name return the registered shader and ignore the other arguments.
+		 *
+		 * @param path File to read, and to watch with hot reload.
+		 * @param fallback Source used when the file cannot be read.
+		 * @throws std::runtime_error If the file cannot be read and there is no fallback.
+		 */
+		static ShaderRef Load(const std::string& name, const std::filesystem::path& path, std::string_view fallback = {});
+
+		/**
+		 * @return The current version of a loaded shader, or nullptr.
+		 */
+		static ShaderRef Get(const std::string& name);
+
+		/**
+		 * @brief The module compiled from source, created on first use. Main thread only.
+		 */
+		static ShaderModuleRef AcquireModule(std::string_view source);
+
+		/**
+		 * @brief Starts the file watcher; it checks every loaded file once per interval.
+		 */
+		static void EnableHotReload(std::chrono::milliseconds interval = std::chrono::milliseconds(250));
+		static void DisableHotReload();
+		static bool IsHotReloadEnabled();
+
+		/**
+		 * @brief Hands over the changed shaders that parsed, oldest first, at most one per
+		 * name. They are not current until Commit().
+		 */
+		static std::vector<ShaderRef> TakeReloads();
+
+		/**
+		 * @brief Makes a reloaded version the one Get() and new Load() calls return.
+		 */
+		static void Commit(const ShaderRef& program);
+
+		ShaderLibrary(const ShaderLibrary&) = delete;
+		ShaderLibrary& operator=(const ShaderLibrary&) = delete;
+	private:
+		ShaderLibrary() = default;
+		~ShaderLibrary();
+
+		static ShaderLibrary& retrieveInstance() {
+			static ShaderLibrary instance;
+			return instance;
+		}
+
+		struct Entry {
+			ShaderRef current;
+			std::filesystem::file_time_type lastWrite{};
+			size_t lastSeenHash = 0; // Newest content the watcher looked at, parsed or not
+			uint32_t nextVersion = 1;
+		};
+
+		std::mutex mutex_;
+		std::unordered_map<std::string, Entry> shaders_;
+		std::vector<ShaderRef> reloads_;
+		std::unordered_map<size_t, std::weak_ptr<const ShaderModule>> modules_;
+
+		std::thread watcher_;
+		std::mutex watcherMutex_;
+		std::condition_variable watcherWake_;
+		bool watcherStop_ = false;
+		std::atomic<bool> watching_ = false;
+
+		void stopWatcher();
+		void watch(std::chrono::milliseconds interval);
+		void poll();
+
+		static bool readFile(const std::filesystem::path& path, std::string& contents);
+	};
+}
@@ -0,0 +1,980 @@
+#include "ShaderReflection.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <unordered_set>
+
+namespace {
+	/*============================================================
+	* TOKENS
+	=============================================================*/
+	enum class TokenType { Identifier, Number, Symbol, End };
+
+	struct Token {
+		TokenType type = TokenType::End;
+		std::string_view text;
+	};
+
+	/**
+	 * Splits WGSL source into identifiers, numbers and single-character symbols, dropping
+	 * whitespace and (nested) comments. "->" is the only multi-character symbol kept, since
+	 * nothing outside of function bodies needs operators.
+	 */
+	std::vector<Token> tokenize(std::string_view source)
+	{
+		std::vector<Token> tokens;
+		size_t i = 0;
+		while (i < source.size()) {
+			const char c = source[i];
+			if (std::isspace(static_cast<unsigned char>(c))) {
+				++i;
+			}
+			else if (source.compare(i, 2, "//") == 0) {
+				while (i < source.size() && source[i] != '\n') {
+					++i;
+				}
+			}
+			else if (source.compare(i, 2, "/*") == 0) {
+				int depth = 0;
+				do {
+					if (source.compare(i, 2, "/*") == 0) {
+						++depth;
+						i += 2;
+					}
+					else if (source.compare(i, 2, "*/") == 0) {
+						--depth;
+						i += 2;
+					}
+					else {
+						++i;
+					}
+				} while (depth > 0 && i < source.size());
+			}
+			else if (std::isalpha(static_cast<unsigned char>(c)) || c == '_') {
+				const size_t start = i;
+				while (i < source.size() && (std::isalnum(static_cast<unsigned char>(source[i])) || source[i] == '_')) {
+					++i;
+				}
+				tokens.push_back({ TokenType::Identifier, source.substr(start, i - start) });
+			}
+			else if (std::isdigit(static_cast<unsigned char>(c))) {
+				const size_t start = i;
+				while (i < source.size() && (std::isalnum(static_cast<unsigned char>(source[i])) || source[i] == '.')) {
+					++i;
+				}
+				tokens.push_back({ TokenType::Number, source.substr(start, i - start) });
+			}
+			else if (source.compare(i, 2, "->") == 0) {
+				tokens.push_back({ TokenType::Symbol, source.substr(i, 2) });
+				i += 2;
+			}
+			else {
+				tokens.push_back({ TokenType::Symbol, source.substr(i, 1) });
+				++i;
+			}
+		}
+		tokens.push_back({ TokenType::End, {} });
+		return tokens;
+	}
+
+	/*============================================================
+	* TYPES
+	=============================================================*/
+	// A parsed type such as array<vec4<f32>, 4>; template arguments may also be
+	// plain numbers or enumerants (texel formats, access modes)
+	struct TypeDesc {
+		std::string name;
+		std::vector<TypeDesc> args;
+
+		std::string ToString() const
+		{
+			std::string text = name;
+			if (!args.empty()) {
+				text += '<';
+				for (size_t i = 0; i < args.size(); ++i) {
+					text += (i > 0 ? ", " : "") + args[i].ToString();
+				}
+				text += '>';
+			}
+			return text;
+		}
+	};
+
+	// Predeclared aliases such as vec2f or mat4x4h, expanded to their templated form
+	bool expandShorthand(TypeDesc& type)
+	{
+		const std::string& name = type.name;
+		if (!type.args.empty() || name.size() < 5) {
+			return false;
+		}
+		const char suffix = name.back();
+		const char* scalar = suffix == 'f' ? "f32" : suffix == 'i' ? "i32" : suffix == 'u' ? "u32" : suffix == 'h' ? "f16" : nullptr;
+		if (!scalar) {
+			return false;
+		}
+		const std::string base = name.substr(0, name.size() - 1);
+		const bool isVector = base == "vec2" || base == "vec3" || base == "vec4";
+		const bool isMatrix = base.size() == 6 && base.compare(0, 3, "mat") == 0 && base[4] == 'x'
+			&& base[3] >= '2' && base[3] <= '4' && base[5] >= '2' && base[5] <= '4';
+		if (!isVector && !(isMatrix && (suffix == 'f' || suffix == 'h'))) {
+			return false;
+		}
+		type.name = base;
+		type.args = { TypeDesc{ scalar, {} } };
+		return true;
+	}
+
+	std::optional<WGPU::Buffer::UniformKind> uniformKindOf(const TypeDesc& type)
+	{
+		using WGPU::Buffer::UniformKind;
+		const std::string text = type.ToString();
+		if (text == "f32") return UniformKind::F32;
+		if (text == "i32") return UniformKind::I32;
+		if (text == "u32") return UniformKind::U32;
+		if (text == "vec2<f32>") return UniformKind::Vec2;
+		if (text == "vec3<f32>") return UniformKind::Vec3;
+		if (text == "vec4<f32>") return UniformKind::Vec4;
+		if (text == "mat4x4<f32>") return UniformKind::Mat4;
+		return std::nullopt;
+	}
+
+	WGPUTextureViewDimension viewDimensionOf(std::string_view suffix)
+	{
+		if (suffix == "1d") return WGPUTextureViewDimension_1D;
+		if (suffix == "2d") return WGPUTextureViewDimension_2D;
+		if (suffix == "2d_array") return WGPUTextureViewDimension_2DArray;
+		if (suffix == "3d") return WGPUTextureViewDimension_3D;
+		if (suffix == "cube") return WGPUTextureViewDimension_Cube;
+		if (suffix == "cube_array") return WGPUTextureViewDimension_CubeArray;
+		throw std::runtime_error("Unsupported WGSL texture dimension: " + std::string(suffix));
+	}
+
+	WGPUTextureSampleType sampleTypeOf(const std::string& scalar)
+	{
+		if (scalar == "f32") return WGPUTextureSampleType_Float;
+		if (scalar == "i32") return WGPUTextureSampleType_Sint;
+		if (scalar == "u32") return WGPUTextureSampleType_Uint;
+		throw std::runtime_error("Unsupported WGSL texture sample type: " + scalar);
+	}
+
+	WGPUTextureFormat storageFormatOf(const std::string& format)
+	{
+		static const std::unordered_map<std::string, WGPUTextureFormat> formats = {
+			{ "rgba8unorm", WGPUTextureFormat_RGBA8Unorm },
+			{ "rgba8snorm", WGPUTextureFormat_RGBA8Snorm },
+			{ "rgba8uint", WGPUTextureFormat_RGBA8Uint },
+			{ "rgba8sint", WGPUTextureFormat_RGBA8Sint },
+			{ "bgra8unorm", WGPUTextureFormat_BGRA8Unorm },
+			{ "rgba16uint", WGPUTextureFormat_RGBA16Uint },
+			{ "rgba16sint", WGPUTextureFormat_RGBA16Sint },
+			{ "rgba16float", WGPUTextureFormat_RGBA16Float },
+			{ "r32uint", WGPUTextureFormat_R32Uint },
+			{ "r32sint", WGPUTextureFormat_R32Sint },
+			{ "r32float", WGPUTextureFormat_R32Float },
+			{ "rg32uint", WGPUTextureFormat_RG32Uint },
+			{ "rg32sint", WGPUTextureFormat_RG32Sint },
+			{ "rg32float", WGPUTextureFormat_RG32Float },
+			{ "rgba32uint", WGPUTextureFormat_RGBA32Uint },
+			{ "rgba32sint", WGPUTextureFormat_RGBA32Sint },
+			{ "rgba32float", WGPUTextureFormat_RGBA32Float },
+		};
+		auto it = formats.find(format);
+		if (it == formats.end()) {
+			throw std::runtime_error("Unsupported WGSL storage texture format: " + format);
+		}
+		return it->second;
+	}
+
+	WGPUStorageTextureAccess storageAccessOf(const std::string& access)
+	{
+		if (access == "write") return WGPUStorageTextureAccess_WriteOnly;
+		if (access == "read") return WGPUStorageTextureAccess_ReadOnly;
+		if (access == "read_write") return WGPUStorageTextureAccess_ReadWrite;
+		throw std::runtime_error("Unsupported WGSL storage texture access: " + access);
+	}
+
+	/*============================================================
+	* PARSER
+	=============================================================*/
+	struct Attribute {
+		std::string_view name;
+		std::vector<Token> args;
+
+		uint32_t Value() const
+		{
+			if (args.empty() || args.front().type != TokenType::Number) {
+				throw std::runtime_error("WGSL attribute @" + std::string(name) + " needs a literal argument.");
+			}
+			return static_cast<uint32_t>(std::strtoul(std::string(args.front().text).c_str(), nullptr, 0));
+		}
+	};
+
+	struct StructDecl {
+		struct Member {
+			std::string name;
+			TypeDesc type;
+			std::optional<size_t> align;
+			std::optional<size_t> size;
+		};
+		std::string name;
+		std::vector<Member> members;
+	};
+
+	struct VarDecl {
+		uint32_t group = 0;
+		uint32_t binding = 0;
+		std::string name;
+		std::string addressSpace;
+		std::string access;
+		TypeDesc type;
+	};
+
+	struct FunctionDecl {
+		std::string name;
+		WGPUShaderStageFlags stage = WGPUShaderStage_None;
+		std::unordered_set<std::string_view> identifiers;
+
+		// Plain-identifier arguments of every texture builtin call, e.g. { "atlas", "atlasSampler" }
+		std::vector<std::vector<std::string_view>> textureCalls;
+	};
+
+	/**
+	 * Recursive-descent parser over the module-scope grammar. Anything it does not need,
+	 * such as const/override declarations and directives, is skipped up to its ';'.
+	 */
+	class Parser {
+	public:
+		explicit Parser(std::string_view source) : tokens_(tokenize(source)) {}
+
+		void Run(std::vector<WGPU::Shader::ReflectedStruct>& structs, std::vector<WGPU::Shader::ReflectedBinding>& bindings)
+		{
+			while (peek().type != TokenType::End) {
+				parseDeclaration();
+			}
+
+			for (const auto& decl : structDecls_) {
+				try {
+					structs.push_back(layoutStruct(decl.name));
+				}
+				catch (const std::runtime_error&) {
+					// Not host-shareable (e.g. holds a runtime array of unknown type); only bindings need a layout
+				}
+			}
+			for (const auto& var : vars_) {
+				bindings.push_back(reflectBinding(var));
+			}
+			resolveSamplerTypes(bindings);
+			std::sort(bindings.begin(), bindings.end(), [](const auto& a, const auto& b) {
+				return a.group != b.group ? a.group < b.group : a.binding < b.binding;
+			});
+		}
+	private:
+		std::vector<Token> tokens_;
+		size_t position_ = 0;
+
+		std::vector<StructDecl> structDecls_;
+		std::vector<VarDecl> vars_;
+		std::vector<FunctionDecl> functions_;
+		std::unordered_map<std::string, TypeDesc> aliases_;
+		std::unordered_map<std::string, size_t> constants_;
+		std::unordered_map<std::string, WGPU::Shader::ReflectedStruct> layouts_;
+
+		const Token& peek() const { return tokens_[position_]; }
+		const Token& next() { return tokens_[position_ < tokens_.size() - 1 ? position_++ : position_]; }
+
+		bool accept(std::string_view symbol)
+		{
+			if (peek().type != TokenType::End && peek().text == symbol) {
+				++position_;
+				return true;
+			}
+			return false;
+		}
+
+		void expect(std::string_view symbol)
+		{
+			if (!accept(symbol)) {
+				throw std::runtime_error("WGSL reflection: expected '" + std::string(symbol) + "' but found '" + std::string(peek().text) + "'.");
+			}
+		}
+
+		std::string identifier()
+		{
+			if (peek().type != TokenType::Identifier) {
+				throw std::runtime_error("WGSL reflection: expected an identifier but found '" + std::string(peek().text) + "'.");
+			}
+			return std::string(next().text);
+		}
+
+		// Skips a balanced (...), [...] or {...} group starting at the current token
+		void skipGroup()
+		{
+			int depth = 0;
+			do {
+				const Token& token = next();
+				if (token.type == TokenType::End) {
+					throw std::runtime_error("WGSL reflection: unbalanced brackets.");
+				}
+				if (token.text == "(" || token.text == "[" || token.text == "{") ++depth;
+				if (token.text == ")" || token.text == "]" || token.text == "}") --depth;
+			} while (depth > 0);
+		}
+
+		void skipStatement()
+		{
+			while (peek().type != TokenType::End && !accept(";")) {
+				if (peek().text == "(" || peek().text == "[" || peek().text == "{") {
+					skipGroup();
+				}
+				else {
+					next();
+				}
+			}
+		}
+
+		std::vector<Attribute> parseAttributes()
+		{
+			std::vector<Attribute> attributes;
+			while (accept("@")) {
+				Attribute attribute;
+				attribute.name = next().text;
+				if (peek().text == "(") {
+					const size_t start = position_ + 1;
+					skipGroup();
+					attribute.args.assign(tokens_.begin() + start, tokens_.begin() + position_ - 1);
+				}
+				attributes.push_back(std::move(attribute));
+			}
+			return attributes;
+		}
+
+		TypeDesc parseType()
+		{
+			TypeDesc type;
+			type.name = peek().type == TokenType::Number ? std::string(next().text) : identifier();
+			if (accept("<")) {
+				do {
+					type.args.push_back(parseType());
+				} while (accept(","));
+				expect(">");
+			}
+			return resolve(type);
+		}
+
+		TypeDesc resolve(TypeDesc type) const
+		{
+			auto it = aliases_.find(type.name);
+			if (it != aliases_.end() && type.args.empty()) {
+				return it->second;
+			}
+			expandShorthand(type);
+			return type;
+		}
+
+		void parseDeclaration()
+		{
+			const std::vector<Attribute> attributes = parseAttributes();
+			if (accept(";")) {
+				return;
+			}
+			const std::string_view keyword = peek().text;
+			if (keyword == "struct") {
+				next();
+				parseStruct();
+			}
+			else if (keyword == "var") {
+				next();
+				parseVar(attributes);
+			}
+			else if (keyword == "fn") {
+				next();
+				parseFunction(attributes);
+			}
+			else if (keyword == "alias") {
+				next();
+				const std::string name = identifier();
+				expect("=");
+				aliases_[name] = parseType();
+				expect(";");
+			}
+			else if (keyword == "const") {
+				next();
+				parseConst();
+			}
+			else {
+				skipStatement(); // override, enable, requires, diagnostic, const_assert
+			}
+		}
+
+		// Only `const NAME [: type] = <integer literal or const>;` is kept, for array sizes
+		void parseConst()
+		{
+			const std::string name = identifier();
+			if (accept(":")) {
+				parseType();
+			}
+			expect("=");
+
+			std::optional<size_t> value;
+			if (peek().type == TokenType::Number) {
+				value = std::strtoul(std::string(next().text).c_str(), nullptr, 0);
+			}
+			else if (peek().type == TokenType::Identifier) {
+				auto it = constants_.find(std::string(next().text));
+				if (it != constants_.end()) {
+					value = it->second;
+				}
+			}
+			if (value && accept(";")) {
+				constants_[name] = *value;
+				return;
+			}
+			skipStatement(); // An expression; arrays sized by it fail to reflect
+		}
+
+		void parseStruct()
+		{
+			StructDecl decl;
+			decl.name = identifier();
+			expect("{");
+			while (!accept("}")) {
+				StructDecl::Member member;
+				for (const Attribute& attribute : parseAttributes()) {
+					if (attribute.name == "align") member.align = attribute.Value();
+					if (attribute.name == "size") member.size = attribute.Value();
+				}
+				member.name = identifier();
+				expect(":");
+				member.type = parseType();
+				decl.members.push_back(std::move(member));
+				if (!accept(",")) {
+					accept(";"); // Old-style member separator
+				}
+			}
+			accept(";");
+			structDecls_.push_back(std::move(decl));
+		}
+
+		void parseVar(const std::vector<Attribute>& attributes)
+		{
+			VarDecl var;
+			if (accept("<")) {
+				var.addressSpace = identifier();
+				if (accept(",")) {
+					var.access = identifier();
+				}
+				expect(">");
+			}
+			var.name = identifier();
+			expect(":");
+			var.type = parseType();
+			skipStatement(); // Optional initialiser
+
+			bool hasGroup = false;
+			bool hasBinding = false;
+			for (const Attribute& attribute : attributes) {
+				if (attribute.name == "group") { var.group = attribute.Value(); hasGroup = true; }
+				if (attribute.name == "binding") { var.binding = attribute.Value(); hasBinding = true; }
+			}
+			if (hasGroup && hasBinding) {
+				vars_.push_back(std::move(var));
+			}
+		}
+
+		void parseFunction(const std::vector<Attribute>& attributes)
+		{
+			FunctionDecl function;
+			function.name = identifier();
+			for (const Attribute& attribute : attributes) {
+				if (attribute.name == "vertex") function.stage = WGPUShaderStage_Vertex;
+				if (attribute.name == "fragment") function.stage = WGPUShaderStage_Fragment;
+				if (attribute.name == "compute") function.stage = WGPUShaderStage_Compute;
+			}
+
+			// Parameters and return type cannot reference module-scope variables
+			while (peek().text != "{") {
+				if (peek().type == TokenType::End) {
+					throw std::runtime_error("WGSL reflection: function '" + function.name + "' has no body.");
+				}
+				if (peek().text == "(" || peek().text == "[") {
+					skipGroup();
+				}
+				else {
+					next();
+				}
+			}
+
+			const size_t start = position_;
+			skipGroup();
+			for (size_t i = start; i < position_; ++i) {
+				if (tokens_[i].type == TokenType::Identifier) {
+					function.identifiers.insert(tokens_[i].text);
+					if (tokens_[i].text.starts_with("texture") && tokens_[i + 1].text == "(") {
+						function.textureCalls.push_back(callArguments(i + 1));
+					}
+				}
+			}
+			functions_.push_back(std::move(function));
+		}
+
+		// Arguments of the call whose '(' is at open that are a lone identifier
+		std::vector<std::string_view> callArguments(size_t open) const
+		{
+			std::vector<std::string_view> arguments;
+			int depth = 0;
+			for (size_t i = open; i < tokens_.size() && tokens_[i].type != TokenType::End; ++i) {
+				const std::string_view text = tokens_[i].text;
+				if (text == "(" || text == "[") {
+					++depth;
+				}
+				else if (text == ")" || text == "]") {
+					if (--depth == 0) {
+						break;
+					}
+				}
+				else if (depth == 1 && tokens_[i].type == TokenType::Identifier
+					&& (tokens_[i - 1].text == "(" || tokens_[i - 1].text == ",")
+					&& (tokens_[i + 1].text == ")" || tokens_[i + 1].text == ",")) {
+					arguments.push_back(text);
+				}
+			}
+			return arguments;
+		}
+
+		/*============================================================
+		* LAYOUT
+		=============================================================*/
+
+		/**
+		 * AlignOf / SizeOf of a host-shareable type per the WGSL memory layout rules.
+		 * Runtime-sized arrays are sized as one element, which is what minBindingSize needs.
+		 */
+		void layoutOf(const TypeDesc& type, size_t& size, size_t& alignment)
+		{
+			const std::string& name = type.name;
+			if (name == "f32" || name == "i32" || name == "u32" || name == "atomic" || name == "bool") {
+				size = 4;
+				alignment = 4;
+			}
+			else if (name == "f16") {
+				size = 2;
+				alignment = 2;
+			}
+			else if ((name == "vec2" || name == "vec3" || name == "vec4") && type.args.size() == 1) {
+				size_t scalarSize = 0, scalarAlignment = 0;
+				layoutOf(type.args[0], scalarSize, scalarAlignment);
+				const size_t count = static_cast<size_t>(name[3] - '0');
+				size = count * scalarSize;
+				alignment = (count == 2 ? 2 : 4) * scalarSize;
+			}
+			else if (name.size() == 6 && name.compare(0, 3, "mat") == 0 && type.args.size() == 1) {
+				size_t scalarSize = 0, scalarAlignment = 0;
+				layoutOf(type.args[0], scalarSize, scalarAlignment);
+				const size_t columns = static_cast<size_t>(name[3] - '0');
+				const size_t rows = static_cast<size_t>(name[5] - '0');
+				alignment = (rows == 2 ? 2 : 4) * scalarSize;
+				size = columns * WGPU::Buffer::AlignUp(rows * scalarSize, alignment);
+			}
+			else if (name == "array" && !type.args.empty()) {
+				size_t elementSize = 0;
+				layoutOf(type.args[0], elementSize, alignment);
+				const size_t count = type.args.size() > 1 ? arrayCount(type.args[1]) : 1;
+				size = count * WGPU::Buffer::AlignUp(elementSize, alignment);
+			}
+			else {
+				const WGPU::Shader::ReflectedStruct& reflected = layoutStruct(name);
+				size = reflected.size;
+				alignment = reflected.alignment;
+			}
+		}
+
+		size_t arrayCount(const TypeDesc& count) const
+		{
+			if (!count.name.empty() && std::isdigit(static_cast<unsigned char>(count.name[0]))) {
+				return std::strtoul(count.name.c_str(), nullptr, 0);
+			}
+			auto it = constants_.find(count.name);
+			if (it == constants_.end()) {
+				throw std::runtime_error("WGSL reflection: array size '" + count.ToString() + "' is neither a literal nor a const integer.");
+			}
+			return it->second;
+		}
+
+		const WGPU::Shader::ReflectedStruct& layoutStruct(const std::string& name)
+		{
+			auto cached = layouts_.find(name);
+			if (cached != layouts_.end()) {
+				return cached->second;
+			}
+
+			auto decl = std::find_if(structDecls_.begin(), structDecls_.end(), [&](const StructDecl& d) { return d.name == name; });
+			if (decl == structDecls_.end()) {
+				throw std::runtime_error("WGSL reflection: type '" + name + "' has no host-shareable layout.");
+			}
+
+			WGPU::Shader::ReflectedStruct reflected;
+			reflected.name = name;
+			reflected.alignment = 1;
+			size_t cursor = 0;
+			for (const auto& declMember : decl->members) {
+				WGPU::Shader::ReflectedMember member;
+				member.name = declMember.name;
+				member.type = declMember.type.ToString();
+				member.kind = uniformKindOf(declMember.type);
+				layoutOf(declMember.type, member.size, member.alignment);
+				member.alignment = declMember.align.value_or(member.alignment);
+				member.size = declMember.size.value_or(member.size);
+				member.offset = WGPU::Buffer::AlignUp(cursor, member.alignment);
+
+				cursor = member.offset + member.size;
+				reflected.alignment = std::max(reflected.alignment, member.alignment);
+				reflected.members.push_back(std::move(member));
+			}
+			reflected.size = WGPU::Buffer::AlignUp(cursor, reflected.alignment);
+
+			return layouts_.emplace(name, std::move(reflected)).first->second;
+		}
+
+		/*============================================================
+		* BINDINGS
+		=============================================================*/
+
+		// Every identifier reachable from an entry point, following calls to other functions
+		void collectIdentifiers(const FunctionDecl& function, std::unordered_set<std::string_view>& identifiers, std::unordered_set<std::string_view>& visited) const
+		{
+			if (!visited.insert(function.name).second) {
+				return;
+			}
+			for (std::string_view identifier : function.identifiers) {
+				identifiers.insert(identifier);
+				for (const FunctionDecl& callee : functions_) {
+					if (callee.name == identifier) {
+						collectIdentifiers(callee, identifiers, visited);
+					}
+				}
+			}
+		}
+
+		WGPUShaderStageFlags visibilityOf(const std::string& name) const
+		{
+			WGPUShaderStageFlags visibility = WGPUShaderStage_None;
+			for (const FunctionDecl& function : functions_) {
+				if (function.stage == WGPUShaderStage_None) {
+					continue;
+				}
+				std::unordered_set<std::string_view> identifiers, visited;
+				collectIdentifiers(function, identifiers, visited);
+				if (identifiers.count(name) > 0) {
+					visibility |= function.stage;
+				}
+			}
+			return visibility;
+		}
+
+		/**
+		 * A plain `sampler` may only filter float textures. One used in the same builtin call
+		 * as a depth or unfilterable-float texture has to be laid out as non-filtering.
+		 */
+		void resolveSamplerTypes(std::vector<WGPU::Shader::ReflectedBinding>& bindings) const
+		{
+			using WGPU::Shader::BindingKind;
+
+			auto find = [&](std::string_view name) -> WGPU::Shader::ReflectedBinding* {
+				for (auto& binding : bindings) {
+					if (binding.name == name) {
+						return &binding;
+					}
+				}
+				return nullptr;
+			};
+
+			for (const FunctionDecl& function : functions_) {
+				for (const auto& arguments : function.textureCalls) {
+					const WGPU::Shader::ReflectedBinding* texture = nullptr;
+					WGPU::Shader::ReflectedBinding* sampler = nullptr;
+					for (std::string_view argument : arguments) {
+						WGPU::Shader::ReflectedBinding* binding = find(argument);
+						if (binding && binding->kind == BindingKind::Texture) texture = binding;
+						if (binding && binding->kind == BindingKind::Sampler) sampler = binding;
+					}
+					if (texture && sampler && (texture->sampleType == WGPUTextureSampleType_Depth || texture->sampleType == WGPUTextureSampleType_UnfilterableFloat)) {
+						sampler->kind = BindingKind::NonFilteringSampler;
+					}
+				}
+			}
+		}
+
+		WGPU::Shader::ReflectedBinding reflectBinding(const VarDecl& var)
+		{
+			using WGPU::Shader::BindingKind;
+
+			WGPU::Shader::ReflectedBinding binding;
+			binding.group = var.group;
+			binding.binding = var.binding;
+			binding.name = var.name;
+			binding.type = var.type.ToString();
+			binding.visibility = visibilityOf(var.name);
+
+			const std::string& typeName = var.type.name;
+			if (var.addressSpace == "uniform" || var.addressSpace == "storage") {
+				size_t size = 0, alignment = 0;
+				layoutOf(var.type, size, alignment);
+				binding.minBindingSize = size;
+				binding.kind = var.addressSpace == "uniform" ? BindingKind::UniformBuffer
+					: var.access == "read_write" ? BindingKind::StorageBuffer
+					: BindingKind::ReadOnlyStorageBuffer;
+			}
+			else if (typeName == "sampler") {
+				binding.kind = BindingKind::Sampler;
+			}
+			else if (typeName == "sampler_comparison") {
+				binding.kind = BindingKind::ComparisonSampler;
+			}
+			else if (typeName.compare(0, 16, "texture_storage_") == 0 && var.type.args.size() == 2) {
+				binding.kind = BindingKind::StorageTexture;
+				binding.viewDimension = viewDimensionOf(std::string_view(typeName).substr(16));
+				binding.storageFormat = storageFormatOf(var.type.args[0].name);
+				binding.storageAccess = storageAccessOf(var.type.args[1].name);
+			}
+			else if (typeName.compare(0, 14, "texture_depth_") == 0) {
+				binding.kind = BindingKind::Texture;
+				binding.sampleType = WGPUTextureSampleType_Depth;
+				binding.multisampled = typeName == "texture_depth_multisampled_2d";
+				binding.viewDimension = binding.multisampled ? WGPUTextureViewDimension_2D : viewDimensionOf(std::string_view(typeName).substr(14));
+			}
+			else if (typeName == "texture_multisampled_2d" && var.type.args.size() == 1) {
+				// Multisampled float textures cannot be filtered
+				binding.kind = BindingKind::Texture;
+				binding.multisampled = true;
+				binding.viewDimension = WGPUTextureViewDimension_2D;
+				binding.sampleType = sampleTypeOf(var.type.args[0].name);
+				if (binding.sampleType == WGPUTextureSampleType_Float) {
+					binding.sampleType = WGPUTextureSampleType_UnfilterableFloat;
+				}
+			}
+			else if (typeName.compare(0, 8, "texture_") == 0 && var.type.args.size() == 1) {
+				binding.kind = BindingKind::Texture;
+				binding.viewDimension = viewDimensionOf(std::string_view(typeName).substr(8));
+				binding.sampleType = sampleTypeOf(var.type.args[0].name);
+			}
+			else {
+				throw std::runtime_error("WGSL reflection: unsupported binding type '" + binding.type + "' for '" + var.name + "'.");
+			}
+			return binding;
+		}
+	};
+}
+
+WGPU::Shader::ShaderReflection::ShaderReflection(std::string_view source) :
+	hash_(std::hash<std::string_view>{}(source)),
+	source_(source)
+{
+	Parser(source_).Run(structs_, bindings_);
+}
+
+std::shared_ptr<const WGPU::Shader::ShaderReflection> WGPU::Shader::ShaderReflection::Reflect(std::string_view source)
+{
+	struct Entry {
+		std::shared_ptr<const ShaderReflection> reflection;
+		uint64_t lastUse = 0;
+	};
+	static std::mutex mutex;
+	static std::unordered_map<size_t, Entry> cache;
+	static uint64_t clock = 0;
+
+	const size_t hash = std::hash<std::string_view>{}(source);
+	std::unique_lock<std::mutex> lock(mutex);
+
+	auto it = cache.find(hash);
+	if (it != cache.end() && it->second.reflection->source_ == source) {
+		it->second.lastUse = ++clock;
+		return it->second.reflection;
+	}
+
+	// Parse unlocked, so the watcher thread's parse never stalls a Reflect on the main thread
+	lock.unlock();
+	auto reflection = std::make_shared<const ShaderReflection>(source);
+	lock.lock();
+
+	// Another thread may have parsed the same source meanwhile; its entry stays
+	it = cache.find(hash);
+	if (it != cache.end() && it->second.reflection->source_ == source) {
+		it->second.lastUse = ++clock;
+		return it->second.reflection;
+	}
+
+	// A new module, or a hash collision with one; either way the newest source wins the slot
+	cache[hash] = { reflection, ++clock };
+
+	// Every hot-reloaded edit is a new source; the versions it replaced age out here
+	if (cache.size() > CacheCapacity) {
+		auto oldest = std::min_element(cache.begin(), cache.end(), [](const auto& a, const auto& b) {
+			return a.second.lastUse < b.second.lastUse;
+		});
+		cache.erase(oldest);
+	}
+	return reflection;
+}
+
+const WGPU::Shader::ReflectedMember* WGPU::Shader::ReflectedStruct::Find(std::string_view memberName) const
+{
+	for (const auto& member : members) {
+		if (member.name == memberName) {
+			return &member;
+		}
+	}
+	return nullptr;
+}
+
+const WGPU::Shader::ReflectedStruct* WGPU::Shader::ShaderReflection::FindStruct(std::string_view name) const
+{
+	for (const auto& reflected : structs_) {
+		if (reflected.name == name) {
+			return &reflected;
+		}
+	}
+	return nullptr;
+}
+
+const WGPU::Shader::ReflectedBinding* WGPU::Shader::ShaderReflection::FindBinding(uint32_t group, uint32_t binding) const
+{
+	for (const auto& reflected : bindings_) {
+		if (reflected.group == group && reflected.binding == binding) {
+			return &reflected;
+		}
+	}
+	return nullptr;
+}
+
+const WGPU::Shader::ReflectedStruct& WGPU::Shader::ShaderReflection::GetUniformStruct(uint32_t group, uint32_t binding) const
+{
+	const ReflectedBinding* reflected = FindBinding(group, binding);
+	if (!reflected || reflected->kind != BindingKind::UniformBuffer) {
+		throw std::invalid_argument("Shader has no uniform buffer at this group and binding.");
+	}
+	const ReflectedStruct* layout = FindStruct(reflected->type);
+	if (!layout) {
+		throw std::invalid_argument("Uniform '" + reflected->name + "' is not a struct.");
+	}
+	return *layout;
+}
+
+uint32_t WGPU::Shader::ShaderReflection::GetGroupCount() const
+{
+	return bindings_.empty() ? 0 : bindings_.back().group + 1; // Bindings are sorted by group
+}
+
+std::vector<WGPUBindGroupLayoutEntry> WGPU::Shader::ShaderReflection::CreateLayoutEntries(uint32_t group, std::initializer_list<uint32_t> dynamicOffsetBindings) const
+{
+	std::vector<WGPUBindGroupLayoutEntry> entries;
+	for (const auto& reflected : bindings_) {
+		if (reflected.group != group) {
+			continue;
+		}
+
+		WGPUBindGroupLayoutEntry entry = {};
+		entry.nextInChain = nullptr;
+		entry.binding = reflected.binding;
+		entry.visibility = reflected.visibility;
+
+		switch (reflected.kind) {
+		case BindingKind::UniformBuffer:
+		case BindingKind::StorageBuffer:
+		case BindingKind::ReadOnlyStorageBuffer:
+			entry.buffer.nextInChain = nullptr;
+			entry.buffer.type = reflected.kind == BindingKind::UniformBuffer ? WGPUBufferBindingType_Uniform
+				: reflected.kind == BindingKind::StorageBuffer ? WGPUBufferBindingType_Storage
+				: WGPUBufferBindingType_ReadOnlyStorage;
+			entry.buffer.minBindingSize = reflected.minBindingSize;
+			entry.buffer.hasDynamicOffset = std::find(dynamicOffsetBindings.begin(), dynamicOffsetBindings.end(), reflected.binding) != dynamicOffsetBindings.end();
+			break;
+		case BindingKind::Texture:
+			entry.texture.nextInChain = nullptr;
+			entry.texture.sampleType = reflected.sampleType;
+			entry.texture.viewDimension = reflected.viewDimension;
+			entry.texture.multisampled = reflected.multisampled;
+			break;
+		case BindingKind::StorageTexture:
+			entry.storageTexture.nextInChain = nullptr;
+			entry.storageTexture.access = reflected.storageAccess;
+			entry.storageTexture.format = reflected.storageFormat;
+			entry.storageTexture.viewDimension = reflected.viewDimension;
+			break;
+		case BindingKind::Sampler:
+		case BindingKind::NonFilteringSampler:
+		case BindingKind::ComparisonSampler:
+			entry.sampler.nextInChain = nullptr;
+			entry.sampler.type = reflected.kind == BindingKind::Sampler ? WGPUSamplerBindingType_Filtering
+				: reflected.kind == BindingKind::NonFilteringSampler ? WGPUSamplerBindingType_NonFiltering
+				: WGPUSamplerBindingType_Comparison;
+			break;
+		}
+		entries.push_back(entry);
+	}
+	return entries;
+}
+
+WGPUBindGroupLayout WGPU::Shader::ShaderReflection::CreateBindGroupLayout(uint32_t group, std::initializer_list<uint32_t> dynamicOffsetBindings) const
+{
+	const std::vector<WGPUBindGroupLayoutEntry> entries = CreateLayoutEntries(group, dynamicOffsetBindings);
+
+	WGPUBindGroupLayoutDescriptor bindGroupLayoutDesc = {};
+	bindGroupLayoutDesc.nextInChain = nullptr;
+	bindGroupLayoutDesc.entryCount = entries.size();
+	bindGroupLayoutDesc.entries = entries.data();
+	WGPUBindGroupLayout bindGroupLayout = wgpuDeviceCreateBindGroupLayout(Core::Device(), &bindGroupLayoutDesc);
+	if (!bindGroupLayout) {
+		throw std::runtime_error("Failed to create reflected bind group layout.");
+	}
+	return bindGroupLayout;
+}
+
+void WGPU::Shader::ShaderReflection::ValidateBindingSize(uint32_t group, uint32_t binding, size_t size) const
+{
+	const ReflectedBinding* reflected = FindBinding(group, binding);
+	if (!reflected) {
+		throw std::invalid_argument("Shader has no binding at this group and binding.");
+	}
+	if (reflected->kind != BindingKind::UniformBuffer && reflected->kind != BindingKind::StorageBuffer && reflected->kind != BindingKind::ReadOnlyStorageBuffer) {
+		throw std::invalid_argument("Binding '" + reflected->name + "' is not a buffer.");
+	}
+	if (size < reflected->minBindingSize) {
+		throw std::invalid_argument(
+			"Buffer bound to '" + reflected->name + "' is " + std::to_string(size) +
+			" bytes but the shader needs at least " + std::to_string(reflected->minBindingSize) + "."
+		);
+	}
+}
+
+void WGPU::Shader::ShaderReflection::ValidateUniformLayouts(const ShaderReflection& previous) const
+{
+	for (const auto& reflected : previous.bindings_) {
+		if (reflected.kind != BindingKind::UniformBuffer) {
+			continue;
+		}
+		const ReflectedStruct* before = previous.FindStruct(reflected.type);
+		const ReflectedBinding* binding = FindBinding(reflected.group, reflected.binding);
+		const ReflectedStruct* after = binding && binding->kind == BindingKind::UniformBuffer ? FindStruct(binding->type) : nullptr;
+		if (!before || !after) {
+			if (before != after) {
+				throw std::invalid_argument("Uniform '" + reflected.name + "' changed between a struct and a plain type.");
+			}
+			continue;
+		}
+		if (before->size != after->size || before->members.size() != after->members.size()) {
+			throw std::invalid_argument("Uniform struct '" + after->name + "' changed its layout.");
+		}
+		for (size_t i = 0; i < before->members.size(); ++i) {
+			const ReflectedMember& old = before->members[i];
+			const ReflectedMember& member = after->members[i];
+			if (old.name != member.name || old.type != member.type || old.offset != member.offset) {
+				throw std::invalid_argument("Uniform member '" + after->name + "." + member.name + "' changed its layout.");
+			}
+		}
+	}
+}
@@ -0,0 +1,222 @@
+#pragma once
+
+#include <webgpu/webgpu.h>
+#include <core/Core.h>
+#include <cstdint>
+#include <initializer_list>
+#include <memory>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <wgpu/buffer/UniformLayout.h>
+
+namespace WGPU::Shader {
+
+	/*============================================================
+	* REFLECTED TYPES
+	=============================================================*/
+	/**
+	 * @struct ReflectedMember
+	 * @brief One member of a WGSL struct with its layout resolved per the WGSL rules.
+	 */
+	struct ReflectedMember {
+		std::string name;
+
+		/**
+		 * @brief The member type in canonical form, e.g. "vec2<f32>" for a vec2f member.
+		 */
+		std::string type;
+
+		size_t offset = 0;
+		size_t size = 0;
+		size_t alignment = 0;
+
+		/**
+		 * @brief The matching host uniform type, if the member has one (see UniformTraits).
+		 */
+		std::optional<Buffer::UniformKind> kind;
+	};
+
+	/**
+	 * @struct ReflectedStruct
+	 * @brief A WGSL struct declaration with member offsets, size and alignment.
+	 */
+	struct ReflectedStruct {
+		std::string name;
+		std::vector<ReflectedMember> members;
+		size_t size = 0;
+		size_t alignment = 0;
+
+		const ReflectedMember* Find(std::string_view memberName) const;
+	};
+
+	/**
+	 * @brief The kind of resource a module-scope @group/@binding variable expects.
+	 */
+	enum class BindingKind : uint8_t {
+		UniformBuffer,
+		StorageBuffer,
+		ReadOnlyStorageBuffer,
+		Texture,
+		StorageTexture,
+		Sampler,
+		NonFilteringSampler,
+		ComparisonSampler
+	};
+
+	/**
+	 * @struct ReflectedBinding
+	 * @brief A module-scope resource variable and everything needed for its layout entry.
+	 */
+	struct ReflectedBinding {
+		uint32_t group = 0;
+		uint32_t binding = 0;
+		std::string name;
+		std::string type;
+		BindingKind kind = BindingKind::UniformBuffer;
+
+		/**
+		 * @brief Stages whose entry points reference the variable, directly or through calls.
+		 */
+		WGPUShaderStageFlags visibility = WGPUShaderStage_None;
+
+		// Buffers: size of the store type; a runtime-sized array counts as one element
+		uint64_t minBindingSize = 0;
+
+		// Textures
+		WGPUTextureSampleType sampleType = WGPUTextureSampleType_Undefined;
+		WGPUTextureViewDimension viewDimension = WGPUTextureViewDimension_Undefined;
+		bool multisampled = false;
+
+		// Storage textures
+		WGPUTextureFormat storageFormat = WGPUTextureFormat_Undefined;
+		WGPUStorageTextureAccess storageAccess = WGPUStorageTextureAccess_Undefined;
+	};
+
+	/*============================================================
+	* SHADER REFLECTION
+	=============================================================*/
+	/**
+	 * @class ShaderReflection
+	 * @brief Parses the declarations of a WGSL module to derive its bind group layouts
+	 * and uniform struct layouts.
+	 *
+	 * Only module-scope declarations are parsed: structs, aliases, @group/@binding variables
+	 * and functions. Function bodies are scanned for identifiers so each binding's visibility
+	 * covers exactly the stages that use it, and for texture builtin calls so a `sampler`
+	 * used with a depth or unfilterable texture gets a non-filtering layout entry. Array
+	 * sizes may be literals or module-scope `const` integers. Reflect() parses a module once
+	 * and keeps the last CacheCapacity modules by the hash of their source, so pipelines can
+	 * call it from their constructors and shader edits do not pile up.
+	 *
+	 * @code
+	 * auto reflection = WGPU::Shader::ShaderReflection::Reflect(shaderSource);
+	 * reflection->ValidateBindingSize(0, 0, ub->GetCurrentBufferSize());
+	 * bindGroupLayout_ = reflection->CreateBindGroupLayout(0);
+	 * @endcode
+	 */
+	class ShaderReflection {
+	public:
+		static constexpr size_t CacheCapacity = 64;
+
+		/**
+		 * @brief Parses a WGSL module.
+		 *
+		 * @throws std::runtime_error If a declaration cannot be parsed or a type has no layout.
+		 */
+		explicit ShaderReflection(std::string_view source);
+
+		/*============================================================
+		* PUBLIC
+		=============================================================*/
+
+		/**
+		 * @brief Returns the cached reflection of source, parsing it on first use.
+		 *
+		 * Safe to call from any thread. The least recently used module is dropped from the
+		 * cache past CacheCapacity; the returned pointer keeps its reflection alive.
+		 */
+		static std::shared_ptr<const ShaderReflection> Reflect(std::string_view source);
+
+		size_t GetHash() const { return hash_; }
+		const std::vector<ReflectedStruct>& GetStructs() const { return structs_; }
+		const std::vector<ReflectedBinding>& GetBindings() const { return bindings_; }
+
+		const ReflectedStruct* FindStruct(std::string_view name) const;
+		const ReflectedBinding* FindBinding(uint32_t group, uint32_t binding) const;
+
+		/**
+		 * @brief The struct behind a var<uniform> binding.
+		 *
+		 * @throws std::invalid_argument If the binding does not exist or is not a uniform struct.
+		 */
+		const ReflectedStruct& GetUniformStruct(uint32_t group, uint32_t binding) const;
+
+		/**
+		 * @brief Number of bind groups, i.e. the highest @group index plus one.
+		 */
+		uint32_t GetGroupCount() const;
+
+		/**
+		 * @brief Builds the layout entries of one bind group, sorted by binding.
+		 *
+		 * @param group The @group index.
+		 * @param dynamicOffsetBindings Buffer bindings that take a dynamic offset; WGSL has no
+		 * way to express this, so the caller decides.
+		 */
+		std::vector<WGPUBindGroupLayoutEntry> CreateLayoutEntries(uint32_t group, std::initializer_list<uint32_t> dynamicOffsetBindings = {}) const;
+
+		/**
+		 * @brief Creates the bind group layout of one group from CreateLayoutEntries().
+		 *
+		 * @throws std::runtime_error If the layout creation fails.
+		 */
+		WGPUBindGroupLayout CreateBindGroupLayout(uint32_t group, std::initializer_list<uint32_t> dynamicOffsetBindings = {}) const;
+
+		/**
+		 * @brief Checks that a buffer bound at group/binding is large enough for the shader.
+		 *
+		 * @throws std::invalid_argument If the binding is missing, is not a buffer, or size is
+		 * smaller than its minimum binding size.
+		 */
+		void ValidateBindingSize(uint32_t group, uint32_t binding, size_t size) const;
+
+		/**
+		 * @brief Checks that every uniform struct binding keeps the member layout it has in
+		 * previous: same names, types and offsets. Host buffers laid out from the previous
+		 * module stay valid only then, even when the struct size is unchanged.
+		 *
+		 * @throws std::invalid_argument On the first binding whose layout changed.
+		 */
+		void ValidateUniformLayouts(const ShaderReflection& previous) const;
+
+		/**
+		 * @brief Checks that a UniformBlock struct matches the uniform struct at group/binding
+		 * member by member: same count, same types, same offsets.
+		 *
+		 * @throws std::invalid_argument On the first mismatch.
+		 */
+		template <typename T>
+		void Validate(uint32_t group, uint32_t binding) const {
+			using Layout = Buffer::UniformLayoutOf<T>;
+			const ReflectedStruct& reflected = GetUniformStruct(group, binding);
+			if (reflected.members.size() != Layout::Count || reflected.size != Layout::Size) {
+				throw std::invalid_argument("Uniform struct '" + reflected.name + "' does not match the host struct layout.");
+			}
+			for (size_t i = 0; i < Layout::Count; ++i) {
+				const ReflectedMember& member = reflected.members[i];
+				if (member.kind != Layout::Kinds[i] || member.offset != Layout::Offsets[i]) {
+					throw std::invalid_argument("Uniform member '" + reflected.name + "." + member.name + "' does not match the host struct.");
+				}
+			}
+		}
+	private:
+		size_t hash_ = 0;
+		std::string source_;
+		std::vector<ReflectedStruct> structs_;
+		std::vector<ReflectedBinding> bindings_;
+	};
+}
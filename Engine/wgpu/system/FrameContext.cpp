@@ -0,0 +1,159 @@
+#include "FrameContext.h"
+
+#include <algorithm>
+#include <chrono>
+#include <thread>
+#include <utility>
+
+namespace {
+	struct SubmittedFrame {
+		std::weak_ptr<void> state;
+		uint32_t slot;
+		uint64_t serial;
+	};
+}
+
+WGPU::System::FrameContext::FrameContext(uint32_t framesInFlight, size_t uniformBindingSize, size_t uniformSlicesPerFrame) :
+	state_(std::make_shared<State>())
+{
+	if (framesInFlight == 0) {
+		throw std::invalid_argument("FrameContext: at least one frame has to be in flight.");
+	}
+	for (uint32_t i = 0; i < framesInFlight; ++i) {
+		slots_.push_back(std::make_unique<Slot>());
+	}
+	state_->completedSerials.assign(framesInFlight, 0);
+
+	// The ring's regions rotate with the slots, so a region is only rewritten once its fence passed
+	if (uniformBindingSize > 0) {
+		uniforms_ = std::make_unique<Buffer::UniformRing>(uniformBindingSize, uniformSlicesPerFrame, framesInFlight);
+	}
+	slot_ = framesInFlight - 1; // The first BeginFrame() lands on slot 0
+}
+
+WGPU::System::FrameContext::~FrameContext()
+{
+	std::cout << "WGPU::System::FrameContext - Waiting for " << slots_.size() << " frames in flight..." << std::endl;
+	for (uint32_t i = 0; i < slots_.size(); ++i) {
+		wait(i);
+		runReleases(*slots_[i]);
+	}
+}
+
+void WGPU::System::FrameContext::BeginFrame()
+{
+	if (inFrame_) {
+		EndFrame();
+	}
+
+	slot_ = (slot_ + 1) % static_cast<uint32_t>(slots_.size());
+	wgpuDeviceTick(Core::Device()); // Delivers every callback due, not only ours
+
+	const auto start = std::chrono::steady_clock::now();
+	wait(slot_);
+	lastWaitMilliseconds_ = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+	runReleases(*slots_[slot_]);
+	if (uniforms_) {
+		uniforms_->BeginFrame();
+	}
+	++frameNumber_;
+	inFrame_ = true;
+}
+
+void WGPU::System::FrameContext::Flush()
+{
+	slots_[slot_]->uploads.Submit();
+	if (uniforms_) {
+		uniforms_->Flush();
+	}
+}
+
+void WGPU::System::FrameContext::EndFrame()
+{
+	Flush();
+
+	Slot& slot = *slots_[slot_];
+	slot.fencedSerial = nextSerial_++;
+	auto* submitted = new SubmittedFrame{ state_, slot_, slot.fencedSerial };
+	wgpuQueueOnSubmittedWorkDone(Core::Queue(), &FrameContext::onSubmittedWorkDone, submitted);
+
+	lastUniformUploads_ = Buffer::UniformUploads::EndFrame();
+	inFrame_ = false;
+}
+
+void WGPU::System::FrameContext::Defer(std::function<void()> release)
+{
+	slots_[slot_]->releases.push_back(std::move(release));
+}
+
+void WGPU::System::FrameContext::DeferRelease(WGPUBuffer buffer)
+{
+	Defer([buffer] { wgpuBufferRelease(buffer); });
+}
+
+void WGPU::System::FrameContext::DeferRelease(WGPUTexture texture)
+{
+	Defer([texture] { wgpuTextureRelease(texture); });
+}
+
+void WGPU::System::FrameContext::DeferRelease(WGPUTextureView view)
+{
+	Defer([view] { wgpuTextureViewRelease(view); });
+}
+
+void WGPU::System::FrameContext::DeferRelease(WGPUBindGroup bindGroup)
+{
+	Defer([bindGroup] { wgpuBindGroupRelease(bindGroup); });
+}
+
+WGPU::Buffer::UniformRing& WGPU::System::FrameContext::Uniforms()
+{
+	if (!uniforms_) {
+		throw std::logic_error("FrameContext: created without a uniform ring.");
+	}
+	return *uniforms_;
+}
+
+bool WGPU::System::FrameContext::isPending(uint32_t slot) const
+{
+	return state_->completedSerials[slot] < slots_[slot]->fencedSerial;
+}
+
+/**
+ * Ticks the device until the slot's fence has passed. This is the only place the CPU
+ * blocks on the GPU, and only when it is framesInFlight frames ahead.
+ */
+void WGPU::System::FrameContext::wait(uint32_t slot)
+{
+	while (isPending(slot)) {
+		wgpuDeviceTick(Core::Device());
+		if (isPending(slot)) {
+			std::this_thread::yield();
+		}
+	}
+}
+
+void WGPU::System::FrameContext::runReleases(Slot& slot)
+{
+	for (auto& release : slot.releases) {
+		release();
+	}
+	slot.releases.clear();
+}
+
+void WGPU::System::FrameContext::onSubmittedWorkDone(WGPUQueueWorkDoneStatus status, void* userData)
+{
+	std::unique_ptr<SubmittedFrame> submitted(static_cast<SubmittedFrame*>(userData));
+	auto state = std::static_pointer_cast<State>(submitted->state.lock());
+	if (!state) {
+		return;
+	}
+
+	// An error (device lost) still ends the wait; nothing will run on the GPU any more
+	if (status != WGPUQueueWorkDoneStatus_Success) {
+		std::cerr << "WGPU::System::FrameContext - Submitted work did not complete (status " << status << ")." << std::endl;
+	}
+	uint64_t& completed = state->completedSerials[submitted->slot];
+	completed = std::max(completed, submitted->serial);
+}
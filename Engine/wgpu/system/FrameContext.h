@@ -0,0 +1,143 @@
+#pragma once
+
+#include <webgpu/webgpu.h>
+#include <core/Core.h>
+#include <cstdint>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+
+#include <wgpu/buffer/StagingBelt.h>
+#include <wgpu/buffer/UniformRing.h>
+#include <wgpu/buffer/UploadStats.h>
+
+namespace WGPU::System {
+
+	/**
+	 * @class FrameContext
+	 * @brief Ring of framesInFlight frame slots, each fenced with wgpuQueueOnSubmittedWorkDone.
+	 *
+	 * Every slot owns what one frame writes or retires: a StagingBelt for its uploads, a
+	 * region of the optional UniformRing, and a queue of releases deferred until the GPU is
+	 * done with the frame. EndFrame() submits the uploads and fences the slot after
+	 * everything submitted so far. BeginFrame() moves to the next slot and, if the GPU is
+	 * still on the frame that last used it, waits for that fence, so the CPU records frame
+	 * N+1 while the GPU consumes frame N but never runs more than framesInFlight ahead.
+	 * Once the fence has passed, the slot's deferred releases run and its resources are
+	 * free to be rewritten.
+	 *
+	 * BeginFrame() is also where wgpuDeviceTick is called, which delivers this and every
+	 * other asynchronous callback (staging belt recycling, pipeline compiles) once per frame.
+	 *
+	 * @code
+	 * WGPU::System::FrameContext frames(2, sizeof(DrawUniforms), 256);
+	 * while (running) {
+	 *     frames.BeginFrame();
+	 *     uint32_t offset = frames.Uniforms().Push(drawUniforms);
+	 *     frames.Uploads().WriteBuffer(vertexBuffer, 0, vertices.data(), vertices.size() * sizeof(Vertex));
+	 *     frames.DeferRelease(oldBindGroup); // released once the GPU is done with this frame
+	 *     frames.Flush(); // uploads and uniforms go out before the draws
+	 *     ... // encode, submit, present
+	 *     frames.EndFrame();
+	 * }
+	 * @endcode
+	 */
+	class FrameContext {
+	public:
+		/**
+		 * @param framesInFlight Number of frame slots; 2 or 3.
+		 * @param uniformBindingSize Size of one UniformRing slice; 0 for no ring.
+		 * @param uniformSlicesPerFrame Uniform slices available to each frame.
+		 */
+		explicit FrameContext(uint32_t framesInFlight = 2, size_t uniformBindingSize = 0, size_t uniformSlicesPerFrame = 0);
+		~FrameContext();
+
+		FrameContext(const FrameContext&) = delete;
+		FrameContext& operator=(const FrameContext&) = delete;
+
+		/*============================================================
+		* PUBLIC
+		=============================================================*/
+
+		/**
+		 * @brief Moves to the next slot, waiting for the GPU to finish the frame that last
+		 * used it, then runs that frame's deferred releases.
+		 */
+		void BeginFrame();
+
+		/**
+		 * @brief Submits the frame's uploads and flushes its uniform slices. Call before
+		 * submitting the draws that read them; EndFrame() calls it too.
+		 */
+		void Flush();
+
+		/**
+		 * @brief Flushes and fences the slot after everything submitted this frame.
+		 */
+		void EndFrame();
+
+		/**
+		 * @brief Runs release once the GPU has finished the current frame.
+		 */
+		void Defer(std::function<void()> release);
+
+		void DeferRelease(WGPUBuffer buffer);
+		void DeferRelease(WGPUTexture texture);
+		void DeferRelease(WGPUTextureView view);
+		void DeferRelease(WGPUBindGroup bindGroup);
+
+		/**
+		 * @brief The current frame's upload belt.
+		 */
+		Buffer::StagingBelt& Uploads() { return slots_[slot_]->uploads; }
+
+		/**
+		 * @throws std::logic_error If the context was created without a uniform ring.
+		 */
+		Buffer::UniformRing& Uniforms();
+
+		uint32_t GetFramesInFlight() const { return static_cast<uint32_t>(slots_.size()); }
+		uint32_t GetSlot() const { return slot_; }
+		uint64_t GetFrameNumber() const { return frameNumber_; }
+
+		/**
+		 * @brief How long the last BeginFrame() waited on the GPU, in milliseconds. Steadily
+		 * above zero means the GPU is the bottleneck.
+		 */
+		double GetLastWaitMilliseconds() const { return lastWaitMilliseconds_; }
+
+		/**
+		 * @brief Uniform bytes and queue writes of the last ended frame.
+		 */
+		const Buffer::UploadStats& GetLastUniformUploads() const { return lastUniformUploads_; }
+	private:
+		struct Slot {
+			Buffer::StagingBelt uploads;
+			std::vector<std::function<void()>> releases;
+			uint64_t fencedSerial = 0;  // Serial of the last fence put on the slot
+		};
+
+		// Shared with the GPU callbacks so they can tell whether the ring is still alive
+		struct State {
+			std::vector<uint64_t> completedSerials; // One per slot
+		};
+
+		std::vector<std::unique_ptr<Slot>> slots_;
+		std::shared_ptr<State> state_;
+		std::unique_ptr<Buffer::UniformRing> uniforms_;
+		uint32_t slot_ = 0;
+		uint64_t frameNumber_ = 0;
+		uint64_t nextSerial_ = 1;
+		bool inFrame_ = false;
+		double lastWaitMilliseconds_ = 0.0;
+		Buffer::UploadStats lastUniformUploads_;
+
+		bool isPending(uint32_t slot) const;
+		void wait(uint32_t slot);
+		void runReleases(Slot& slot);
+
+		static void onSubmittedWorkDone(WGPUQueueWorkDoneStatus status, void* userData);
+	};
+}
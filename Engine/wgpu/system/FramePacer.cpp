@@ -0,0 +1,132 @@
+#include "FramePacer.h"
+
+#include <algorithm>
+#include <cmath>
+#include <thread>
+
+namespace {
+	double milliseconds(WGPU::System::FramePacer::Clock::duration duration)
+	{
+		return std::chrono::duration<double, std::milli>(duration).count();
+	}
+}
+
+WGPU::System::FramePacer::FramePacer(double targetFrameRate)
+{
+	SetTargetFrameRate(targetFrameRate);
+}
+
+void WGPU::System::FramePacer::SetTargetFrameRate(double framesPerSecond)
+{
+	targetFrameRate_ = framesPerSecond > 0.0 ? framesPerSecond : 0.0;
+	period_ = targetFrameRate_ > 0.0
+		? std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(1.0 / targetFrameRate_))
+		: Clock::duration::zero();
+	deadline_ = Clock::time_point{}; // Restart the schedule from the next frame
+}
+
+void WGPU::System::FramePacer::BeginFrame()
+{
+	if (period_ > Clock::duration::zero()) {
+		const Clock::time_point now = Clock::now();
+		if (deadline_ == Clock::time_point{} || now - deadline_ > period_) {
+			deadline_ = now; // First frame, or a whole slot late: move the schedule, no catch-up
+		}
+		else {
+			waitUntil(deadline_);
+		}
+		deadline_ += period_;
+	}
+	frameStart_ = Clock::now();
+	hasInput_ = false;
+}
+
+void WGPU::System::FramePacer::MarkInput()
+{
+	input_ = Clock::now();
+	hasInput_ = true;
+}
+
+void WGPU::System::FramePacer::MarkPresent()
+{
+	const Clock::time_point now = Clock::now();
+
+	Sample& sample = samples_[nextSample_];
+	sample.frameTime = frameStart_ != Clock::time_point{} ? milliseconds(now - frameStart_) : 0.0;
+	sample.presentInterval = lastPresent_ != Clock::time_point{} ? milliseconds(now - lastPresent_) : 0.0;
+	sample.inputToPresent = hasInput_ ? milliseconds(now - input_) : 0.0;
+	nextSample_ = (nextSample_ + 1) % Window;
+	sampleCount_ = std::min(sampleCount_ + 1, Window);
+
+	lastPresent_ = now;
+	++stats_.frames;
+	updateStats();
+}
+
+/**
+ * Sleeps in 1ms steps while the remaining time is more than a pessimistic estimate of one
+ * such sleep (mean plus one standard deviation of the ones measured so far), then spins.
+ */
+void WGPU::System::FramePacer::waitUntil(Clock::time_point deadline)
+{
+	using Seconds = std::chrono::duration<double>;
+
+	for (;;) {
+		const double remaining = Seconds(deadline - Clock::now()).count();
+		const double estimate = sleepMean_ + std::sqrt(sleepM2_ / static_cast<double>(sleepSamples_));
+		if (remaining <= estimate) {
+			break;
+		}
+
+		const Clock::time_point before = Clock::now();
+		std::this_thread::sleep_for(std::chrono::milliseconds(1));
+		const double slept = Seconds(Clock::now() - before).count();
+
+		++sleepSamples_;
+		const double delta = slept - sleepMean_;
+		sleepMean_ += delta / static_cast<double>(sleepSamples_);
+		sleepM2_ += delta * (slept - sleepMean_);
+	}
+
+	while (Clock::now() < deadline) {
+		std::this_thread::yield();
+	}
+}
+
+void WGPU::System::FramePacer::updateStats()
+{
+	double frameTime = 0.0;
+	double interval = 0.0;
+	double intervalSquares = 0.0;
+	double intervalMax = 0.0;
+	size_t intervals = 0;
+	double latency = 0.0;
+	double latencyMax = 0.0;
+	size_t latencies = 0;
+
+	for (size_t i = 0; i < sampleCount_; ++i) {
+		const Sample& sample = samples_[i];
+		frameTime += sample.frameTime;
+		if (sample.presentInterval > 0.0) {
+			interval += sample.presentInterval;
+			intervalSquares += sample.presentInterval * sample.presentInterval;
+			intervalMax = std::max(intervalMax, sample.presentInterval);
+			++intervals;
+		}
+		if (sample.inputToPresent > 0.0) {
+			latency += sample.inputToPresent;
+			latencyMax = std::max(latencyMax, sample.inputToPresent);
+			++latencies;
+		}
+	}
+
+	stats_.frameTime = sampleCount_ > 0 ? frameTime / static_cast<double>(sampleCount_) : 0.0;
+	stats_.presentInterval = intervals > 0 ? interval / static_cast<double>(intervals) : 0.0;
+	stats_.presentIntervalMax = intervalMax;
+	stats_.presentJitter = intervals > 0
+		? std::sqrt(std::max(0.0, intervalSquares / static_cast<double>(intervals) - stats_.presentInterval * stats_.presentInterval))
+		: 0.0;
+	stats_.inputToPresent = latencies > 0 ? latency / static_cast<double>(latencies) : 0.0;
+	stats_.inputToPresentMax = latencyMax;
+	stats_.framesPerSecond = stats_.presentInterval > 0.0 ? 1000.0 / stats_.presentInterval : 0.0;
+}
@@ -0,0 +1,109 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+
+namespace WGPU::System {
+	/**
+	 * Frame timings over the last FramePacer::Window frames, in milliseconds.
+	 */
+	struct FrameTimingStats {
+		double frameTime = 0.0;           // Frame start (after the limiter) to present: the CPU cost of a frame
+		double presentInterval = 0.0;     // Present to present
+		double presentIntervalMax = 0.0;
+		double presentJitter = 0.0;       // Standard deviation of the present interval
+		double inputToPresent = 0.0;      // Input poll to present
+		double inputToPresentMax = 0.0;
+		double framesPerSecond = 0.0;
+		uint64_t frames = 0;              // Presented since the pacer was created
+	};
+
+	/**
+	 * @class FramePacer
+	 * @brief Caps the frame rate and measures frame time and latency.
+	 *
+	 * BeginFrame() holds the frame until its slot at the target rate comes up. It sleeps for
+	 * the bulk of the wait and spins for the rest, since OS sleeps overshoot by up to a
+	 * scheduler tick. How long to sleep is learnt from how long past sleeps took, so the spin
+	 * stays short where sleeps are precise and grows where they are not. A frame that misses
+	 * its slot moves the schedule instead of being made up with a burst of short frames.
+	 *
+	 * Latency is measured on the CPU: MarkInput() right after polling events and MarkPresent()
+	 * right after wgpuSurfacePresent, so input-to-present does not include the time the
+	 * image then waits in the swap chain; lower it with Mailbox or Immediate presentation.
+	 *
+	 * Polling input after BeginFrame() rather than before keeps the limiter's wait out of
+	 * the input latency.
+	 *
+	 * @code
+	 * pacer.SetTargetFrameRate(60.0); // 0 for uncapped
+	 * while (running) {
+	 *     pacer.BeginFrame();
+	 *     glfwPollEvents();
+	 *     pacer.MarkInput();
+	 *     ... // render, present, pacer.MarkPresent()
+	 * }
+	 * @endcode
+	 */
+	class FramePacer {
+	public:
+		using Clock = std::chrono::steady_clock;
+		static constexpr size_t Window = 120;
+
+		/**
+		 * @param targetFrameRate Frames per second to cap at; 0 or less for uncapped.
+		 */
+		explicit FramePacer(double targetFrameRate = 0.0);
+
+		/*============================================================
+		* PUBLIC
+		=============================================================*/
+
+		void SetTargetFrameRate(double framesPerSecond);
+		double GetTargetFrameRate() const noexcept { return targetFrameRate_; }
+
+		/**
+		 * @brief Waits for this frame's slot. Returns at once when uncapped.
+		 */
+		void BeginFrame();
+
+		/**
+		 * @brief Records that input for this frame has just been sampled.
+		 */
+		void MarkInput();
+
+		/**
+		 * @brief Records that this frame has just been presented.
+		 */
+		void MarkPresent();
+
+		const FrameTimingStats& GetStats() const noexcept { return stats_; }
+	private:
+		double targetFrameRate_ = 0.0;
+		Clock::duration period_{};
+		Clock::time_point deadline_{};
+		Clock::time_point frameStart_{};
+		Clock::time_point input_{};
+		Clock::time_point lastPresent_{};
+		bool hasInput_ = false;
+
+		// Running mean and variance of one sleep_for(1ms), Welford style
+		double sleepMean_ = 0.0015;
+		double sleepM2_ = 0.0;
+		uint64_t sleepSamples_ = 1;
+
+		struct Sample {
+			double frameTime = 0.0;
+			double presentInterval = 0.0;
+			double inputToPresent = 0.0;
+		};
+		std::array<Sample, Window> samples_{};
+		size_t sampleCount_ = 0;
+		size_t nextSample_ = 0;
+		FrameTimingStats stats_;
+
+		void waitUntil(Clock::time_point deadline);
+		void updateStats();
+	};
+}
@@ -1,20 +1,40 @@
 #include "SurfaceHandler.h"
 
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
 WGPU::System::SurfaceHandler::SurfaceHandler(
-	int screenWidth,
-	int screenHeight,
+	int nativeWidth,
+	int nativeHeight,
 	GLFWwindow* window,
 	WGPUInstance instance,
 	WGPUAdapter adapter,
 	WGPUDevice device
-) : screenWidth_(screenWidth), screenHeight_(screenHeight)
+) : screenWidth_(nativeWidth), screenHeight_(nativeHeight), window_(window), adapter_(adapter), device_(device)
 {
 	surface_ = glfwGetWGPUSurface(instance, window);
-	configure(screenWidth, screenHeight, adapter, device);
+
+	// The surface matches the window, not the native resolution
+	int framebufferWidth = 0;
+	int framebufferHeight = 0;
+	glfwGetFramebufferSize(window_, &framebufferWidth, &framebufferHeight);
+	configure(std::max(framebufferWidth, 1), std::max(framebufferHeight, 1), adapter, device);
+
+	createSceneTarget();
+	presentPipeline_ = std::make_unique<Pipeline::PresentPipeline>(sceneView_, surfaceFormat_);
 }
 
 WGPU::System::SurfaceHandler::~SurfaceHandler()
 {
+    presentPipeline_.reset();
+    if (sceneView_) {
+        wgpuTextureViewRelease(sceneView_);
+    }
+    if (sceneTexture_) {
+        wgpuTextureDestroy(sceneTexture_);
+        wgpuTextureRelease(sceneTexture_);
+    }
     if (surfaceTexture_.texture) {
         wgpuTextureRelease(surfaceTexture_.texture);
     }
@@ -72,6 +92,124 @@ void WGPU::System::SurfaceHandler::ReleaseTextureAndView() {
     }
 }
 
+bool WGPU::System::SurfaceHandler::EncodePresent(WGPUCommandEncoder encoder)
+{
+    if (!refreshSize()) {
+        return false;
+    }
+
+    WGPUTextureView targetView = CreateTextureAndGetSurfaceTextureView();
+    if (!targetView) {
+        // Reconfigure and try once more if the surface no longer matches the window
+        WGPUSurfaceGetCurrentTextureStatus status = surfaceTexture_.status;
+        if (status != WGPUSurfaceGetCurrentTextureStatus_Outdated && status != WGPUSurfaceGetCurrentTextureStatus_Lost) {
+            return false;
+        }
+        configure(surfaceWidth_, surfaceHeight_, adapter_, device_);
+        targetView = CreateTextureAndGetSurfaceTextureView();
+        if (!targetView) {
+            return false;
+        }
+    }
+
+    // Clear to black so whatever the scene does not cover becomes the letterbox
+    WGPURenderPassColorAttachment colorAttachment = {};
+    colorAttachment.view = targetView;
+    colorAttachment.resolveTarget = nullptr;
+    colorAttachment.loadOp = WGPULoadOp_Clear;
+    colorAttachment.storeOp = WGPUStoreOp_Store;
+    colorAttachment.clearValue = WGPUColor{ 0.0, 0.0, 0.0, 1.0 };
+    colorAttachment.depthSlice = WGPU_DEPTH_SLICE_UNDEFINED;
+
+    WGPURenderPassDescriptor renderPassDesc = {};
+    renderPassDesc.nextInChain = nullptr;
+    renderPassDesc.label = "Present pass";
+    renderPassDesc.colorAttachmentCount = 1;
+    renderPassDesc.colorAttachments = &colorAttachment;
+    renderPassDesc.depthStencilAttachment = nullptr;
+    renderPassDesc.timestampWrites = nullptr;
+
+    WGPURenderPassEncoder renderPass = wgpuCommandEncoderBeginRenderPass(encoder, &renderPassDesc);
+    wgpuRenderPassEncoderSetViewport(renderPass, viewport_.x, viewport_.y, viewport_.width, viewport_.height, 0.0f, 1.0f);
+    wgpuRenderPassEncoderSetPipeline(renderPass, presentPipeline_->GetPipeline());
+    wgpuRenderPassEncoderSetBindGroup(renderPass, 0, presentPipeline_->GetBindGroup(), 0, nullptr);
+    wgpuRenderPassEncoderDraw(renderPass, 3, 1, 0, 0);
+    wgpuRenderPassEncoderEnd(renderPass);
+    wgpuRenderPassEncoderRelease(renderPass);
+    return true;
+}
+
+void WGPU::System::SurfaceHandler::SetPresentMode(WGPUPresentMode requested)
+{
+    requestedPresentMode_ = requested;
+    if (ChoosePresentMode(requested, supportedPresentModes_) != presentMode_) {
+        ReleaseTextureAndView();
+        configure(surfaceWidth_, surfaceHeight_, adapter_, device_);
+    }
+    if (presentMode_ != requested) {
+        std::cout << "WGPU::System::SurfaceHandler - " << PresentModeName(requested) << " is not supported, presenting with "
+            << PresentModeName(presentMode_) << "." << std::endl;
+    }
+}
+
+WGPUPresentMode WGPU::System::SurfaceHandler::ChoosePresentMode(WGPUPresentMode requested, std::span<const WGPUPresentMode> supported)
+{
+    auto isSupported = [supported](WGPUPresentMode mode) {
+        return std::find(supported.begin(), supported.end(), mode) != supported.end();
+    };
+
+    // Closest in behaviour first: Immediate and Mailbox both never block on vblank
+    WGPUPresentMode candidates[3] = { requested, WGPUPresentMode_Fifo, WGPUPresentMode_Fifo };
+    if (requested == WGPUPresentMode_Immediate) {
+        candidates[1] = WGPUPresentMode_Mailbox;
+    }
+    for (WGPUPresentMode candidate : candidates) {
+        if (isSupported(candidate)) {
+            return candidate;
+        }
+    }
+    return WGPUPresentMode_Fifo; // Required of every surface
+}
+
+const char* WGPU::System::SurfaceHandler::PresentModeName(WGPUPresentMode mode)
+{
+    switch (mode) {
+    case WGPUPresentMode_Fifo: return "Fifo";
+    case WGPUPresentMode_FifoRelaxed: return "FifoRelaxed";
+    case WGPUPresentMode_Immediate: return "Immediate";
+    case WGPUPresentMode_Mailbox: return "Mailbox";
+    default: return "Unknown";
+    }
+}
+
+WGPU::System::PresentViewport WGPU::System::SurfaceHandler::ComputeViewport(int nativeWidth, int nativeHeight, int surfaceWidth, int surfaceHeight)
+{
+    PresentViewport viewport;
+    if (nativeWidth <= 0 || nativeHeight <= 0 || surfaceWidth <= 0 || surfaceHeight <= 0) {
+        return viewport;
+    }
+
+    // Largest whole factor that fits both ways; below 1x fall back to the exact fit
+    int wholeScale = std::min(surfaceWidth / nativeWidth, surfaceHeight / nativeHeight);
+    if (wholeScale >= 1) {
+        viewport.scale = static_cast<float>(wholeScale);
+    }
+    else {
+        viewport.scale = std::min(
+            static_cast<float>(surfaceWidth) / static_cast<float>(nativeWidth),
+            static_cast<float>(surfaceHeight) / static_cast<float>(nativeHeight)
+        );
+    }
+
+    viewport.width = std::min(static_cast<float>(nativeWidth) * viewport.scale, static_cast<float>(surfaceWidth));
+    viewport.height = std::min(static_cast<float>(nativeHeight) * viewport.scale, static_cast<float>(surfaceHeight));
+
+    // Centre on whole surface pixels so native pixel edges stay on pixel edges
+    viewport.x = std::floor((static_cast<float>(surfaceWidth) - viewport.width) * 0.5f);
+    viewport.y = std::floor((static_cast<float>(surfaceHeight) - viewport.height) * 0.5f);
+    return viewport;
+}
+
 int WGPU::System::SurfaceHandler::GetWidth()
 {
     return screenWidth_;
@@ -85,27 +223,92 @@ int WGPU::System::SurfaceHandler::GetHeight()
 void WGPU::System::SurfaceHandler::configure(int screenWidth, int screenHeight, WGPUAdapter adapter, WGPUDevice device)
 {
     // Retrieve surface capabilities
-    WGPUSurfaceCapabilities capabilities;
+    WGPUSurfaceCapabilities capabilities = {};
     wgpuSurfaceGetCapabilities(surface_, adapter, &capabilities);
 
-    // Use the first format as the preferred format
-    surfaceFormat_ = capabilities.formats[0];
+    supportedPresentModes_.assign(capabilities.presentModes, capabilities.presentModes + capabilities.presentModeCount);
+    const WGPUPresentMode presentMode = ChoosePresentMode(requestedPresentMode_, supportedPresentModes_);
+    if (presentMode != presentMode_) {
+        std::cout << "WGPU::System::SurfaceHandler - Present mode " << PresentModeName(presentMode) << std::endl;
+    }
+    presentMode_ = presentMode;
 
     WGPUSurfaceConfiguration config = {};
     config.nextInChain = nullptr;
-    config.width = screenWidth;
-    config.height = screenHeight;
+    config.width = static_cast<uint32_t>(screenWidth);
+    config.height = static_cast<uint32_t>(screenHeight);
     config.usage = WGPUTextureUsage_RenderAttachment;
     if (capabilities.formatCount == 0) {
+        wgpuSurfaceCapabilitiesFreeMembers(capabilities);
         throw std::runtime_error("No supported surface formats found.");
     }
+    // Use the first format as the preferred format
     surfaceFormat_ = capabilities.formats[0];
     config.format = surfaceFormat_;
     config.viewFormatCount = 0;
     config.viewFormats = nullptr;
     config.device = device;
-    config.presentMode = WGPUPresentMode_Fifo;
+    config.presentMode = presentMode_;
     config.alphaMode = WGPUCompositeAlphaMode_Auto;
 
     wgpuSurfaceConfigure(surface_, &config);
+    wgpuSurfaceCapabilitiesFreeMembers(capabilities);
+
+    surfaceWidth_ = screenWidth;
+    surfaceHeight_ = screenHeight;
+    viewport_ = ComputeViewport(screenWidth_, screenHeight_, surfaceWidth_, surfaceHeight_);
+}
+
+/**
+ * Creates the native-resolution texture the scene is rendered into and sampled from.
+ */
+void WGPU::System::SurfaceHandler::createSceneTarget()
+{
+    WGPUTextureDescriptor textureDesc = {};
+    textureDesc.nextInChain = nullptr;
+    textureDesc.label = "Scene texture";
+    textureDesc.dimension = WGPUTextureDimension_2D;
+    textureDesc.size = { static_cast<uint32_t>(screenWidth_), static_cast<uint32_t>(screenHeight_), 1 };
+    textureDesc.format = surfaceFormat_;
+    textureDesc.usage = WGPUTextureUsage_RenderAttachment | WGPUTextureUsage_TextureBinding;
+    textureDesc.mipLevelCount = 1;
+    textureDesc.sampleCount = 1;
+    textureDesc.viewFormatCount = 0;
+    textureDesc.viewFormats = nullptr;
+    sceneTexture_ = wgpuDeviceCreateTexture(device_, &textureDesc);
+    if (!sceneTexture_) {
+        throw std::runtime_error("Failed to create scene texture.");
+    }
+
+    WGPUTextureViewDescriptor viewDescriptor = {};
+    viewDescriptor.nextInChain = nullptr;
+    viewDescriptor.label = "Scene texture view";
+    viewDescriptor.format = surfaceFormat_;
+    viewDescriptor.dimension = WGPUTextureViewDimension_2D;
+    viewDescriptor.baseMipLevel = 0;
+    viewDescriptor.mipLevelCount = 1;
+    viewDescriptor.baseArrayLayer = 0;
+    viewDescriptor.arrayLayerCount = 1;
+    viewDescriptor.aspect = WGPUTextureAspect_All;
+    sceneView_ = wgpuTextureCreateView(sceneTexture_, &viewDescriptor);
+}
+
+/**
+ * Reconfigures the surface when the window's framebuffer changed size.
+ *
+ * @return false while the framebuffer is empty (minimized window).
+ */
+bool WGPU::System::SurfaceHandler::refreshSize()
+{
+    int framebufferWidth = 0;
+    int framebufferHeight = 0;
+    glfwGetFramebufferSize(window_, &framebufferWidth, &framebufferHeight);
+    if (framebufferWidth <= 0 || framebufferHeight <= 0) {
+        return false;
+    }
+    if (framebufferWidth != surfaceWidth_ || framebufferHeight != surfaceHeight_) {
+        ReleaseTextureAndView();
+        configure(framebufferWidth, framebufferHeight, adapter_, device_);
+    }
+    return true;
 }
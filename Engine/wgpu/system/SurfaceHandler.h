@@ -2,14 +2,50 @@
 
 #include <webgpu/webgpu.h>
 #include <glfw3webgpu.h>
+#include <GLFW/glfw3.h>
 #include <iostream>
+#include <memory>
+#include <span>
+#include <vector>
+
+#include "wgpu/pipelines/PresentPipeline.h"
+#include "FramePacer.h"
 
 namespace WGPU::System {
+	/**
+	 * Where the native-resolution scene lands on the surface: the rect in surface pixels
+	 * and the factor each native pixel is scaled by.
+	 */
+	struct PresentViewport {
+		float x = 0.0f;
+		float y = 0.0f;
+		float width = 0.0f;
+		float height = 0.0f;
+		float scale = 1.0f;
+	};
+
+	/**
+	 * Owns the window surface and the native-resolution scene texture drawn into every frame.
+	 *
+	 * The surface follows the window's framebuffer size; the scene texture stays at the
+	 * native resolution no matter how large the window gets. EncodePresent() copies the scene
+	 * onto the surface scaled by the largest whole factor that fits, centred, with black bars
+	 * around it. Only when the window is smaller than the native resolution is the factor
+	 * fractional.
+	 *
+	 * The present mode is a request: configure() picks the closest mode the surface supports
+	 * (see ChoosePresentMode), so Fifo, which every surface has, is the final fallback.
+	 * The FramePacer it owns is told of every present (GetPacer().MarkPresent()).
+	 */
 	class SurfaceHandler {
 	public:
+		/**
+		 * @param nativeWidth Width of the scene texture, in native pixels.
+		 * @param nativeHeight Height of the scene texture, in native pixels.
+		 */
 		SurfaceHandler(
-			int screenWidth,
-			int screenHeight,
+			int nativeWidth,
+			int nativeHeight,
 			GLFWwindow* window,
 			WGPUInstance instance,
 			WGPUAdapter adapter,
@@ -22,8 +58,50 @@ namespace WGPU::System {
 		WGPUSurfaceTexture GetSurfaceTexture();
 		WGPUTextureView CreateTextureAndGetSurfaceTextureView();
 		void ReleaseTextureAndView();
+
+		/**
+		 * @brief View of the native-resolution texture the scene is rendered into.
+		 */
+		WGPUTextureView GetSceneView() const noexcept { return sceneView_; }
+
+		/**
+		 * @brief Encodes the pass that scales the scene onto the current surface texture.
+		 *
+		 * Reconfigures the surface first if the window was resized or the surface went
+		 * out of date.
+		 *
+		 * @return false if there is nothing to present to (e.g. a minimized window); the
+		 *         caller must then skip wgpuSurfacePresent.
+		 */
+		bool EncodePresent(WGPUCommandEncoder encoder);
+
+		/**
+		 * @brief Requests a present mode and reconfigures the surface with the closest
+		 * supported one.
+		 */
+		void SetPresentMode(WGPUPresentMode requested);
+		WGPUPresentMode GetPresentMode() const noexcept { return presentMode_; }
+		const std::vector<WGPUPresentMode>& GetSupportedPresentModes() const noexcept { return supportedPresentModes_; }
+
+		/**
+		 * @brief The requested mode if supported, else the closest one: Immediate falls back
+		 * to Mailbox, Mailbox and FifoRelaxed to Fifo.
+		 */
+		static WGPUPresentMode ChoosePresentMode(WGPUPresentMode requested, std::span<const WGPUPresentMode> supported);
+		static const char* PresentModeName(WGPUPresentMode mode);
+
+		FramePacer& GetPacer() noexcept { return pacer_; }
+
+		/**
+		 * @brief Letterboxed rect of a native-resolution image on a surface of the given size.
+		 */
+		static PresentViewport ComputeViewport(int nativeWidth, int nativeHeight, int surfaceWidth, int surfaceHeight);
+
+		const PresentViewport& GetViewport() const noexcept { return viewport_; }
 		int GetWidth();
 		int GetHeight();
+		int GetSurfaceWidth() const noexcept { return surfaceWidth_; }
+		int GetSurfaceHeight() const noexcept { return surfaceHeight_; }
 	private:
 		WGPUSurface surface_;
 		WGPUTextureFormat surfaceFormat_;
@@ -32,11 +110,32 @@ namespace WGPU::System {
 		int screenWidth_;
 		int screenHeight_;
 
+		// Window the surface belongs to, kept to follow its size
+		GLFWwindow* window_;
+		WGPUAdapter adapter_;
+		WGPUDevice device_;
+		int surfaceWidth_ = 0;
+		int surfaceHeight_ = 0;
+		PresentViewport viewport_;
+
+		// Presentation and pacing
+		WGPUPresentMode requestedPresentMode_ = WGPUPresentMode_Fifo;
+		WGPUPresentMode presentMode_ = WGPUPresentMode_Fifo;
+		std::vector<WGPUPresentMode> supportedPresentModes_;
+		FramePacer pacer_;
+
+		// Native-resolution scene target and the pass that presents it
+		WGPUTexture sceneTexture_ = nullptr;
+		WGPUTextureView sceneView_ = nullptr;
+		std::unique_ptr<Pipeline::PresentPipeline> presentPipeline_;
+
 		void configure(
 			int screenWidth,
 			int screenHeight,
 			WGPUAdapter adapter,
 			WGPUDevice device
 		);
+		void createSceneTarget();
+		bool refreshSize();
 	};
-}
\ No newline at end of file
+}